@@ -0,0 +1,64 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifdef BSPF_UNIX
+  #include <time.h>
+  #include <sys/time.h>
+#else
+  #include <SDL.h>
+#endif
+
+#include "Bench.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Bench::reset()
+{
+  for(int i = 0; i < NumSections; ++i)
+  {
+    ourActive[i] = false;
+    ourTime[i] = 0;
+  }
+  ourTIAWrites = 0;
+  ourTIAScanlines = ourTIARepeatedScanlines = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Bench::now()
+{
+#if defined(BSPF_UNIX) && defined(CLOCK_MONOTONIC)
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uInt64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#elif defined(BSPF_UNIX)
+  timeval tv;
+  gettimeofday(&tv, 0);
+  return (uInt64)tv.tv_sec * 1000000000 + tv.tv_usec * 1000;
+#else
+  return (uInt64)SDL_GetTicks() * 1000000;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Bench::ourEnabled = false;
+bool Bench::ourActive[NumSections] = { false };
+uInt64 Bench::ourTime[NumSections] = { 0 };
+uInt64 Bench::ourTIAWrites = 0;
+uInt64 Bench::ourTIAScanlines = 0;
+uInt64 Bench::ourTIARepeatedScanlines = 0;
+const Device* Bench::ourCartridge = 0;
@@ -0,0 +1,138 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef BENCH_HXX
+#define BENCH_HXX
+
+class Device;
+
+#include "bspf.hxx"
+
+/**
+  This class collects the statistics reported by the 'stella-bench'
+  benchmark executable.  It is only compiled in when BENCHMARK_SUPPORT
+  is defined, which is never the case for the normal Stella executable.
+
+  The emulation core marks the sections of interest with a Bench::Timer
+  object, which accumulates the wall time spent in that section while
+  collection is enabled.  Sections are timed inclusively (ie, time spent
+  in the cartridge or the TIA while executing 6502 code is also counted
+  towards the CPU), and recursive entries into a section are ignored.
+
+  @author  Stella Team
+  @version $Id$
+*/
+class Bench
+{
+  public:
+    enum Section {
+      CPU,         // M6502::execute
+      TIA,         // TIA::updateFrame
+      Sound,       // TIASound::process
+      Cart,        // Cartridge peek/poke
+      NumSections  // Not a section; also used to indicate 'don't time'
+    };
+
+    /**
+      Times one section for the lifetime of the object.
+    */
+    class Timer
+    {
+      public:
+        Timer(Section section) : mySection(NumSections)
+        {
+          if(ourEnabled && section < NumSections && !ourActive[section])
+          {
+            mySection = section;
+            ourActive[section] = true;
+            myStart = now();
+          }
+        }
+
+        ~Timer()
+        {
+          if(mySection < NumSections)
+          {
+            ourTime[mySection] += now() - myStart;
+            ourActive[mySection] = false;
+          }
+        }
+
+      private:
+        Section mySection;
+        uInt64 myStart;
+    };
+
+  public:
+    /**
+      Clear all statistics collected so far.
+    */
+    static void reset();
+
+    /**
+      Enable or disable the collection of section timings.  Counters
+      are always updated, since they're cheap to maintain.
+    */
+    static void setEnabled(bool enable) { ourEnabled = enable; }
+
+    /**
+      Set the device whose peek/poke calls are timed as the cartridge.
+    */
+    static void setCartridge(const Device* cart) { ourCartridge = cart; }
+    static const Device* cartridge() { return ourCartridge; }
+
+    /**
+      Answer the time accumulated by the given section, in nanoseconds.
+    */
+    static uInt64 time(Section section) { return ourTime[section]; }
+
+    /**
+      Count one write to a TIA register.
+    */
+    static void tiaWrite() { ++ourTIAWrites; }
+    static uInt64 tiaWrites() { return ourTIAWrites; }
+
+    /**
+      Count one full scanline drawn by the TIA, and whether it was copied
+      from the one above it.
+    */
+    static void tiaScanline(bool repeated)
+    {
+      ++ourTIAScanlines;
+      if(repeated)  ++ourTIARepeatedScanlines;
+    }
+    static uInt64 tiaScanlines() { return ourTIAScanlines; }
+    static uInt64 tiaRepeatedScanlines() { return ourTIARepeatedScanlines; }
+
+    /**
+      Answer a monotonic timestamp, in nanoseconds.
+    */
+    static uInt64 now();
+
+  private:
+    static bool ourEnabled;
+    static bool ourActive[NumSections];
+    static uInt64 ourTime[NumSections];
+    static uInt64 ourTIAWrites;
+    static uInt64 ourTIAScanlines;
+    static uInt64 ourTIARepeatedScanlines;
+    static const Device* ourCartridge;
+};
+
+#endif
@@ -0,0 +1,657 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <SDL.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+#include "Console.hxx"
+#include "FrameBufferSoft.hxx"
+#include "FSNode.hxx"
+#include "M6502.hxx"
+#include "OSystem.hxx"
+#include "Settings.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "Thumbulator.hxx"
+#include "Bench.hxx"
+#include "MicroBench.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Helpers for assembling the 6502 test programs, which are located at $F000
+static uInt16 here(const vector<uInt8>& code)
+{
+  return 0xF000 + code.size();
+}
+
+static void op(vector<uInt8>& code, uInt8 opcode)
+{
+  code.push_back(opcode);
+}
+
+static void op(vector<uInt8>& code, uInt8 opcode, uInt8 operand)
+{
+  code.push_back(opcode);
+  code.push_back(operand);
+}
+
+static void op(vector<uInt8>& code, uInt8 opcode, uInt16 address, bool)
+{
+  code.push_back(opcode);
+  code.push_back(address & 0xff);
+  code.push_back(address >> 8);
+}
+
+static void bne(vector<uInt8>& code, uInt16 target)
+{
+  code.push_back(0xD0);
+  code.push_back((uInt8)(target - (here(code) + 1)));
+}
+
+static void jmp(vector<uInt8>& code, uInt16 target)
+{
+  op(code, 0x4C, target, true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MicroBench::MicroBench(OSystem& osystem, const string& filter, uInt32 minTime)
+  : myOSystem(osystem),
+    myFilter(filter),
+    myMinTime(minTime),
+    myFrameBuffer(NULL),
+    myThumbulator(NULL),
+    mySink(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBench::run()
+{
+  cout << setw(36) << left << "benchmark" << right
+       << setw(12) << "ns/op" << setw(14) << "ops" << endl;
+
+  bool ok = runSystem();
+  ok = runCPU() && ok;
+  ok = runTIA() && ok;
+  ok = runSound() && ok;
+  ok = runFrameBuffer() && ok;
+  ok = runThumbulator() && ok;
+
+  myOSystem.deleteConsole();
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBench::selected(const string& name) const
+{
+  return name.find(myFilter) != string::npos;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MicroBench::measure(const string& name, Method method, uInt32 param)
+{
+  if(!selected(name))
+    return;
+
+  // Warm up caches and branch predictors first
+  (this->*method)(param);
+
+  uInt64 ops = 0, elapsed = 0;
+  uInt64 start = Bench::now();
+  do
+  {
+    ops += (this->*method)(param);
+    elapsed = Bench::now() - start;
+  }
+  while(elapsed < (uInt64)myMinTime * 1000000);
+
+  cout << setw(36) << left << name << right << fixed << setprecision(2)
+       << setw(12) << (double)elapsed / (double)ops
+       << setw(14) << ops << endl;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBench::loadProgram(Program program)
+{
+  vector<uInt8> code;
+
+  // All programs start by initializing the CPU
+  op(code, 0x78);               // SEI
+  op(code, 0xD8);               // CLD
+  op(code, 0xA2, 0xFF);         // LDX #$FF
+  op(code, 0x9A);               // TXS
+  uInt16 loop = here(code);
+
+  switch(program)
+  {
+    case kSystemProgram:
+      break;
+
+    case kNopProgram:
+      for(int i = 0; i < 64; ++i)
+        op(code, 0xEA);         // NOP
+      break;
+
+    case kAluProgram:
+      op(code, 0xA9, 0x12);     // LDA #$12
+      op(code, 0x65, 0x80);     // ADC $80
+      op(code, 0x85, 0x81);     // STA $81
+      op(code, 0x49, 0xFF);     // EOR #$FF
+      op(code, 0x0A);           // ASL
+      op(code, 0x66, 0x82);     // ROR $82
+      op(code, 0xE8);           // INX
+      op(code, 0x88);           // DEY
+      op(code, 0xC5, 0x83);     // CMP $83
+      op(code, 0x29, 0x3F);     // AND #$3F
+      op(code, 0x05, 0x84);     // ORA $84
+      op(code, 0xE9, 0x01);     // SBC #$01
+      op(code, 0x18);           // CLC
+      break;
+
+    case kMemoryProgram:
+      op(code, 0xA9, 0x00);     // LDA #$00
+      op(code, 0x85, 0x90);     // STA $90
+      op(code, 0xA9, 0xF0);     // LDA #$F0
+      op(code, 0x85, 0x91);     // STA $91
+      loop = here(code);
+      op(code, 0xB9, 0xF000, true);  // LDA $F000,Y
+      op(code, 0x85, 0xA0);     // STA $A0
+      op(code, 0xB1, 0x90);     // LDA ($90),Y
+      op(code, 0xC8);           // INY
+      op(code, 0x8A);           // TXA
+      op(code, 0x29, 0x3F);     // AND #$3F
+      op(code, 0xAA);           // TAX
+      op(code, 0xB5, 0x80);     // LDA $80,X
+      op(code, 0x95, 0x81);     // STA $81,X
+      op(code, 0xE8);           // INX
+      break;
+
+    case kBranchProgram:
+    {
+      op(code, 0xA2, 0x00);     // LDX #$00
+      uInt16 inner = here(code);
+      op(code, 0xCA);           // DEX
+      bne(code, inner);
+      break;
+    }
+
+    case kBlankFrame:
+    case kBusyFrame:
+    {
+      op(code, 0xA9, 0x02);     // LDA #$02
+      op(code, 0x85, 0x00);     // STA VSYNC
+      op(code, 0x85, 0x02);     // STA WSYNC
+      op(code, 0x85, 0x02);     // STA WSYNC
+      op(code, 0x85, 0x02);     // STA WSYNC
+      op(code, 0xA9, 0x00);     // LDA #$00
+      op(code, 0x85, 0x00);     // STA VSYNC
+
+      op(code, 0xA2, 37);       // LDX #37
+      uInt16 vblank = here(code);
+      op(code, 0x85, 0x02);     // STA WSYNC
+      op(code, 0xCA);           // DEX
+      bne(code, vblank);
+      op(code, 0xA9, 0x00);     // LDA #$00
+      op(code, 0x85, 0x01);     // STA VBLANK
+
+      op(code, 0xA2, 192);      // LDX #192
+      uInt16 line = here(code);
+      op(code, 0x85, 0x02);     // STA WSYNC
+      if(program == kBusyFrame)
+      {
+        op(code, 0x85, 0x2A);   // STA HMOVE
+        op(code, 0x8A);         // TXA
+        op(code, 0x85, 0x09);   // STA COLUBK
+        op(code, 0x85, 0x0D);   // STA PF0
+        op(code, 0x49, 0xFF);   // EOR #$FF
+        op(code, 0x85, 0x0E);   // STA PF1
+        op(code, 0x85, 0x08);   // STA COLUPF
+        op(code, 0x8A);         // TXA
+        op(code, 0x0A);         // ASL
+        op(code, 0x85, 0x0F);   // STA PF2
+        op(code, 0x85, 0x1B);   // STA GRP0
+        op(code, 0x85, 0x1C);   // STA GRP1
+        op(code, 0x85, 0x06);   // STA COLUP0
+        op(code, 0x85, 0x20);   // STA HMP0
+      }
+      op(code, 0xCA);           // DEX
+      bne(code, line);
+
+      op(code, 0xA9, 0x02);     // LDA #$02
+      op(code, 0x85, 0x01);     // STA VBLANK
+      op(code, 0xA2, 30);       // LDX #30
+      uInt16 overscan = here(code);
+      op(code, 0x85, 0x02);     // STA WSYNC
+      op(code, 0xCA);           // DEX
+      bne(code, overscan);
+      break;
+    }
+  }
+  jmp(code, loop);
+
+  // The same code is placed in both banks of an F8 cartridge, with the
+  // RESET and BRK vectors pointing to it
+  uInt8 image[8192];
+  memset(image, 0xEA, sizeof(image));
+  for(uInt32 bank = 0; bank < 8192; bank += 4096)
+  {
+    memcpy(image + bank, &code[0], code.size());
+    image[bank + 0xFFC] = image[bank + 0xFFE] = 0x00;
+    image[bank + 0xFFD] = image[bank + 0xFFF] = 0xF0;
+  }
+
+  const string& romfile = myOSystem.baseDir() + "microbench.bin";
+  ofstream out(romfile.c_str(), ios::binary);
+  out.write((const char*)image, sizeof(image));
+  out.close();
+  if(!out)
+  {
+    cerr << "ERROR: Couldn't write '" << romfile << "'" << endl;
+    return false;
+  }
+
+  myOSystem.settings().setValue("type", "F8");
+  bool created = myOSystem.createConsole(FilesystemNode(romfile)) == EmptyString;
+  myOSystem.settings().setValue("type", "");
+  remove(romfile.c_str());
+
+  if(!created)
+    cerr << "ERROR: Couldn't create console for test program" << endl;
+
+  return created;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBench::runSystem()
+{
+  // RAM and ROM (including the non-hotspot part of the cartridge hotspot
+  // page) are accessed directly; the RIOT and TIA go through their
+  // devices, and the last one hits the cartridge hotspots themselves,
+  // switching banks on every access
+  static const struct {
+    const char* name;
+    Method method;
+    uInt16 address;
+  } accesses[] = {
+    { "system.peek.ram",  &MicroBench::peek, 0x0080 },
+    { "system.peek.rom",  &MicroBench::peek, 0x1000 },
+    { "system.peek.riot", &MicroBench::peek, 0x0284 },
+    { "system.peek.tia",  &MicroBench::peek, 0x0030 },
+    { "system.peek.cart", &MicroBench::peek, 0x1FC0 },
+    { "system.poke.ram",  &MicroBench::poke, 0x0080 },
+    { "system.poke.riot", &MicroBench::poke, 0x0281 },
+    { "system.poke.tia",  &MicroBench::poke, 0x0009 },
+    { "system.poke.cart", &MicroBench::poke, 0x1FC0 },
+    { "system.bankswitch", &MicroBench::bankswitch, 0x1FF8 }
+  };
+  const uInt32 size = sizeof(accesses) / sizeof(accesses[0]);
+
+  bool any = false;
+  for(uInt32 i = 0; i < size; ++i)
+    any = any || selected(accesses[i].name);
+  if(!any)
+    return true;
+
+  if(!loadProgram(kSystemProgram))
+    return false;
+
+  for(uInt32 i = 0; i < size; ++i)
+    measure(accesses[i].name, accesses[i].method, accesses[i].address);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBench::runCPU()
+{
+  static const struct {
+    Program program;
+    const char* name;
+  } programs[] = {
+    { kNopProgram,    "m6502.execute.nop"    },
+    { kAluProgram,    "m6502.execute.alu"    },
+    { kMemoryProgram, "m6502.execute.memory" },
+    { kBranchProgram, "m6502.execute.branch" }
+  };
+
+  for(uInt32 i = 0; i < sizeof(programs) / sizeof(programs[0]); ++i)
+  {
+    if(!selected(programs[i].name))
+      continue;
+    if(!loadProgram(programs[i].program))
+      return false;
+    measure(programs[i].name, &MicroBench::execute);
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBench::runTIA()
+{
+  // Each frame is measured with everything enabled, and then with each
+  // renderer on its own: the SIMD kernel (where available), the span
+  // renderer and the per-pixel renderer
+  static const struct {
+    Program program;
+    bool repeat;
+    bool simd;
+    bool spans;
+    const char* name;
+  } frames[] = {
+    { kBlankFrame, true,  true,  true,  "tia.update.blank"        },
+    { kBlankFrame, false, true,  true,  "tia.update.blank.simd"   },
+    { kBlankFrame, false, false, true,  "tia.update.blank.spans"  },
+    { kBlankFrame, false, false, false, "tia.update.blank.pixels" },
+    { kBusyFrame,  true,  true,  true,  "tia.update.busy"         },
+    { kBusyFrame,  false, true,  true,  "tia.update.busy.simd"    },
+    { kBusyFrame,  false, false, true,  "tia.update.busy.spans"   },
+    { kBusyFrame,  false, false, false, "tia.update.busy.pixels"  }
+  };
+
+  Settings& settings = myOSystem.settings();
+  bool repeat = settings.getBool("tiarepeat"),
+       simd = settings.getBool("tiasimd"), spans = settings.getBool("tiaspans");
+  for(uInt32 i = 0; i < sizeof(frames) / sizeof(frames[0]); ++i)
+  {
+    if(!selected(frames[i].name))
+      continue;
+
+    settings.setValue("tiarepeat", frames[i].repeat);
+    settings.setValue("tiasimd", frames[i].simd);
+    settings.setValue("tiaspans", frames[i].spans);
+    if(!loadProgram(frames[i].program))
+      return false;
+    measure(frames[i].name, &MicroBench::frame);
+  }
+  settings.setValue("tiarepeat", repeat);
+  settings.setValue("tiasimd", simd);
+  settings.setValue("tiaspans", spans);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBench::runSound()
+{
+  myTIASound.outputFrequency(31400);
+  myTIASound.channels(2, true);
+
+  for(uInt32 audc = 0; audc < 16; ++audc)
+  {
+    ostringstream name;
+    name << "tiasound.process.audc" << audc;
+
+    myTIASound.reset();
+    myTIASound.set(0x15, audc);  // AUDC0
+    myTIASound.set(0x16, audc);  // AUDC1
+    myTIASound.set(0x17, 7);     // AUDF0
+    myTIASound.set(0x18, 3);     // AUDF1
+    myTIASound.set(0x19, 15);    // AUDV0
+    myTIASound.set(0x1a, 15);    // AUDV1
+    measure(name.str(), &MicroBench::sound, audc);
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBench::runFrameBuffer()
+{
+  static const struct {
+    FrameBufferSoft::RenderType type;
+    int bpp;
+    const char* name;
+  } renderers[] = {
+    { FrameBufferSoft::kSoftZoom_16, 16, "fbsoft.drawTIA.zoom16"     },
+    { FrameBufferSoft::kSoftZoom_24, 24, "fbsoft.drawTIA.zoom24"     },
+    { FrameBufferSoft::kSoftZoom_32, 32, "fbsoft.drawTIA.zoom32"     },
+    { FrameBufferSoft::kPhosphor_16, 16, "fbsoft.drawTIA.phosphor16" },
+    { FrameBufferSoft::kPhosphor_24, 24, "fbsoft.drawTIA.phosphor24" },
+    { FrameBufferSoft::kPhosphor_32, 32, "fbsoft.drawTIA.phosphor32" }
+  };
+
+  bool any = false;
+  for(uInt32 i = 0; i < sizeof(renderers) / sizeof(renderers[0]); ++i)
+    any = any || selected(renderers[i].name);
+  if(!any)
+    return true;
+
+  // Render whatever the busy kernel draws; two frames are emulated so
+  // that the current and previous frame buffers differ
+  if(!loadProgram(kBusyFrame))
+    return false;
+  TIA& tia = myOSystem.console().tia();
+  tia.update();
+  tia.update();
+
+  // A greyscale palette is good enough for timing purposes
+  uInt32 palette[256];
+  for(uInt32 i = 0; i < 256; ++i)
+    palette[i] = (i << 16) | (i << 8) | i;
+
+  // The framebuffer draws into an offscreen surface, at the default zoom
+  FrameBufferSoft fb(&myOSystem);
+  myFrameBuffer = &fb;
+  const int zoom = 2;
+
+  bool ok = true;
+  for(uInt32 i = 0; i < sizeof(renderers) / sizeof(renderers[0]); ++i)
+  {
+    SDL_Surface* surface =
+      SDL_CreateRGBSurface(SDL_SWSURFACE, tia.width() * 2 * zoom,
+                           tia.height() * zoom, renderers[i].bpp, 0, 0, 0, 0);
+    if(surface == NULL)
+    {
+      cerr << "ERROR: Couldn't create " << renderers[i].bpp
+           << "-bit surface: " << SDL_GetError() << endl;
+      ok = false;
+      continue;
+    }
+
+    fb.myScreen = surface;
+    fb.myFormat = surface->format;
+    fb.myBytesPerPixel = surface->format->BytesPerPixel;
+    fb.myPitch = fb.myBytesPerPixel == 3 ? surface->pitch :
+                 surface->pitch / fb.myBytesPerPixel;
+    fb.myRenderType = renderers[i].type;
+    fb.myZoomLevel = zoom;
+    fb.myBaseOffset = 0;
+    fb.myUsePhosphor = renderers[i].type >= FrameBufferSoft::kPhosphor_16;
+    fb.setTIAPalette(palette);
+
+    measure(renderers[i].name, &MicroBench::drawTIA);
+
+    fb.myScreen = NULL;
+    SDL_FreeSurface(surface);
+  }
+  myFrameBuffer = NULL;
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MicroBench::runThumbulator()
+{
+#ifdef THUMB_SUPPORT
+  // All programs start at the DPC+ entry point and return through LR.
+  // The first only measures the cost of a call into the ARM code; the
+  // others point r1 at RAM and run a loop 250 times, either mixing
+  // arithmetic with a load/store pair, or mostly doing loads/stores
+  static const struct {
+    uInt16 code[16];
+    uInt32 length;
+    uInt32 instructions;
+    const char* name;
+  } programs[] = {
+    { { 0x4770 },  //       bx   lr
+      1, 1, "thumbulator.call" },
+    { { 0x2000,    //       movs r0,#0
+        0x2140,    //       movs r1,#0x40
+        0x0609,    //       lsls r1,r1,#24
+        0x2210,    //       movs r2,#0x10
+        0x0212,    //       lsls r2,r2,#8
+        0x1889,    //       adds r1,r1,r2      @ r1 = 0x40001000 (RAM)
+        0x23FA,    //       movs r3,#250
+        0x1CC0,    // loop: adds r0,r0,#3
+        0x4058,    //       eors r0,r3
+        0x6048,    //       str  r0,[r1,#4]
+        0x684A,    //       ldr  r2,[r1,#4]
+        0x0852,    //       lsrs r2,r2,#1
+        0x1880,    //       adds r0,r0,r2
+        0x3B01,    //       subs r3,#1
+        0xD1F7,    //       bne  loop
+        0x4770 },  //       bx   lr
+      16, 7 + 250 * 8 + 1, "thumbulator.run.alu" },
+    { { 0x2000,    //       movs r0,#0
+        0x2140,    //       movs r1,#0x40
+        0x0609,    //       lsls r1,r1,#24
+        0x2210,    //       movs r2,#0x10
+        0x0212,    //       lsls r2,r2,#8
+        0x1889,    //       adds r1,r1,r2      @ r1 = 0x40001000 (RAM)
+        0x23FA,    //       movs r3,#250
+        0x6048,    // loop: str  r0,[r1,#4]
+        0x684A,    //       ldr  r2,[r1,#4]
+        0x608A,    //       str  r2,[r1,#8]
+        0x688C,    //       ldr  r4,[r1,#8]
+        0x60CC,    //       str  r4,[r1,#12]
+        0x68C8,    //       ldr  r0,[r1,#12]
+        0x3B01,    //       subs r3,#1
+        0xD1F7,    //       bne  loop
+        0x4770 },  //       bx   lr
+      16, 7 + 250 * 8 + 1, "thumbulator.run.memory" }
+  };
+
+  for(uInt32 i = 0; i < sizeof(programs) / sizeof(programs[0]); ++i)
+  {
+    if(!selected(programs[i].name))
+      continue;
+
+    // The image is stored little-endian, as in a cartridge file
+    static uInt8 image[ROMSIZE];
+    memset(image, 0, sizeof(image));
+    for(uInt32 j = 0; j < programs[i].length; ++j)
+    {
+      image[0xC08 + j * 2]     = programs[i].code[j] & 0xff;
+      image[0xC08 + j * 2 + 1] = programs[i].code[j] >> 8;
+    }
+    static uInt16 rom[ROMSIZE / 2], ram[RAMSIZE / 2];
+    memcpy(rom, image, sizeof(rom));
+    memset(ram, 0, sizeof(ram));
+
+    Thumbulator thumb(rom, ram, true);
+    myThumbulator = &thumb;
+    measure(programs[i].name, &MicroBench::thumbulator,
+            programs[i].instructions);
+    myThumbulator = NULL;
+  }
+#endif
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 MicroBench::peek(uInt32 address)
+{
+  System& system = myOSystem.console().system();
+
+  uInt32 result = 0;
+  for(uInt32 i = 0; i < kAccesses; ++i)
+    result += system.peek(address);
+  mySink += result;
+
+  return kAccesses;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 MicroBench::poke(uInt32 address)
+{
+  System& system = myOSystem.console().system();
+
+  for(uInt32 i = 0; i < kAccesses; ++i)
+    system.poke(address, i);
+
+  return kAccesses;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 MicroBench::bankswitch(uInt32 hotspot)
+{
+  System& system = myOSystem.console().system();
+
+  // Alternate between the two banks of the F8 cartridge
+  uInt32 result = 0;
+  for(uInt32 i = 0; i < kAccesses; ++i)
+    result += system.peek(hotspot + (i & 1));
+  mySink += result;
+
+  return kAccesses;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 MicroBench::execute(uInt32)
+{
+  M6502& cpu = myOSystem.console().system().m6502();
+
+  int count = cpu.totalInstructionCount();
+  cpu.execute(kInstructions);
+
+  return (uInt32)(cpu.totalInstructionCount() - count);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 MicroBench::frame(uInt32)
+{
+  TIA& tia = myOSystem.console().tia();
+
+  for(uInt32 i = 0; i < kFrames; ++i)
+    tia.update();
+
+  return kFrames;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 MicroBench::sound(uInt32)
+{
+  myTIASound.process(mySamples, kSoundSamples);
+  mySink += mySamples[0];
+
+  return kSoundSamples;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 MicroBench::drawTIA(uInt32)
+{
+  for(uInt32 i = 0; i < kFrames; ++i)
+    myFrameBuffer->drawTIA(true);
+
+  return kFrames;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 MicroBench::thumbulator(uInt32 instructions)
+{
+#ifdef THUMB_SUPPORT
+  for(uInt32 i = 0; i < kThumbCalls; ++i)
+    myThumbulator->run();
+#endif
+
+  return (uInt64)instructions * kThumbCalls;
+}
@@ -0,0 +1,143 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef MICRO_BENCH_HXX
+#define MICRO_BENCH_HXX
+
+class OSystem;
+class FrameBufferSoft;
+class Thumbulator;
+
+#include "bspf.hxx"
+#include "TIASnd.hxx"
+
+/**
+  This class implements the microbenchmarks run by 'stella-microbench'.
+  Each one exercises a single hot path of the emulation core in isolation
+  (System peek/poke, M6502::execute, TIA frame generation, TIASound, the
+  FrameBufferSoft TIA renderers and the Thumbulator ARM core), and
+  reports the time taken per operation.
+
+  All workloads are synthetic, so no ROMs are needed; the 6502 programs
+  are assembled into a small cartridge image whenever a console is needed,
+  and the Thumb program is placed where DPC+ drivers expect their ARM code.
+
+  @author  Stella Team
+  @version $Id$
+*/
+class MicroBench
+{
+  public:
+    /**
+      Create the microbenchmarks.
+
+      @param osystem  The (headless) OSystem used to create consoles
+      @param filter   Only run benchmarks whose name contains this string
+      @param minTime  The minimum time to run each benchmark, in ms
+    */
+    MicroBench(OSystem& osystem, const string& filter, uInt32 minTime);
+
+    /**
+      Run all (selected) benchmarks, printing the results on stdout.
+
+      @return  False if any of the benchmarks couldn't be run
+    */
+    bool run();
+
+  private:
+    // A benchmark body; it performs a batch of operations parameterized
+    // by 'param', and answers the number of operations performed
+    typedef uInt64 (MicroBench::*Method)(uInt32 param);
+
+    // Programs used to build the test cartridges
+    enum Program {
+      kSystemProgram,  // Idle loop; the system is driven directly
+      kNopProgram,     // Straight-line NOPs
+      kAluProgram,     // Arithmetic/logic on registers and zero-page
+      kMemoryProgram,  // Indexed and indirect memory accesses
+      kBranchProgram,  // Tight DEX/BNE loop
+      kBlankFrame,     // Full frame, only WSYNC on every scanline
+      kBusyFrame       // Full frame, many TIA writes on every scanline
+    };
+
+    /**
+      Create a console running the given program, answering false on error.
+      The cartridge is an F8 image, so it has both direct-access and
+      device (hotspot) pages.
+    */
+    bool loadProgram(Program program);
+
+    /**
+      Answer whether the named benchmark passes the filter.
+    */
+    bool selected(const string& name) const;
+
+    /**
+      Run the benchmark body repeatedly, for at least the minimum time,
+      and print its ns/op.
+    */
+    void measure(const string& name, Method method, uInt32 param = 0);
+
+    // Benchmark bodies
+    uInt64 peek(uInt32 address);
+    uInt64 poke(uInt32 address);
+    uInt64 bankswitch(uInt32 hotspot);
+    uInt64 execute(uInt32);
+    uInt64 frame(uInt32);
+    uInt64 sound(uInt32 audc);
+    uInt64 drawTIA(uInt32);
+    uInt64 thumbulator(uInt32 instructions);
+
+    // Helpers for the groups of benchmarks
+    bool runSystem();
+    bool runCPU();
+    bool runTIA();
+    bool runSound();
+    bool runFrameBuffer();
+    bool runThumbulator();
+
+  private:
+    OSystem& myOSystem;
+    string myFilter;
+    uInt32 myMinTime;
+
+    // Number of operations performed per call of the benchmark bodies
+    enum {
+      kAccesses     = 1000000,
+      kInstructions = 1000000,
+      kSoundSamples = 1024,
+      kFrames       = 10,
+      kThumbCalls   = 100
+    };
+
+    // Sound generator and buffer for its samples (stereo)
+    TIASound myTIASound;
+    Int16 mySamples[kSoundSamples * 2];
+
+    // Framebuffer rendering into an offscreen surface
+    FrameBufferSoft* myFrameBuffer;
+
+    // ARM emulator running the Thumb program
+    Thumbulator* myThumbulator;
+
+    // Prevents results from being optimized away
+    uInt32 mySink;
+};
+
+#endif
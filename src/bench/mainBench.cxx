@@ -0,0 +1,356 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <SDL.h>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+#include "bspf.hxx"
+#include "Console.hxx"
+#include "Cart.hxx"
+#include "FSNode.hxx"
+#include "M6502.hxx"
+#include "OSystem.hxx"
+#include "Random.hxx"
+#include "Settings.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "Version.hxx"
+#include "Bench.hxx"
+
+#if defined(UNIX)
+  #include "SettingsUNIX.hxx"
+  #include "OSystemUNIX.hxx"
+#elif defined(WIN32)
+  #include "SettingsWin32.hxx"
+  #include "OSystemWin32.hxx"
+#elif defined(MAC_OSX)
+  #include "SettingsMACOSX.hxx"
+  #include "OSystemMACOSX.hxx"
+#else
+  #error Unsupported platform!
+#endif
+
+// Results of benchmarking one ROM
+struct BenchResult
+{
+  string rom, md5, type, error;
+  uInt32 frames;
+  uInt64 instructions;
+  uInt64 tiaWrites;
+  uInt64 tiaScanlines, tiaRepeatedScanlines;  // full scanlines drawn/copied
+  uInt64 runTime;                        // uninstrumented run, in ns
+  uInt64 sectionTime[Bench::NumSections];  // instrumented run, in ns
+};
+
+// Pointer to the main parent osystem object or the null pointer
+static OSystem* theOSystem = (OSystem*) NULL;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void usage()
+{
+  cout << "stella-bench version " << STELLA_VERSION << endl
+       << endl
+       << "Usage: stella-bench [options ...] rom1 [rom2 ...]" << endl
+       << endl
+       << "Valid options are:" << endl
+       << endl
+       << "  -frames  <number>   Number of frames to emulate per ROM (default 600)" << endl
+       << "  -seed    <number>   Seed for the random number generator (default 1)" << endl
+       << "  -romlist <file>     Also benchmark the ROMs listed in file, one per line" << endl
+       << "  -json    <file>     Write the results to file instead of stdout" << endl
+       << endl
+       << "All other options are passed on to the emulation core, as for Stella." << endl
+       << endl;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static string jsonString(const string& s)
+{
+  ostringstream buf;
+  buf << '"';
+  for(uInt32 i = 0; i < s.length(); ++i)
+  {
+    unsigned char c = s[i];
+    if(c == '"' || c == '\\')
+      buf << '\\' << c;
+    else if(c < 0x20)
+      buf << "\\u" << hex << setw(4) << setfill('0') << (int)c << dec;
+    else
+      buf << c;
+  }
+  buf << '"';
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static double perSecond(uInt64 count, uInt64 ns)
+{
+  return ns > 0 ? (double)count * 1000000000.0 / (double)ns : 0.0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Emulate the given number of frames on a freshly created console, and
+// store either the overall speed or the section timings in the result
+static bool runROM(const FilesystemNode& rom, uInt32 frames, bool instrument,
+                   BenchResult& result)
+{
+  // Every run starts from an identical machine state
+  Random::setFixedSeed(theOSystem->settings().getInt("seed"));
+  const string& error = theOSystem->createConsole(rom);
+  if(error != EmptyString)
+  {
+    result.error = error;
+    return false;
+  }
+
+  Console& console = theOSystem->console();
+  M6502& cpu = console.system().m6502();
+  TIA& tia = console.tia();
+
+  result.md5  = console.about().CartMD5;
+  result.type = console.about().BankSwitch;
+
+  Bench::reset();
+  Bench::setCartridge(&console.cartridge());
+  Bench::setEnabled(instrument);
+
+  // The 6502 instruction counter is only 32 bits, so accumulate per frame
+  uInt64 instructions = 0;
+  uInt64 start = Bench::now();
+  for(uInt32 i = 0; i < frames; ++i)
+  {
+    int count = cpu.totalInstructionCount();
+    tia.update();
+    instructions += (uInt32)(cpu.totalInstructionCount() - count);
+  }
+  uInt64 elapsed = Bench::now() - start;
+
+  Bench::setEnabled(false);
+  Bench::setCartridge(0);
+
+  if(instrument)
+  {
+    for(int s = 0; s < Bench::NumSections; ++s)
+      result.sectionTime[s] = Bench::time((Bench::Section)s);
+  }
+  else
+  {
+    result.runTime = elapsed;
+    result.instructions = instructions;
+    result.tiaWrites = Bench::tiaWrites();
+    result.tiaScanlines = Bench::tiaScanlines();
+    result.tiaRepeatedScanlines = Bench::tiaRepeatedScanlines();
+  }
+
+  theOSystem->deleteConsole();
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void writeJSON(ostream& out, const vector<BenchResult>& results,
+                      uInt32 frames)
+{
+  out << setprecision(10)
+      << "{" << endl
+      << "  \"version\": " << jsonString(STELLA_VERSION) << "," << endl
+      << "  \"frames\": " << frames << "," << endl
+      << "  \"seed\": " << theOSystem->settings().getInt("seed") << "," << endl
+      << "  \"roms\": [" << endl;
+
+  for(uInt32 i = 0; i < results.size(); ++i)
+  {
+    const BenchResult& r = results[i];
+    out << "    {" << endl
+        << "      \"rom\": " << jsonString(r.rom) << "," << endl;
+    if(r.error != "")
+    {
+      out << "      \"error\": " << jsonString(r.error) << endl;
+    }
+    else
+    {
+      double seconds = (double)r.runTime / 1000000000.0;
+      double ms = 1000000.0;
+      out << "      \"md5\": " << jsonString(r.md5) << "," << endl
+          << "      \"type\": " << jsonString(r.type) << "," << endl
+          << "      \"seconds\": " << seconds << "," << endl
+          << "      \"fps\": " << perSecond(r.frames, r.runTime) << "," << endl
+          << "      \"instructions\": " << r.instructions << "," << endl
+          << "      \"instructions_per_sec\": "
+          << perSecond(r.instructions, r.runTime) << "," << endl
+          << "      \"tia_writes_per_frame\": "
+          << (r.frames ? (double)r.tiaWrites / r.frames : 0.0) << "," << endl
+          << "      \"tia_scanline_repeat_rate\": "
+          << (r.tiaScanlines ? (double)r.tiaRepeatedScanlines / r.tiaScanlines : 0.0)
+          << "," << endl
+          << "      \"time_ms\": {" << endl
+          << "        \"m6502_execute\": "
+          << r.sectionTime[Bench::CPU] / ms << "," << endl
+          << "        \"tia_update_frame\": "
+          << r.sectionTime[Bench::TIA] / ms << "," << endl
+          << "        \"tiasound_process\": "
+          << r.sectionTime[Bench::Sound] / ms << "," << endl
+          << "        \"cart_peek_poke\": "
+          << r.sectionTime[Bench::Cart] / ms << endl
+          << "      }" << endl;
+    }
+    out << "    }" << (i + 1 < results.size() ? "," : "") << endl;
+  }
+
+  out << "  ]" << endl
+      << "}" << endl;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main(int argc, char* argv[])
+{
+  ios_base::sync_with_stdio(false);
+
+  // Options come first and are passed on to Settings; everything after
+  // them is a ROM to benchmark
+  int firstROM = 1;
+  while(firstROM < argc && argv[firstROM][0] == '-')
+  {
+    string key = argv[firstROM];
+    if(key == "-help" || key == "--help" || key == "-h")
+    {
+      usage();
+      return 0;
+    }
+    firstROM += 2;
+  }
+  if(firstROM > argc)
+  {
+    cerr << "Missing argument for '" << argv[argc-1] << "'" << endl;
+    return 1;
+  }
+
+#if defined(UNIX)
+  theOSystem = new OSystemUNIX();
+  SettingsUNIX settings(theOSystem);
+#elif defined(WIN32)
+  theOSystem = new OSystemWin32();
+  SettingsWin32 settings(theOSystem);
+#elif defined(MAC_OSX)
+  theOSystem = new OSystemMACOSX();
+  SettingsMACOSX settings(theOSystem);
+#endif
+
+  // The user's config file is deliberately not loaded, so that results
+  // don't depend on whoever runs the benchmark
+  settings.setValue("loglevel", "0");
+  settings.setValue("seed", "1");
+  settings.setValue("frames", "600");
+  settings.loadCommandLine(firstROM, argv);
+  settings.setValue("headless", "true");
+  settings.validate();
+
+  vector<BenchResult> results;
+  for(int i = firstROM; i < argc; ++i)
+  {
+    BenchResult r;
+    r.rom = argv[i];
+    results.push_back(r);
+  }
+  const string& romlist = settings.getString("romlist");
+  if(romlist != "")
+  {
+    ifstream in(romlist.c_str());
+    if(!in)
+    {
+      cerr << "ERROR: Couldn't open ROM list '" << romlist << "'" << endl;
+      delete theOSystem;
+      return 1;
+    }
+    string line;
+    while(getline(in, line))
+    {
+      string::size_type first = line.find_first_not_of(" \t\r"),
+                        last  = line.find_last_not_of(" \t\r");
+      if(first == string::npos || line[first] == '#')
+        continue;
+
+      BenchResult r;
+      r.rom = line.substr(first, last - first + 1);
+      results.push_back(r);
+    }
+  }
+  if(results.size() == 0)
+  {
+    usage();
+    delete theOSystem;
+    return 1;
+  }
+
+  if(!theOSystem->create())
+  {
+    cerr << "ERROR: Couldn't create OSystem" << endl;
+    delete theOSystem;
+    return 1;
+  }
+
+  int frames = settings.getInt("frames");
+  if(frames <= 0) frames = 600;
+
+  // Each ROM is run twice: once without timers to measure the overall
+  // speed, and once more with them to find out where that time went
+  bool failed = false;
+  for(uInt32 i = 0; i < results.size(); ++i)
+  {
+    BenchResult& r = results[i];
+    r.frames = frames;
+    r.instructions = r.tiaWrites = r.runTime = 0;
+    r.tiaScanlines = r.tiaRepeatedScanlines = 0;
+    for(int s = 0; s < Bench::NumSections; ++s)
+      r.sectionTime[s] = 0;
+
+    FilesystemNode rom(r.rom);
+    if(!rom.exists() || rom.isDirectory())
+      r.error = "ERROR: ROM file not found";
+    else if(runROM(rom, frames, false, r))
+      runROM(rom, frames, true, r);
+
+    if(r.error != "")
+    {
+      cerr << r.rom << ": " << r.error << endl;
+      failed = true;
+    }
+  }
+
+  const string& json = settings.getString("json");
+  if(json != "")
+  {
+    ofstream out(json.c_str());
+    writeJSON(out, results, frames);
+    if(!out)
+    {
+      cerr << "ERROR: Couldn't write results to '" << json << "'" << endl;
+      failed = true;
+    }
+  }
+  else
+    writeJSON(cout, results, frames);
+
+  delete theOSystem;
+  SDL_Quit();
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,110 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <SDL.h>
+#include <cstdlib>
+
+#include "bspf.hxx"
+#include "OSystem.hxx"
+#include "Settings.hxx"
+#include "Version.hxx"
+#include "MicroBench.hxx"
+
+#if defined(UNIX)
+  #include "SettingsUNIX.hxx"
+  #include "OSystemUNIX.hxx"
+#elif defined(WIN32)
+  #include "SettingsWin32.hxx"
+  #include "OSystemWin32.hxx"
+#elif defined(MAC_OSX)
+  #include "SettingsMACOSX.hxx"
+  #include "OSystemMACOSX.hxx"
+#else
+  #error Unsupported platform!
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void usage()
+{
+  cout << "stella-microbench version " << STELLA_VERSION << endl
+       << endl
+       << "Usage: stella-microbench [options ...]" << endl
+       << endl
+       << "Valid options are:" << endl
+       << endl
+       << "  -filter <text>      Only run benchmarks whose name contains text" << endl
+       << "  -time   <ms>        Minimum time to run each benchmark (default 250)" << endl
+       << endl;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main(int argc, char* argv[])
+{
+  ios_base::sync_with_stdio(false);
+
+  string filter = "";
+  int minTime = 250;
+  for(int i = 1; i < argc; ++i)
+  {
+    string key = argv[i];
+    if((key == "-filter" || key == "-time") && i + 1 < argc)
+    {
+      if(key == "-filter")
+        filter = argv[++i];
+      else
+        minTime = atoi(argv[++i]);
+    }
+    else
+    {
+      usage();
+      return key == "-help" ? 0 : 1;
+    }
+  }
+  if(minTime <= 0) minTime = 250;
+
+#if defined(UNIX)
+  OSystem* osystem = new OSystemUNIX();
+  SettingsUNIX settings(osystem);
+#elif defined(WIN32)
+  OSystem* osystem = new OSystemWin32();
+  SettingsWin32 settings(osystem);
+#elif defined(MAC_OSX)
+  OSystem* osystem = new OSystemMACOSX();
+  SettingsMACOSX settings(osystem);
+#endif
+
+  // As for stella-bench, the user's config file is never loaded
+  settings.setValue("loglevel", "0");
+  settings.setValue("headless", "true");
+  settings.validate();
+
+  bool ok = osystem->create();
+  if(ok)
+  {
+    MicroBench bench(*osystem, filter, minTime);
+    ok = bench.run();
+  }
+  else
+    cerr << "ERROR: Couldn't create OSystem" << endl;
+
+  delete osystem;
+  SDL_Quit();
+
+  return ok ? 0 : 1;
+}
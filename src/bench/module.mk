@@ -0,0 +1,16 @@
+MODULE := src/bench
+
+# The benchmarks aren't part of Stella itself, so their objects are kept
+# out of OBJS; see the 'bench' target in the main Makefile
+BENCH_MODULE_OBJS := \
+	src/bench/Bench.o
+
+BENCH_MAIN_OBJS := \
+	src/bench/mainBench.o
+
+MICROBENCH_MAIN_OBJS := \
+	src/bench/MicroBench.o \
+	src/bench/mainMicroBench.o
+
+MODULE_DIRS += \
+	src/bench
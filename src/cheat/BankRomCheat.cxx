@@ -19,6 +19,7 @@
 
 #include "Console.hxx"
 #include "Cart.hxx"
+#include "M6502.hxx"
 #include "OSystem.hxx"
 #include "BankRomCheat.hxx"
 
@@ -59,6 +60,7 @@ bool BankRomCheat::disable()
 
   for(int i = 0; i < count; ++i)
 		myOSystem->console().cartridge().patch(address + i, savedRom[i]);
+  myOSystem->console().system().m6502().flushDecodedInstructions();
 
   myOSystem->console().cartridge().bank(oldBank);
 
@@ -75,6 +77,7 @@ void BankRomCheat::evaluate()
 
     for(int i = 0; i < count; ++i)
       myOSystem->console().cartridge().patch(address + i, value);
+    myOSystem->console().system().m6502().flushDecodedInstructions();
 
     myOSystem->console().cartridge().bank(oldBank);
 
@@ -19,6 +19,7 @@
 
 #include "Console.hxx"
 #include "Cart.hxx"
+#include "M6502.hxx"
 #include "OSystem.hxx"
 #include "CheetahCheat.hxx"
 
@@ -52,6 +53,7 @@ bool CheetahCheat::disable()
 {
   for(int i = 0; i < count; ++i)
     myOSystem->console().cartridge().patch(address + i, savedRom[i]);
+  myOSystem->console().system().m6502().flushDecodedInstructions();
 
   return myEnabled = false;
 }
@@ -63,6 +65,7 @@ void CheetahCheat::evaluate()
   {
     for(int i = 0; i < count; ++i)
       myOSystem->console().cartridge().patch(address + i, value);
+    myOSystem->console().system().m6502().flushDecodedInstructions();
 
     myEnabled = true;
   }
@@ -0,0 +1,221 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include "AudioRecorder.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioRecorder::AudioRecorder()
+  : myFilled(0),
+    myEmptied(0),
+    myHaveBuffer(false),
+    myFreeBuffers(NULL),
+    myFullBuffers(NULL),
+    myThread(NULL),
+    myIsWav(false),
+    myFrequency(0),
+    myNumChannels(0),
+    myWait(false),
+    myWritten(0),
+    myDropped(0)
+{
+  for(uInt32 i = 0; i < NUM_BUFFERS; ++i)
+  {
+    myBuffers[i].samples = NULL;
+    myBuffers[i].length = 0;
+    myBuffers[i].last = false;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioRecorder::~AudioRecorder()
+{
+  close();
+  for(uInt32 i = 0; i < NUM_BUFFERS; ++i)
+    delete[] myBuffers[i].samples;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool AudioRecorder::open(const string& filename, uInt32 frequency,
+                         uInt32 channels, bool wait)
+{
+  close();
+
+  myFile.open(filename.c_str(), ios::out | ios::binary | ios::trunc);
+  if(!myFile)
+    return false;
+
+  myIsWav = BSPF_endsWithIgnoreCase(filename, ".wav");
+  myFrequency = frequency;
+  myNumChannels = channels;
+  myWait = wait;
+  if(myIsWav)
+    writeHeader(0);
+
+  // All memory is allocated up front, so that recording itself never has to
+  // allocate anything
+  for(uInt32 i = 0; i < NUM_BUFFERS; ++i)
+  {
+    if(myBuffers[i].samples == NULL)
+      myBuffers[i].samples = new Int16[BUFFER_SIZE];
+    myBuffers[i].length = 0;
+    myBuffers[i].last = false;
+  }
+  myFilled = myEmptied = 0;
+  myWritten = myDropped = 0;
+
+  // The producer starts out holding the first buffer
+  myFreeBuffers = SDL_CreateSemaphore(NUM_BUFFERS - 1);
+  myFullBuffers = SDL_CreateSemaphore(0);
+  myHaveBuffer = true;
+  if(myFreeBuffers && myFullBuffers)
+    myThread = SDL_CreateThread(writer, this);
+
+  if(myThread == NULL)
+  {
+    if(myFreeBuffers) SDL_DestroySemaphore(myFreeBuffers);
+    if(myFullBuffers) SDL_DestroySemaphore(myFullBuffers);
+    myFreeBuffers = myFullBuffers = NULL;
+    myHaveBuffer = false;
+    myFile.close();
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioRecorder::close()
+{
+  if(myThread == NULL)
+    return;
+
+  // Hand on the partly filled (or empty) buffer as the last one, waiting
+  // for a free one if necessary, and let the writer thread finish
+  if(!myHaveBuffer)
+    SDL_SemWait(myFreeBuffers);
+  myBuffers[myFilled % NUM_BUFFERS].last = true;
+  SDL_SemPost(myFullBuffers);
+  SDL_WaitThread(myThread, NULL);
+  myThread = NULL;
+
+  SDL_DestroySemaphore(myFreeBuffers);
+  SDL_DestroySemaphore(myFullBuffers);
+  myFreeBuffers = myFullBuffers = NULL;
+  myHaveBuffer = false;
+
+  // The sizes in the header can only be filled in now
+  if(myIsWav)
+  {
+    uInt64 dataSize = myWritten * 2;
+    myFile.seekp(0);
+    writeHeader((uInt32)BSPF_min(dataSize, (uInt64)0xffffffffu - 36));
+  }
+  myFile.close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioRecorder::write(const Int16* samples, uInt32 length)
+{
+  while(length > 0)
+  {
+    if(!myHaveBuffer)
+    {
+      // Wait for the writer thread to free a buffer, or give up on
+      // these samples if there isn't one
+      if(myWait)
+        SDL_SemWait(myFreeBuffers);
+      else if(SDL_SemTryWait(myFreeBuffers) != 0)
+      {
+        myDropped += length;
+        return;
+      }
+      myHaveBuffer = true;
+    }
+
+    Buffer& b = myBuffers[myFilled % NUM_BUFFERS];
+    uInt32 count = BSPF_min(length, BUFFER_SIZE - b.length);
+    memcpy(b.samples + b.length, samples, count << 1);
+    b.length += count;
+    samples += count;
+    length -= count;
+
+    if(b.length == BUFFER_SIZE)
+      nextBuffer();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioRecorder::nextBuffer()
+{
+  ++myFilled;
+  SDL_SemPost(myFullBuffers);
+
+  myHaveBuffer = SDL_SemTryWait(myFreeBuffers) == 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int AudioRecorder::writer(void* recorder)
+{
+  AudioRecorder* r = (AudioRecorder*)recorder;
+
+  for(;;)
+  {
+    SDL_SemWait(r->myFullBuffers);
+
+    Buffer& b = r->myBuffers[r->myEmptied % NUM_BUFFERS];
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    for(uInt32 i = 0; i < b.length; ++i)
+      b.samples[i] = SDL_Swap16(b.samples[i]);
+#endif
+    r->myFile.write((const char*)b.samples, b.length << 1);
+    r->myWritten += b.length;
+    if(b.last)
+      break;
+
+    b.length = 0;
+    ++r->myEmptied;
+    SDL_SemPost(r->myFreeBuffers);
+  }
+
+  return 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioRecorder::writeHeader(uInt32 dataSize)
+{
+  uInt32 bytesPerFrame = myNumChannels * 2;
+  uInt32 values[] = {
+    0x46464952, 36 + dataSize, 0x45564157,       // "RIFF", size, "WAVE"
+    0x20746d66, 16,                              // "fmt ", size
+    1 | (myNumChannels << 16),                   // PCM, channels
+    myFrequency, myFrequency * bytesPerFrame,    // sample and byte rates
+    bytesPerFrame | (16 << 16),                  // block size, bits
+    0x61746164, dataSize                         // "data", size
+  };
+
+  // WAV files are always little-endian
+  uInt8 header[44];
+  for(uInt32 i = 0; i < 11; ++i)
+  {
+    header[i*4]   = values[i] & 0xff;
+    header[i*4+1] = (values[i] >> 8) & 0xff;
+    header[i*4+2] = (values[i] >> 16) & 0xff;
+    header[i*4+3] = (values[i] >> 24) & 0xff;
+  }
+  myFile.write((const char*)header, 44);
+}
@@ -0,0 +1,166 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef AUDIO_RECORDER_HXX
+#define AUDIO_RECORDER_HXX
+
+#include <fstream>
+#include <SDL.h>
+
+#include "bspf.hxx"
+
+/**
+  This class records 16-bit sound samples to a file, either as a WAV file
+  (when the filename ends in '.wav') or as raw little-endian samples.
+
+  Samples are copied into a ring of preallocated buffers, and a thread of
+  its own writes each buffer to the file once it's full, so whoever
+  creates the samples never has to wait for the disk.  If the thread falls
+  so far behind that the whole ring is full, the samples are either
+  dropped (and counted) or the caller waits for a free buffer, as chosen
+  when the file is opened.
+
+  @author  Stella Team
+  @version $Id$
+*/
+class AudioRecorder
+{
+  public:
+    /**
+      Create a new recorder, which isn't recording yet.
+    */
+    AudioRecorder();
+
+    /**
+      Destructor, which finishes the recording if there is one
+    */
+    virtual ~AudioRecorder();
+
+  public:
+    /**
+      Start recording to the given file, replacing any file already there.
+
+      @param filename   The file to record to
+      @param frequency  The sample rate of the samples
+      @param channels   The number of interleaved channels (1 or 2)
+      @param wait       Wait for a free buffer instead of dropping samples
+      @return  false if the file or the writer thread couldn't be created
+    */
+    bool open(const string& filename, uInt32 frequency, uInt32 channels,
+              bool wait);
+
+    /**
+      Write the remaining samples, complete the file and stop recording.
+    */
+    void close();
+
+    /**
+      Answer whether a recording is in progress.
+    */
+    bool isOpen() const { return myThread != NULL; }
+
+    /**
+      Add samples to the recording.  Unless the recorder was opened to
+      wait, this never blocks, and is safe to call from the audio callback.
+      Only one thread may call this at a time.
+
+      @param samples  The samples, with the channels interleaved
+      @param length   The number of samples (counting each channel)
+    */
+    void write(const Int16* samples, uInt32 length);
+
+    /**
+      Answer the number of samples written to the file, and the number
+      dropped because no buffer was free; these are only meaningful once
+      the recording is closed.
+    */
+    uInt64 samplesWritten() const { return myWritten; }
+    uInt64 samplesDropped() const { return myDropped; }
+
+  private:
+    /**
+      Pass the buffer being filled on to the writer thread, and get
+      another one to fill (if there's a free one).
+    */
+    void nextBuffer();
+
+    /**
+      The writer thread, which writes full buffers until it gets the
+      last one.
+    */
+    static int writer(void* recorder);
+
+    /**
+      Write the WAV header, with the given size of the sample data.
+    */
+    void writeHeader(uInt32 dataSize);
+
+  private:
+    enum {
+      NUM_BUFFERS  = 16,     // together about 1.5 seconds of stereo 44.1KHz
+      BUFFER_SIZE  = 8192    // in samples, so about 93 ms of stereo 44.1KHz
+    };
+
+    // The ring of preallocated buffers
+    struct Buffer {
+      Int16* samples;
+      uInt32 length;  // number of samples in the buffer
+      bool last;      // the recording ends with this buffer
+    };
+    Buffer myBuffers[NUM_BUFFERS];
+
+    // The number of buffers handed on to the writer thread so far, and the
+    // number it has written; used modulo NUM_BUFFERS as ring indices
+    // Each is only ever touched by one side
+    uInt32 myFilled;
+    uInt32 myEmptied;
+
+    // Whether the producer has a buffer to fill (myFilled is its index)
+    bool myHaveBuffer;
+
+    // Count the free and the full buffers in the ring; everything in a
+    // buffer is passed between the threads by these
+    SDL_sem* myFreeBuffers;
+    SDL_sem* myFullBuffers;
+
+    // The writer thread
+    SDL_Thread* myThread;
+
+    // The file being written, and the details for its header
+    ofstream myFile;
+    bool myIsWav;
+    uInt32 myFrequency;
+    uInt32 myNumChannels;
+
+    // Wait for a free buffer instead of dropping samples
+    bool myWait;
+
+    // Samples written by the writer thread, and dropped by the producer
+    uInt64 myWritten;
+    uInt64 myDropped;
+
+  private:
+    // Copy constructor isn't supported by this class so make it private
+    AudioRecorder(const AudioRecorder&);
+
+    // Assignment operator isn't supported by this class so make it private
+    AudioRecorder& operator = (const AudioRecorder&);
+};
+
+#endif
@@ -38,7 +38,8 @@ FBSurfaceTIA::FBSurfaceTIA(FrameBufferGL& buffer)
     myBaseH(0),
     myScanlinesEnabled(false),
     myScanlineIntensityI(50),
-    myScanlineIntensityF(0.5)
+    myScanlineIntensityF(0.5),
+    myRedrawAll(true)
 {
   myTexID[0] = myTexID[1] = 0;
 
@@ -83,13 +84,15 @@ void FBSurfaceTIA::update()
 {
   // Copy the mediasource framebuffer to the RGB texture
   // In OpenGL mode, it's faster to just assume that the screen is dirty
-  // and always do an update
+  // and always do an update, but in normal mode only the scanlines the TIA
+  // reports as changed are converted and sent to the texture
 
   uInt8* currentFrame  = myTIA->currentFrameBuffer();
   uInt8* previousFrame = myTIA->previousFrameBuffer();
   uInt32 width         = myTIA->width();
   uInt32 height        = myTIA->height();
   uInt32* buffer       = (uInt32*) myTexture->pixels;
+  uInt32 firstLine = 0, lastLine = height;
 
   // TODO - Eventually 'phosphor' won't be a separate mode, and will become
   //        a post-processing filter by blending several frames.
@@ -97,17 +100,24 @@ void FBSurfaceTIA::update()
   {
     case FrameBufferGL::kNormal:
     {
+      firstLine = height;  lastLine = 0;
       uInt32 bufofsY    = 0;
       uInt32 screenofsY = 0;
       for(uInt32 y = 0; y < height; ++y)
       {
-        uInt32 pos = screenofsY;
-        for(uInt32 x = 0; x < width; ++x)
-          buffer[pos++] = (uInt32) myFB.myDefPalette[currentFrame[bufofsY + x]];
+        if(myRedrawAll || myTIA->scanlineChanged(y))
+        {
+          uInt32 pos = screenofsY;
+          for(uInt32 x = 0; x < width; ++x)
+            buffer[pos++] = (uInt32) myFB.myDefPalette[currentFrame[bufofsY + x]];
 
+          if(firstLine > y)  firstLine = y;
+          lastLine = y + 1;
+        }
         bufofsY    += width;
         screenofsY += myPitch;
       }
+      myRedrawAll = false;
       break;
     }
     case FrameBufferGL::kPhosphor:
@@ -142,6 +152,10 @@ void FBSurfaceTIA::update()
     }
   }
 
+  // The other modes leave the texture out of step with the current frame
+  if(myFB.myFilterType != FrameBufferGL::kNormal)
+    myRedrawAll = true;
+
   myGL.EnableClientState(GL_VERTEX_ARRAY);
   myGL.EnableClientState(GL_TEXTURE_COORD_ARRAY);
 
@@ -150,9 +164,14 @@ void FBSurfaceTIA::update()
   myGL.BindTexture(GL_TEXTURE_2D, myTexID[0]);
   myGL.PixelStorei(GL_UNPACK_ALIGNMENT, 1);
   myGL.PixelStorei(GL_UNPACK_ROW_LENGTH, myPitch);
-  myGL.TexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, myBaseW, myBaseH,
-                    GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
-                    myTexture->pixels);
+  if(firstLine == 0 && lastLine == height)
+    myGL.TexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, myBaseW, myBaseH,
+                      GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
+                      myTexture->pixels);
+  else if(firstLine < lastLine)
+    myGL.TexSubImage2D(GL_TEXTURE_2D, 0, 0, firstLine, myBaseW,
+                      lastLine - firstLine, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
+                      buffer + firstLine * myPitch);
 
   if(myFB.myVBOAvailable)
   {
@@ -203,6 +222,7 @@ void FBSurfaceTIA::update()
 void FBSurfaceTIA::invalidate()
 {
   SDL_FillRect(myTexture, NULL, 0);
+  myRedrawAll = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
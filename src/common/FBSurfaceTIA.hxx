@@ -55,7 +55,7 @@ class FBSurfaceTIA : public FBSurface
     void reload();
 
   private:
-    void setTIA(const TIA& tia) { myTIA = &tia; }
+    void setTIA(const TIA& tia) { myTIA = &tia; myRedrawAll = true; }
     void setTIAPalette(const uInt32* palette);
     void enableScanlines(bool enable) { myScanlinesEnabled = enable; }
     void setScanIntensity(uInt32 intensity);
@@ -83,6 +83,9 @@ class FBSurfaceTIA : public FBSurface
     bool myScanlinesEnabled;
     GLuint  myScanlineIntensityI;
     GLfloat myScanlineIntensityF;
+
+    // Convert every scanline on the next update, not only changed ones
+    bool myRedrawAll;
 };
 
 #endif  // DISPLAY_OPENGL
@@ -63,6 +63,10 @@ class FilesystemNodeZIP : public AbstractFSNode
     bool rename(const string& newfile) { return false; }
     //////////////////////////////////////////////////////////
 
+    // The archive is what changes, so it describes all the files inside it
+    bool getFileInfo(uInt32& size, uInt32& modified) const
+      { return _realNode && _realNode->getFileInfo(size, modified); }
+
     bool getChildren(AbstractFSList& list, ListMode mode, bool hidden) const;
     AbstractFSNode* getParent() const;
 
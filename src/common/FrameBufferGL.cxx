@@ -351,6 +351,8 @@ void FrameBufferGL::invalidate()
 void FrameBufferGL::drawTIA(bool fullRedraw)
 {
   // The TIA surface takes all responsibility for drawing
+  if(fullRedraw)
+    myTiaSurface->myRedrawAll = true;
   myTiaSurface->update();
 }
 
@@ -160,7 +160,36 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
   uInt8* previousFrame  = tia.previousFrameBuffer();
 
   uInt32 width  = tia.width();
-  uInt32 height = tia.height();
+  uInt32 height = BSPF_min(tia.height(), 320u);
+
+  // Unless everything is redrawn, only the scanlines the TIA reports as
+  // changed are looked at, and only they are updated on the screen
+  // The phosphor modes blend in the previous frame, so they can't do this
+  bool changed[320];
+  if(fullRedraw)
+    myTiaDirty = true;
+  else if(!myUsePhosphor)
+  {
+    SDL_Rect rect;
+    rect.x = imageRect().x();
+    rect.w = width * 2 * myZoomLevel;
+
+    uInt32 first = 0;
+    for(uInt32 y = 0; y <= height; ++y)
+    {
+      if(y < height && (changed[y] = tia.scanlineChanged(y)))
+        continue;
+
+      // The end of a run of changed scanlines
+      if(y > first)
+      {
+        rect.y = imageRect().y() + first * myZoomLevel;
+        rect.h = (y - first) * myZoomLevel;
+        myRectList->add(&rect);
+      }
+      first = y + 1;
+    }
+  }
 
   switch(myRenderType)
   {
@@ -172,6 +201,13 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
       uInt32 screenofsY = 0;
       for(uInt32 y = 0; y < height; ++y)
       {
+        if(!fullRedraw && !changed[y])
+        {
+          bufofsY    += width;
+          screenofsY += myPitch * myZoomLevel;
+          continue;
+        }
+
         uInt32 ystride = myZoomLevel;
         while(ystride--)
         {
@@ -191,7 +227,6 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
                 buffer[pos++] = (uInt16) myDefPalette[v];
                 buffer[pos++] = (uInt16) myDefPalette[v];
               }
-              myTiaDirty = true;
             }
             else
               pos += xstride + xstride;
@@ -212,6 +247,13 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
       uInt32 screenofsY = 0;
       for(uInt32 y = 0; y < height; ++y)
       {
+        if(!fullRedraw && !changed[y])
+        {
+          bufofsY    += width;
+          screenofsY += myPitch * myZoomLevel;
+          continue;
+        }
+
         uInt32 ystride = myZoomLevel;
         while(ystride--)
         {
@@ -235,7 +277,6 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
                 buffer[pos++] = a;  buffer[pos++] = b;  buffer[pos++] = c;
                 buffer[pos++] = a;  buffer[pos++] = b;  buffer[pos++] = c;
               }
-              myTiaDirty = true;
             }
             else  // try to eliminate multiply whereever possible
               pos += xstride + xstride + xstride + xstride + xstride + xstride;
@@ -256,6 +297,13 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
       uInt32 screenofsY = 0;
       for(uInt32 y = 0; y < height; ++y)
       {
+        if(!fullRedraw && !changed[y])
+        {
+          bufofsY    += width;
+          screenofsY += myPitch * myZoomLevel;
+          continue;
+        }
+
         uInt32 ystride = myZoomLevel;
         while(ystride--)
         {
@@ -275,7 +323,6 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
                 buffer[pos++] = (uInt32) myDefPalette[v];
                 buffer[pos++] = (uInt32) myDefPalette[v];
               }
-              myTiaDirty = true;
             }
             else
               pos += xstride + xstride;
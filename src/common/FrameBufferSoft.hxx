@@ -38,6 +38,9 @@ class RectList;
 class FrameBufferSoft : public FrameBuffer
 {
   friend class FBSurfaceSoft;
+#ifdef BENCHMARK_SUPPORT
+  friend class MicroBench;
+#endif
 
   public:
     /**
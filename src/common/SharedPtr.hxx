@@ -65,6 +65,18 @@ class SharedPtrDeletionDeleterImpl : public SharedPtrDeletionInternal
     D _deleter;
 };
 
+/**
+ * A deleter for SharedPtr objects managing arrays allocated with new[].
+ *
+ * Example creation:
+ * Common::SharedPtr<int> array(new int[10], Common::ArrayDeleter<int>());
+ */
+template<class T>
+struct ArrayDeleter
+{
+  void operator()(T *ptr) { delete[] ptr; }
+};
+
 /**
  * A simple shared pointer implementation modelled after boost.
  *
@@ -124,6 +136,13 @@ class SharedPtr
     SharedPtr(const SharedPtr &r) : _refCount(r._refCount), _deletion(r._deletion), _pointer(r._pointer) { if (_refCount) ++(*_refCount); }
     template<class T2> SharedPtr(const SharedPtr<T2> &r) : _refCount(r._refCount), _deletion(r._deletion), _pointer(r._pointer) { if (_refCount) ++(*_refCount); }
 
+    /**
+     * Creates a SharedPtr sharing ownership with r, but pointing to p
+     * (usually something inside the object r manages, such as part of
+     * an array).  The object is still freed through r's pointer.
+     */
+    template<class T2> SharedPtr(const SharedPtr<T2> &r, T *p) : _refCount(r._refCount), _deletion(r._deletion), _pointer(p) { if (_refCount) ++(*_refCount); }
+
     ~SharedPtr() { decRef(); }
 
     SharedPtr &operator =(const SharedPtr &r)
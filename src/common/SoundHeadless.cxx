@@ -0,0 +1,196 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <sstream>
+
+#include "OSystem.hxx"
+#include "Serializer.hxx"
+#include "Settings.hxx"
+#include "SoundHeadless.hxx"
+#ifdef BENCHMARK_SUPPORT
+  #include "Bench.hxx"
+#endif
+
+// NTSC CPU clock, as used by SoundSDL to convert cycles into time
+#define CPU_CLOCK 1193192
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoundHeadless::SoundHeadless(OSystem* osystem)
+  : Sound(osystem),
+    myFrequency(31400),
+    myNumChannels(1),
+    myLastRegisterSetCycle(0),
+    myCycleRemainder(0),
+    mySamples(0)
+{
+  myOSystem->logMessage("Sound is generated, but not played.\n", 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SoundHeadless::~SoundHeadless()
+{
+  if(myRecorder.isOpen())
+  {
+    myRecorder.close();
+
+    ostringstream buf;
+    buf << "Recorded " << myRecorder.samplesWritten() / 2 << " samples to '"
+        << myOSystem->settings().getString("audiorecord") << "'";
+    myOSystem->logMessage(buf.str(), 1);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundHeadless::open()
+{
+  int freq = myOSystem->settings().getInt("freq");
+  myFrequency = freq > 0 ? freq : 31400;
+
+  // Mirror what SoundSDL does for a stereo hardware device
+  myTIASound.outputFrequency(myFrequency);
+  setResampling(myOSystem->settings().getString("resampling"));
+  myTIASound.channels(2, myNumChannels == 2);
+  mySamples = 0;
+
+  // The recording covers every ROM run, so it's only started once; since
+  // nothing has to keep up with a sound device, it's allowed to wait for
+  // the disk and so never drops any samples
+  const string& record = myOSystem->settings().getString("audiorecord");
+  if(record != "" && !myRecorder.isOpen() &&
+     !myRecorder.open(record, myFrequency, 2, true))
+    myOSystem->logMessage("ERROR: Couldn't record sound to '" + record + "'", 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundHeadless::close()
+{
+  reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundHeadless::reset()
+{
+  myLastRegisterSetCycle = 0;
+  myCycleRemainder = 0;
+  myTIASound.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundHeadless::setResampling(const string& quality)
+{
+  myTIASound.resampling(quality == "low"  ? TIASound::ResampleLow :
+                        quality == "high" ? TIASound::ResampleHigh :
+                                            TIASound::ResampleMedium);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundHeadless::setChannels(uInt32 channels)
+{
+  if(channels == 1 || channels == 2)
+    myNumChannels = channels;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundHeadless::adjustCycleCounter(Int32 amount)
+{
+  // This is only called when the system cycles are reset to zero at the
+  // start of a frame, so finish generating the samples for the last one
+  processUpTo(-amount);
+  myLastRegisterSetCycle += amount;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundHeadless::set(uInt16 addr, uInt8 value, Int32 cycle)
+{
+  processUpTo(cycle);
+  myTIASound.set(addr, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundHeadless::processUpTo(Int32 cycle)
+{
+  if(cycle <= myLastRegisterSetCycle)
+    return;
+
+  myCycleRemainder += (uInt64)(cycle - myLastRegisterSetCycle) * myFrequency;
+  myLastRegisterSetCycle = cycle;
+
+  uInt32 samples = (uInt32)(myCycleRemainder / CPU_CLOCK);
+  myCycleRemainder -= (uInt64)samples * CPU_CLOCK;
+  mySamples += samples;
+
+#ifdef BENCHMARK_SUPPORT
+  Bench::Timer timer(Bench::Sound);
+#endif
+  while(samples > 0)
+  {
+    uInt32 count = BSPF_min(samples, (uInt32)BUFFER_SAMPLES);
+    myTIASound.process(myBuffer, count);
+    if(myRecorder.isOpen())
+      myRecorder.write(myBuffer, count * 2);
+    samples -= count;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoundHeadless::save(Serializer& out) const
+{
+  try
+  {
+    out.putString(name());
+
+    out.putByte(myTIASound.get(0x15));
+    out.putByte(myTIASound.get(0x16));
+    out.putByte(myTIASound.get(0x17));
+    out.putByte(myTIASound.get(0x18));
+    out.putByte(myTIASound.get(0x19));
+    out.putByte(myTIASound.get(0x1a));
+
+    out.putInt(myLastRegisterSetCycle);
+  }
+  catch(...)
+  {
+    myOSystem->logMessage("ERROR: SoundHeadless::save", 0);
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoundHeadless::load(Serializer& in)
+{
+  try
+  {
+    if(in.getString() != name())
+      return false;
+
+    for(uInt16 addr = 0x15; addr <= 0x1a; ++addr)
+      myTIASound.set(addr, in.getByte());
+
+    myLastRegisterSetCycle = (Int32) in.getInt();
+  }
+  catch(...)
+  {
+    myOSystem->logMessage("ERROR: SoundHeadless::load", 0);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,120 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef SOUND_HEADLESS_HXX
+#define SOUND_HEADLESS_HXX
+
+class OSystem;
+
+#include "bspf.hxx"
+#include "Sound.hxx"
+#include "TIASnd.hxx"
+#include "AudioRecorder.hxx"
+
+/**
+  This class implements a sound object for headless mode, used by the
+  benchmark executables and when recording the sound of a headless run.
+  It never opens an audio device, but it does generate the samples a
+  real device would have requested, so that the cost of TIASound is
+  part of the measurements, and so they can be recorded to a file
+  (see the 'audiorecord' setting).
+
+  Since there's no audio callback, samples are generated from the
+  emulation itself: each register write first synthesizes the samples
+  up to the CPU cycle at which it happens, and the remainder of the
+  frame is synthesized when the system cycle counter is reset.
+
+  @author  Stella Team
+  @version $Id$
+*/
+class SoundHeadless : public Sound
+{
+  public:
+    /**
+      Create a new sound object.
+    */
+    SoundHeadless(OSystem* osystem);
+
+    /**
+      Destructor
+    */
+    virtual ~SoundHeadless();
+
+  public:
+    void setEnabled(bool enable) { }
+    void adjustCycleCounter(Int32 amount);
+    void setChannels(uInt32 channels);
+    void setFrameRate(float framerate) { }
+    void open();
+    void close();
+    void mute(bool state) { }
+    void reset();
+    void set(uInt16 addr, uInt8 value, Int32 cycle);
+    void setVolume(Int32 percent) { }
+    void adjustVolume(Int8 direction) { }
+    void setResampling(const string& quality);
+    void setRateControl(bool enable) { }
+    uInt32 droppedWrites() const { return 0; }
+    bool queueStats(uInt32& latency, uInt32& fill, uInt32& underruns) const
+      { return false; }
+
+    /**
+      Answer the number of samples generated since the sound was opened.
+    */
+    uInt64 samples() const { return mySamples; }
+
+  public:
+    bool save(Serializer& out) const;
+    bool load(Serializer& in);
+    string name() const { return "TIASound"; }
+
+  private:
+    /**
+      Generate the samples covering the CPU cycles up to the given one.
+    */
+    void processUpTo(Int32 cycle);
+
+  private:
+    enum { BUFFER_SAMPLES = 512 };
+
+    // The TIA sound generator
+    TIASound myTIASound;
+
+    // Output frequency and number of channels
+    uInt32 myFrequency;
+    uInt32 myNumChannels;
+
+    // Indicates the cycle when a sound register was last set
+    Int32 myLastRegisterSetCycle;
+
+    // Fractional sample count carried over between calls, in units of
+    // 1/CPU_CLOCK samples
+    uInt64 myCycleRemainder;
+
+    // Total number of samples generated
+    uInt64 mySamples;
+
+    // Scratch buffer receiving the generated samples (stereo)
+    Int16 myBuffer[BUFFER_SAMPLES * 2];
+
+    // Records the samples, if asked to
+    AudioRecorder myRecorder;
+};
+
+#endif
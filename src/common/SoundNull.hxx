@@ -48,7 +48,7 @@ class SoundNull : public Sound
     /**
       Destructor
     */
-    virtual ~SoundNull();
+    virtual ~SoundNull() { }
 
   public: 
     /**
@@ -132,6 +132,38 @@ class SoundNull : public Sound
     */
     void adjustVolume(Int8 direction) { }
 
+    /**
+      Sets the quality of the resampling from the TIA sound to the output
+      frequency, taking effect immediately.
+
+      @param quality  The quality, as in the 'resampling' setting
+    */
+    void setResampling(const string& quality) { }
+
+    /**
+      Turns on or off adjusting the rate at which sound is generated to
+      keep the amount of queued sound steady, taking effect immediately.
+
+      @param enable  Either true or false, as in the 'ratecontrol' setting
+    */
+    void setRateControl(bool enable) { }
+
+    /**
+      Answers the number of sound register writes dropped since the last
+      reset, because the sound device wasn't keeping up with them.
+
+      @return  The number of dropped register writes
+    */
+    uInt32 droppedWrites() const { return 0; }
+
+    /**
+      Answers how the sound output is keeping up with the emulation.
+
+      @return  Always false, since no sound is output
+    */
+    bool queueStats(uInt32& latency, uInt32& fill, uInt32& underruns) const
+      { return false; }
+
   public:
     /**
       Saves the current state of this device to the given Serializer.
@@ -143,7 +175,7 @@ class SoundNull : public Sound
     {
       out.putString("TIASound");
 
-      for(int = 0; i < 6; ++i)
+      for(int i = 0; i < 6; ++i)
         out.putByte(0);
 
       // myLastRegisterSetCycle
@@ -164,7 +196,7 @@ class SoundNull : public Sound
         return false;
 
       // Read sound registers and discard
-      for(int = 0; i < 6; ++i)
+      for(int i = 0; i < 6; ++i)
         in.getByte();
 
       // myLastRegisterSetCycle
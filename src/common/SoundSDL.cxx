@@ -32,19 +32,34 @@
 #include "Console.hxx"
 #include "SoundSDL.hxx"
 
+// The CPU clock rate on a real 2600, in which register writes are timed
+#define SOUND_CPU_CLOCK 1193191.66666667
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 SoundSDL::SoundSDL(OSystem* osystem)
   : Sound(osystem),
     myIsEnabled(false),
     myIsInitializedFlag(false),
     myLastRegisterSetCycle(0),
+    myFrontPlayed(0.0),
+    myResyncRegisters(false),
+    myDroppedWrites(0),
     myNumChannels(0),
     myFragmentSizeLogBase2(0),
+    myRateControl(false),
+    myTargetQueued(0.0),
+    myAverageQueued(0.0),
+    myRateDrift(0.0),
+    myLatency(0),
+    myFill(0),
+    myUnderruns(0),
     myIsMuted(true),
     myVolume(100)
 {
   myOSystem->logMessage("SoundSDL::SoundSDL started ...", 2);
 
+  memset(myRegisters, 0, sizeof(myRegisters));
+
   // The sound system is opened only once per program run, to eliminate
   // issues with opening and closing it multiple times
   // This fixes a bug most prevalent with ATI video cards in Windows,
@@ -83,6 +98,7 @@ SoundSDL::SoundSDL(OSystem* osystem)
   myFragmentSizeLogBase2 = log((double)myHardwareSpec.samples) / log(2.0);
   myFragmentSizeLogDiv1 = myFragmentSizeLogBase2 / 60.0;
   myFragmentSizeLogDiv2 = (myFragmentSizeLogBase2 - 1) / 60.0;
+  myTargetQueued = (double)myHardwareSpec.samples / myHardwareSpec.freq + 1 / 60.0;
 
   myIsInitializedFlag = true;
   SDL_PauseAudio(1);
@@ -100,6 +116,20 @@ SoundSDL::~SoundSDL()
     myIsEnabled = myIsInitializedFlag = false;
   }
 
+  if(myRecorder.isOpen())
+  {
+    myRecorder.close();
+
+    ostringstream buf;
+    buf << "Recorded " << myRecorder.samplesWritten() / myHardwareSpec.channels
+        << " samples to '" << myOSystem->settings().getString("audiorecord")
+        << "'";
+    if(myRecorder.samplesDropped() > 0)
+      buf << " (" << myRecorder.samplesDropped() / myHardwareSpec.channels
+          << " dropped)";
+    myOSystem->logMessage(buf.str(), 1);
+  }
+
   myOSystem->logMessage("SoundSDL destroyed", 2);
 }
 
@@ -126,6 +156,9 @@ void SoundSDL::open()
 
   // Now initialize the TIASound object which will actually generate sound
   myTIASound.outputFrequency(myHardwareSpec.freq);
+  setRateControl(myOSystem->settings().getBool("ratecontrol"));
+  const string& quality = myOSystem->settings().getString("resampling");
+  setResampling(quality);
   const string& chanResult =
       myTIASound.channels(myHardwareSpec.channels, myNumChannels == 2);
 
@@ -139,11 +172,27 @@ void SoundSDL::open()
       << "  Volume:      " << (int)myVolume << endl
       << "  Frag size:   " << (int)myHardwareSpec.samples << endl
       << "  Frequency:   " << (int)myHardwareSpec.freq << endl
+      << "  Resampling:  " << quality << endl
+      << "  Rate control:" << (myRateControl ? " on" : " off") << endl
       << "  Channels:    " << (int)myHardwareSpec.channels
                            << " (" << chanResult << ")" << endl
       << endl;
   myOSystem->logMessage(buf.str(), 1);
 
+  // The recording covers every ROM played, so it's only started once
+  // The sound callback mustn't see it while it's being started, but it
+  // never waits for the disk (dropping samples instead, if it has to)
+  const string& record = myOSystem->settings().getString("audiorecord");
+  if(record != "" && !myRecorder.isOpen())
+  {
+    SDL_LockAudio();
+    bool recording = myRecorder.open(record, myHardwareSpec.freq,
+                                     myHardwareSpec.channels, false);
+    SDL_UnlockAudio();
+    if(!recording)
+      myOSystem->logMessage("ERROR: Couldn't record sound to '" + record + "'", 0);
+  }
+
   // And start the SDL sound subsystem ...
   myIsEnabled = true;
   mute(false);
@@ -158,9 +207,7 @@ void SoundSDL::close()
   {
     myIsEnabled = false;
     SDL_PauseAudio(1);
-    myLastRegisterSetCycle = 0;
-    myTIASound.reset();
-    myRegWriteQueue.clear();
+    clearRegWrites();
     myOSystem->logMessage("SoundSDL::close", 2);
   }
 }
@@ -181,13 +228,29 @@ void SoundSDL::reset()
   if(myIsInitializedFlag)
   {
     SDL_PauseAudio(1);
-    myLastRegisterSetCycle = 0;
-    myTIASound.reset();
-    myRegWriteQueue.clear();
+    clearRegWrites();
     mute(myIsMuted);
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL::clearRegWrites()
+{
+  // The sound callback may still be running, even though it's paused
+  SDL_LockAudio();
+  myTIASound.reset();
+  myRegWriteQueue.clear();
+  myFrontPlayed = 0.0;
+  SDL_UnlockAudio();
+
+  myLastRegisterSetCycle = 0;
+  myResyncRegisters = false;
+  memset(myRegisters, 0, sizeof(myRegisters));
+  myDroppedWrites = 0;
+  myAverageQueued = myRateDrift = 0.0;
+  myLatency = myFill = myUnderruns = 0;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL::setVolume(Int32 percent)
 {
@@ -201,6 +264,33 @@ void SoundSDL::setVolume(Int32 percent)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL::setResampling(const string& quality)
+{
+  if(myIsInitializedFlag)
+  {
+    SDL_LockAudio();
+    myTIASound.resampling(quality == "low"  ? TIASound::ResampleLow :
+                          quality == "high" ? TIASound::ResampleHigh :
+                                              TIASound::ResampleMedium);
+    SDL_UnlockAudio();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL::setRateControl(bool enable)
+{
+  if(myIsInitializedFlag)
+  {
+    // Without rate control, sound is generated at the device frequency
+    SDL_LockAudio();
+    myRateControl = enable;
+    myRateDrift = 0.0;
+    myTIASound.adjustOutputFrequency(myHardwareSpec.freq);
+    SDL_UnlockAudio();
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL::adjustVolume(Int8 direction)
 {
@@ -230,6 +320,12 @@ void SoundSDL::adjustVolume(Int8 direction)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL::adjustCycleCounter(Int32 amount)
 {
+  // The cycle counter is reset at the start of every frame, so the end of
+  // the frame is queued here (as a write to no register at all); this way
+  // the queue holds all emulated sound, even when no registers are written
+  if(amount < 0)
+    set(0, 0, -amount);
+
   myLastRegisterSetCycle += amount;
 }
 
@@ -247,32 +343,71 @@ void SoundSDL::setFrameRate(float framerate)
   // FIXME - should we clear out the queue or adjust the values in it?
   myFragmentSizeLogDiv1 = myFragmentSizeLogBase2 / framerate;
   myFragmentSizeLogDiv2 = (myFragmentSizeLogBase2 - 1) / framerate;
+  if(myIsInitializedFlag)
+    myTargetQueued = (double)myHardwareSpec.samples / myHardwareSpec.freq +
+                     1 / framerate;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool SoundSDL::queueStats(uInt32& latency, uInt32& fill, uInt32& underruns) const
+{
+  if(!myIsEnabled)
+    return false;
+
+  latency   = myLatency;
+  fill      = myFill;
+  underruns = myUnderruns;
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL::set(uInt16 addr, uInt8 value, Int32 cycle)
 {
-  SDL_LockAudio();
+  // Nothing would ever take the writes off the queue
+  if(!myIsEnabled)
+    return;
 
-  // First, calculate how many seconds would have past since the last
-  // register write on a real 2600
-  double delta = (((double)(cycle - myLastRegisterSetCycle)) / 
-      (1193191.66666667));
+  if(addr >= 0x15 && addr <= 0x1a)
+    myRegisters[addr - 0x15] = value;
 
-  // Now, adjust the time based on the frame rate the user has selected. For
-  // the sound to "scale" correctly, we have to know the games real frame 
-  // rate (e.g., 50 or 60) and the currently emulated frame rate. We use these
-  // values to "scale" the time before the register change occurs.
+  // The time since the last register write is kept in CPU cycles; it's
+  // only converted to seconds (for the frame rate the sound is actually
+  // played at) by the sound callback
   RegWrite info;
   info.addr = addr;
   info.value = value;
-  info.delta = delta;
-  myRegWriteQueue.enqueue(info);
+  info.delta = cycle > myLastRegisterSetCycle ?
+               (uInt32)(cycle - myLastRegisterSetCycle) : 0;
+
+  if(myResyncRegisters)
+  {
+    // Writes have been dropped, so the sound callback must be given the
+    // current value of every register once there's room for all of them
+    if(myRegWriteQueue.capacity() - myRegWriteQueue.size() < 6)
+    {
+      ++myDroppedWrites;
+      return;
+    }
+    for(uInt16 i = 0; i < 6; ++i)
+    {
+      info.addr = 0x15 + i;
+      info.value = myRegisters[i];
+      myRegWriteQueue.enqueue(info);
+      info.delta = 0;
+    }
+    myResyncRegisters = false;
+  }
+  else if(!myRegWriteQueue.enqueue(info))
+  {
+    // The time of the dropped write is added to that of the next one,
+    // since the last cycle counter isn't updated
+    ++myDroppedWrites;
+    myResyncRegisters = true;
+    return;
+  }
 
   // Update last cycle counter to the current cycle
   myLastRegisterSetCycle = cycle;
-
-  SDL_UnlockAudio();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -281,19 +416,45 @@ void SoundSDL::processFragment(Int16* stream, uInt32 length)
   uInt32 channels = myHardwareSpec.channels;
   length = length / channels;
 
+  // The time of sound (in seconds) still to be played
+  double queued = myRegWriteQueue.duration() / SOUND_CPU_CLOCK - myFrontPlayed;
+
   // If there are excessive items on the queue then we'll remove some
-  if(myRegWriteQueue.duration() > myFragmentSizeLogDiv1)
+  if(queued > myFragmentSizeLogDiv1)
   {
-    double removed = 0.0;
-    while(removed < myFragmentSizeLogDiv2)
+    double removed = -myFrontPlayed;
+    while(removed < myFragmentSizeLogDiv2 && myRegWriteQueue.size() > 0)
     {
       RegWrite& info = myRegWriteQueue.front();
-      removed += info.delta;
+      removed += info.delta / SOUND_CPU_CLOCK;
       myTIASound.set(info.addr, info.value);
       myRegWriteQueue.dequeue();
     }
+    myFrontPlayed = 0.0;
+    queued -= removed;
+  }
+  myAverageQueued += (queued - myAverageQueued) * 0.05;
+
+  // The number of samples created for each second of queued sound; with
+  // rate control, the queue is played up to 1% faster when it's fuller
+  // than the target level, and slower when it's emptier.  That's far too
+  // little to be heard, but enough to make up for the emulation and the
+  // sound device not running at exactly the same speed.  That difference
+  // is learned slowly, so the queue settles at the target level itself.
+  double rate = myHardwareSpec.freq;
+  if(myRateControl)
+  {
+    double error = BSPF_clamp(myAverageQueued / myTargetQueued - 1.0, -1.0, 1.0);
+    myRateDrift = BSPF_clamp(myRateDrift + error * 0.00002, -0.0075, 0.0075);
+    double adjust = BSPF_clamp(myRateDrift + error * 0.0025, -0.01, 0.01);
+    rate = floor(myHardwareSpec.freq / (1.0 + adjust) + 0.5);
+    myTIASound.adjustOutputFrequency((Int32)rate);
   }
 
+  myLatency = (uInt32)((queued * myHardwareSpec.freq / rate +
+      (double)myHardwareSpec.samples / myHardwareSpec.freq) * 1000 + 0.5);
+  myFill = (uInt32)(myAverageQueued / myTargetQueued * 100 + 0.5);
+
   double position = 0.0;
   double remaining = length;
 
@@ -306,11 +467,9 @@ void SoundSDL::processFragment(Int16* stream, uInt32 length)
       myTIASound.process(stream + ((uInt32)position * channels),
           length - (uInt32)position);
 
-      // Since we had to fill the fragment we'll reset the cycle counter
-      // to zero.  NOTE: This isn't 100% correct, however, it'll do for
-      // now.  We should really remember the overrun and remove it from
-      // the delta of the next write.
-      myLastRegisterSetCycle = 0;
+      // Since the end of every frame is queued, this means the emulation
+      // has fallen behind the sound device
+      ++myUnderruns;
       break;
     }
     else
@@ -318,20 +477,21 @@ void SoundSDL::processFragment(Int16* stream, uInt32 length)
       // There are pending TIA sound register updates so we need to
       // update the sound buffer to the point of the next register update
       RegWrite& info = myRegWriteQueue.front();
+      double delta = info.delta / SOUND_CPU_CLOCK - myFrontPlayed;
 
       // How long will the remaining samples in the fragment take to play
-      double duration = remaining / (double)myHardwareSpec.freq;
+      double duration = remaining / rate;
 
       // Does the register update occur before the end of the fragment?
-      if(info.delta <= duration)
+      if(delta <= duration)
       {
         // If the register update time hasn't already passed then
         // process samples upto the point where it should occur
-        if(info.delta > 0.0)
+        if(delta > 0.0)
         {
           // Process the fragment upto the next TIA register write.  We
           // round the count passed to process up if needed.
-          double samples = (myHardwareSpec.freq * info.delta);
+          double samples = (rate * delta);
           myTIASound.process(stream + ((uInt32)position * channels),
               (uInt32)samples + (uInt32)(position + samples) - 
               ((uInt32)position + (uInt32)samples));
@@ -341,15 +501,16 @@ void SoundSDL::processFragment(Int16* stream, uInt32 length)
         }
         myTIASound.set(info.addr, info.value);
         myRegWriteQueue.dequeue();
+        myFrontPlayed = 0.0;
       }
       else
       {
         // The next register update occurs in the next fragment so finish
-        // this fragment with the current TIA settings and reduce the register
-        // update delay by the corresponding amount of time
+        // this fragment with the current TIA settings and remember how
+        // much of the register update delay has passed
         myTIASound.process(stream + ((uInt32)position * channels),
             length - (uInt32)position);
-        info.delta -= duration;
+        myFrontPlayed += duration;
         break;
       }
     }
@@ -366,6 +527,9 @@ void SoundSDL::callback(void* udata, uInt8* stream, int len)
     // emulator deals in 16-bit (signed) data
     // So, we need to convert the pointer and half the length
     sound->processFragment((Int16*)stream, (uInt32)len >> 1);
+
+    if(sound->myRecorder.isOpen())
+      sound->myRecorder.write((Int16*)stream, (uInt32)len >> 1);
   }
 }
 
@@ -429,13 +593,19 @@ bool SoundSDL::load(Serializer& in)
     if(myIsInitializedFlag)
     {
       SDL_PauseAudio(1);
+      SDL_LockAudio();
       myRegWriteQueue.clear();
+      myFrontPlayed = 0.0;
       myTIASound.set(0x15, reg1);
       myTIASound.set(0x16, reg2);
       myTIASound.set(0x17, reg3);
       myTIASound.set(0x18, reg4);
       myTIASound.set(0x19, reg5);
       myTIASound.set(0x1a, reg6);
+      SDL_UnlockAudio();
+      myResyncRegisters = false;
+      myRegisters[0] = reg1;  myRegisters[1] = reg2;  myRegisters[2] = reg3;
+      myRegisters[3] = reg4;  myRegisters[4] = reg5;  myRegisters[5] = reg6;
       if(!myIsMuted) SDL_PauseAudio(0);
     }
   }
@@ -450,12 +620,16 @@ bool SoundSDL::load(Serializer& in)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 SoundSDL::RegWriteQueue::RegWriteQueue(uInt32 capacity)
-  : myCapacity(capacity),
+  : myCapacity(1),
+    myMask(0),
     myBuffer(0),
-    mySize(0),
     myHead(0),
     myTail(0)
 {
+  while(myCapacity < capacity)
+    myCapacity <<= 1;
+  myMask = myCapacity - 1;
+
   myBuffer = new RegWrite[myCapacity];
 }
 
@@ -468,69 +642,62 @@ SoundSDL::RegWriteQueue::~RegWriteQueue()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL::RegWriteQueue::clear()
 {
-  myHead = myTail = mySize = 0;
+  myHead = myTail = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL::RegWriteQueue::dequeue()
 {
-  if(mySize > 0)
+  uInt32 head = myHead;
+  if(head != myTail)
   {
-    myHead = (myHead + 1) % myCapacity;
-    --mySize;
+    // Finish with the item before its slot can be reused
+    BSPF_memoryBarrier();
+    myHead = head + 1;
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double SoundSDL::RegWriteQueue::duration()
+uInt64 SoundSDL::RegWriteQueue::duration() const
 {
-  double duration = 0.0;
-  for(uInt32 i = 0; i < mySize; ++i)
-  {
-    duration += myBuffer[(myHead + i) % myCapacity].delta;
-  }
+  uInt64 duration = 0;
+  uInt32 head = myHead, size = this->size();
+  for(uInt32 i = 0; i < size; ++i)
+    duration += myBuffer[(head + i) & myMask].delta;
+
   return duration;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL::RegWriteQueue::enqueue(const RegWrite& info)
+bool SoundSDL::RegWriteQueue::enqueue(const RegWrite& info)
 {
-  // If an attempt is made to enqueue more than the queue can hold then
-  // we'll enlarge the queue's capacity.
-  if(mySize == myCapacity)
-    grow();
-
-  myBuffer[myTail] = info;
-  myTail = (myTail + 1) % myCapacity;
-  ++mySize;
+  uInt32 tail = myTail;
+  if(tail - myHead == myCapacity)
+    return false;
+
+  // Complete the item before the consumer can see it
+  myBuffer[tail & myMask] = info;
+  BSPF_memoryBarrier();
+  myTail = tail + 1;
+
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 SoundSDL::RegWrite& SoundSDL::RegWriteQueue::front()
 {
-  assert(mySize != 0);
-  return myBuffer[myHead];
+  assert(myHead != myTail);
+  return myBuffer[myHead & myMask];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 SoundSDL::RegWriteQueue::size() const
 {
-  return mySize;
-}
+  uInt32 size = myTail - myHead;
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL::RegWriteQueue::grow()
-{
-  RegWrite* buffer = new RegWrite[myCapacity * 2];
-  for(uInt32 i = 0; i < mySize; ++i)
-  {
-    buffer[i] = myBuffer[(myHead + i) % myCapacity];
-  }
-  myHead = 0;
-  myTail = mySize;
-  myCapacity = myCapacity * 2;
-  delete[] myBuffer;
-  myBuffer = buffer;
+  // The items counted must not be read before they're seen to be there
+  BSPF_memoryBarrier();
+  return size;
 }
 
 #endif  // SOUND_SUPPORT
@@ -29,6 +29,7 @@ class OSystem;
 #include "bspf.hxx"
 #include "TIASnd.hxx"
 #include "Sound.hxx"
+#include "AudioRecorder.hxx"
 
 /**
   This class implements the sound API for SDL.
@@ -135,6 +136,44 @@ class SoundSDL : public Sound
     */
     void adjustVolume(Int8 direction);
 
+    /**
+      Sets the quality of the resampling from the TIA sound to the output
+      frequency, taking effect immediately.
+
+      @param quality  The quality, as in the 'resampling' setting
+    */
+    void setResampling(const string& quality);
+
+    /**
+      Turns on or off adjusting the rate at which sound is generated to
+      keep the amount of queued sound steady, taking effect immediately.
+
+      @param enable  Either true or false, as in the 'ratecontrol' setting
+    */
+    void setRateControl(bool enable);
+
+    /**
+      Answers the number of sound register writes dropped since the last
+      reset, because the register write queue was full.
+
+      @return  The number of dropped register writes
+    */
+    uInt32 droppedWrites() const { return myDroppedWrites; }
+
+    /**
+      Answers how the sound output is keeping up with the emulation.
+
+      @param latency    Receives the time (in ms) until a register write
+                        made now is heard
+      @param fill       Receives how full the register write queue is, as a
+                        percentage of its target level
+      @param underruns  Receives the number of times the queue ran out
+                        since the last reset
+
+      @return  False if no sound is being output (and nothing is returned)
+    */
+    bool queueStats(uInt32& latency, uInt32& fill, uInt32& underruns) const;
+
   public:
     /**
       Saves the current state of this device to the given Serializer.
@@ -170,28 +209,38 @@ class SoundSDL : public Sound
     */
     void processFragment(Int16* stream, uInt32 length);
 
+    /**
+      Reset the TIA sound emulation and empty the register write queue,
+      while the sound callback is paused.
+    */
+    void clearRegWrites();
+
   protected:
     // Struct to hold information regarding a TIA sound register write
     struct RegWrite
     {
       uInt16 addr;
       uInt8 value;
-      double delta;
+      uInt32 delta;  // CPU cycles since the previous write
     };
 
     /**
-      A queue class used to hold TIA sound register writes before being
-      processed while creating a sound fragment.
+      A fixed-size queue used to hold TIA sound register writes before
+      being processed while creating a sound fragment.  Writes are only
+      ever enqueued by the emulation and dequeued by the sound callback,
+      so no locking is needed: each side only updates its own index, and
+      memory barriers make sure an item is complete before the consumer
+      sees it, and read before the producer may overwrite it.
     */
     class RegWriteQueue
     {
       public:
         /**
-          Create a new queue instance with the specified initial
-          capacity.  If the queue ever reaches its capacity then it will
-          automatically increase its size.
+          Create a new queue instance with (at least) the specified
+          capacity.  Once the queue is full, nothing more can be
+          enqueued until items are dequeued.
         */
-        RegWriteQueue(uInt32 capacity = 512);
+        RegWriteQueue(uInt32 capacity = 8192);
 
         /**
           Destroy this queue instance.
@@ -200,55 +249,69 @@ class SoundSDL : public Sound
 
       public:
         /**
-          Clear any items stored in the queue.
+          Clear any items stored in the queue.  Neither the producer nor
+          the consumer may be using the queue at the time.
         */
         void clear();
 
         /**
-          Dequeue the first object in the queue.
+          Dequeue the first object in the queue (consumer only).
         */
         void dequeue();
 
         /**
-          Return the duration of all the items in the queue.
+          Return the duration of all the items in the queue, in CPU
+          cycles (consumer only).
         */
-        double duration();
+        uInt64 duration() const;
 
         /**
-          Enqueue the specified object.
+          Enqueue the specified object (producer only).
+
+          @return  False if the queue is full, and the object was dropped
         */
-        void enqueue(const RegWrite& info);
+        bool enqueue(const RegWrite& info);
 
         /**
-          Return the item at the front on the queue.
+          Return the item at the front on the queue (consumer only).
 
           @return  The item at the front of the queue.
         */
         RegWrite& front();
 
         /**
-          Answers the number of items currently in the queue.
+          Answers the number of items currently in the queue.  The consumer
+          may access that many items from the front afterwards.
 
           @return  The number of items in the queue.
         */
         uInt32 size() const;
 
-      private:
-        // Increase the size of the queue
-        void grow();
+        /**
+          Answers the number of items the queue can hold.
+        */
+        uInt32 capacity() const { return myCapacity; }
 
       private:
+        // The capacity, which is a power of two, and the mask for
+        // turning an index into a position in the buffer
         uInt32 myCapacity;
+        uInt32 myMask;
         RegWrite* myBuffer;
-        uInt32 mySize;
-        uInt32 myHead;
-        uInt32 myTail;
+
+        // The indices of the next item to dequeue and the next one to
+        // enqueue; these wrap around, with their difference being the size
+        volatile uInt32 myHead;
+        volatile uInt32 myTail;
     };
 
   private:
     // TIASound emulation object
     TIASound myTIASound;
 
+    // Records the samples played, if asked to
+    AudioRecorder myRecorder;
+
     // Indicates if the sound subsystem is to be initialized
     bool myIsEnabled;
 
@@ -258,6 +321,18 @@ class SoundSDL : public Sound
     // Indicates the cycle when a sound register was last set
     Int32 myLastRegisterSetCycle;
 
+    // The time (in seconds) already played of the write at the front
+    // of the queue; only used by the sound callback
+    double myFrontPlayed;
+
+    // The most recent value written to each TIA sound register, which
+    // are all queued again once a write had to be dropped
+    uInt8 myRegisters[6];
+    bool myResyncRegisters;
+
+    // The number of register writes dropped because the queue was full
+    uInt32 myDroppedWrites;
+
     // Indicates the number of channels (mono or stereo)
     uInt32 myNumChannels;
 
@@ -270,6 +345,21 @@ class SoundSDL : public Sound
     // These are pre-computed to speed up the callback as much as possible
     double myFragmentSizeLogDiv1, myFragmentSizeLogDiv2;
 
+    // Whether the rate the queue is played at is adjusted slightly, to keep
+    // it at its target level (the time of a fragment and a frame), instead
+    // of only removing writes once it has grown much too long
+    bool myRateControl;
+    double myTargetQueued;
+
+    // The time (in seconds) of sound in the queue, averaged over recent
+    // fragments, and the learned difference in speed between the emulation
+    // and the sound device; only used by the sound callback
+    double myAverageQueued;
+    double myRateDrift;
+
+    // Statistics on the queue, as given by queueStats()
+    uInt32 myLatency, myFill, myUnderruns;
+
     // Indicates if the sound is currently muted
     bool myIsMuted;
 
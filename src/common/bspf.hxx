@@ -98,6 +98,19 @@ using namespace std;
   #define BSPF_ARCH "NOARCH"
 #endif
 
+// Memory barrier, for data passed between threads without a lock; the
+// compiler and CPU may not move memory accesses across it
+#if defined(__GNUC__)
+  #define BSPF_memoryBarrier() __sync_synchronize()
+#elif defined(_MSC_VER)
+  // x86 doesn't reorder stores with stores or loads with loads, so only
+  // the compiler has to be kept in line
+  #include <intrin.h>
+  #define BSPF_memoryBarrier() _ReadWriteBarrier()
+#else
+  #error Update src/common/bspf.hxx for memory barriers
+#endif
+
 // I wish Windows had a complete POSIX layer
 #if defined BSPF_WIN32 && !defined __GNUG__
   #define BSPF_snprintf _snprintf
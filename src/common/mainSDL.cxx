@@ -166,7 +166,15 @@ int main(int argc, char* argv[])
   // If not, use the built-in ROM launcher.  In this case, we enter 'launcher'
   //   mode and let the main event loop take care of opening a new console/ROM.
   FilesystemNode romnode(romfile);
-  if(romfile == "" || romnode.isDirectory())
+  if(theOSystem->settings().getBool("headless") &&
+     (romfile == "" || romnode.isDirectory() ||
+      theOSystem->settings().getInt("frames") <= 0))
+  {
+    theOSystem->logMessage("ERROR: Headless mode requires a ROM file "
+                           "and '-frames <number>'", 0);
+    return Cleanup();
+  }
+  else if(romfile == "" || romnode.isDirectory())
   {
     theOSystem->logMessage("Attempting to use ROM launcher ...", 2);
     bool launcherOpened = romfile != "" ?
@@ -4,6 +4,8 @@ MODULE_OBJS := \
 	src/common/mainSDL.o \
 	src/common/Base.o \
 	src/common/SoundSDL.o \
+	src/common/SoundHeadless.o \
+	src/common/AudioRecorder.o \
 	src/common/FrameBufferSoft.o \
 	src/common/FrameBufferGL.o \
 	src/common/FBSurfaceGL.o \
@@ -1229,6 +1229,24 @@ string CartDebug::saveRom()
     return DebuggerParser::red("failed to save ROM");
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string CartDebug::saveARMProfile()
+{
+  const string& path = "~" BSPF_PATH_SEPARATOR +
+    myConsole.properties().get(Cartridge_Name) + ".armprof";
+
+  ostringstream profile;
+  if(!myConsole.cartridge().saveARMProfile(profile))
+    return DebuggerParser::red("ARM profiling not enabled (see -thumb.profile)");
+
+  FilesystemNode node(path);
+  ofstream out(node.getPath().c_str());
+  if(out.is_open() && out << profile.str())
+    return "saved ARM profile as " + node.getShortPath();
+  else
+    return DebuggerParser::red("failed to save ARM profile");
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string CartDebug::listConfig(int bank)
 {
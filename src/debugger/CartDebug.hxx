@@ -249,10 +249,11 @@ class CartDebug : public DebuggerSystem
     string saveConfigFile();
 
     /**
-      Save disassembly and ROM file
+      Save disassembly, ROM file and ARM profile
     */
     string saveDisassembly();
     string saveRom();
+    string saveARMProfile();
 
     /**
       Show Distella directives (both set by the user and determined by Distella)
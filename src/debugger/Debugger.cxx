@@ -512,7 +512,12 @@ bool Debugger::setBank(int bank)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Debugger::patchROM(int addr, int value)
 {
-  return myConsole.cartridge().patch(addr, value);
+  bool patched = myConsole.cartridge().patch(addr, value);
+
+  // The processor may have decoded the old contents
+  mySystem.m6502().flushDecodedInstructions();
+
+  return patched;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -533,6 +538,10 @@ void Debugger::setStartState()
   // Lock the bus each time the debugger is entered, so we don't disturb anything
   lockBankswitchState();
 
+  // From now on, record access types for the disassembler
+  myConsole.cartridge().enableCodeAccess();
+  mySystem.setAccessTracking(true);
+
   // Start a new rewind list
   myRewindManager->clear();
 
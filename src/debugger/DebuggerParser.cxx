@@ -1411,6 +1411,13 @@ void DebuggerParser::executeSavedisassembly()
   commandResult << debugger.cartDebug().saveDisassembly();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "saveprof"
+void DebuggerParser::executeSaveprofile()
+{
+  commandResult << debugger.cartDebug().saveARMProfile();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "saverom"
 void DebuggerParser::executeSaverom()
@@ -2072,6 +2079,15 @@ DebuggerParser::Command DebuggerParser::commands[kNumCommands] = {
     &DebuggerParser::executeSavedisassembly
   },
 
+  {
+    "saveprof",
+    "Save profile of ARM code (DPC+)",
+    false,
+    false,
+    { kARG_END_ARGS },
+    &DebuggerParser::executeSaveprofile
+  },
+
   {
     "saverom",
     "Save (possibly patched) ROM",
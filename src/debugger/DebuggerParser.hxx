@@ -72,7 +72,7 @@ class DebuggerParser
 
   private:
     enum {
-      kNumCommands   = 70,
+      kNumCommands   = 71,
       kMAX_ARG_TYPES = 10
     };
 
@@ -177,6 +177,7 @@ class DebuggerParser
     void executeSave();
     void executeSaveconfig();
     void executeSavedisassembly();
+    void executeSaveprofile();
     void executeSaverom();
     void executeSaveses();
     void executeSavestate();
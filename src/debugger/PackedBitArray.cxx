@@ -22,7 +22,8 @@
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 PackedBitArray::PackedBitArray(uInt32 length)
-  : words(length / wordSize + 1)
+  : words(length / wordSize + 1),
+    count(0)
 {
   bits = new uInt32[ words ];
 
@@ -61,6 +62,8 @@ void PackedBitArray::toggle(uInt32 bit)
   bit %= wordSize;
 
   bits[word] ^= (1 << bit);
+  if(bits[word] & (1 << bit))  ++count;
+  else                         --count;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -69,7 +72,11 @@ void PackedBitArray::set(uInt32 bit)
   uInt32 word = bit / wordSize;
   bit %= wordSize;
 
-  bits[word] |= (1 << bit);
+  if(!(bits[word] & (1 << bit)))
+  {
+    bits[word] |= (1 << bit);
+    ++count;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -78,5 +85,9 @@ void PackedBitArray::clear(uInt32 bit)
   uInt32 word = bit / wordSize;
   bit %= wordSize;
 
-  bits[word] &= (~(1 << bit));
+  if(bits[word] & (1 << bit))
+  {
+    bits[word] &= (~(1 << bit));
+    --count;
+  }
 }
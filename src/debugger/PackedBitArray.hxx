@@ -37,12 +37,18 @@ class PackedBitArray
     void clear(uInt32 bit);
     void toggle(uInt32 bit);
 
+    // answers whether no bits at all are currently set
+    bool isEmpty() const { return count == 0; }
+
   private:
     // number of unsigned ints (size/wordSize):
     uInt32 words;
 
     // the array itself:
     uInt32* bits;
+
+    // number of bits currently set:
+    uInt32 count;
 };
 
 #endif
@@ -60,17 +60,21 @@
 #include "CartX07.hxx"
 #include "MD5.hxx"
 #include "Props.hxx"
+#include "Serializer.hxx"
 #include "Settings.hxx"
+#include "SignatureSearch.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
   #include "CartDebug.hxx"
 #endif
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Cartridge* Cartridge::create(const uInt8* image, uInt32 size, string& md5,
-     string& dtype, string& id, const OSystem& osystem, Settings& settings)
+Cartridge* Cartridge::create(const Common::SharedPtr<uInt8>& rom, uInt32 size,
+     string& md5, string& dtype, string& id, const OSystem& osystem,
+     Settings& settings)
 {
   Cartridge* cartridge = 0;
+  const uInt8* image = rom.get();
   string type = dtype;
 
   // Collect some info about the ROM
@@ -176,6 +180,10 @@ Cartridge* Cartridge::create(const uInt8* image, uInt32 size, string& md5,
       dtype = "WRONG_SIZE";
   }
 
+  // Carts using the image in place must share the part of it they're
+  // given (for multicarts, the image doesn't start at the array)
+  Common::SharedPtr<uInt8> shared(rom, const_cast<uInt8*>(image));
+
   // We should know the cart's type by now so let's create it
   if(type == "0840")
     cartridge = new Cartridge0840(image, size, settings);
@@ -196,31 +204,31 @@ Cartridge* Cartridge::create(const uInt8* image, uInt32 size, string& md5,
   else if(type == "CM")
     cartridge = new CartridgeCM(image, size, settings);
   else if(type == "CTY")
-    cartridge = new CartridgeCTY(image, size, osystem);
+    cartridge = new CartridgeCTY(shared, size, osystem);
   else if(type == "CV")
     cartridge = new CartridgeCV(image, size, settings);
   else if(type == "DPC")
     cartridge = new CartridgeDPC(image, size, settings);
   else if(type == "DPC+")
-    cartridge = new CartridgeDPCPlus(image, size, settings);
+    cartridge = new CartridgeDPCPlus(shared, size, settings);
   else if(type == "E0")
     cartridge = new CartridgeE0(image, size, settings);
   else if(type == "E7")
     cartridge = new CartridgeE7(image, size, settings);
   else if(type == "EF")
-    cartridge = new CartridgeEF(image, size, settings);
+    cartridge = new CartridgeEF(shared, size, settings);
   else if(type == "EFSC")
-    cartridge = new CartridgeEFSC(image, size, settings);
+    cartridge = new CartridgeEFSC(shared, size, settings);
   else if(type == "BF")
-    cartridge = new CartridgeBF(image, size, settings);
+    cartridge = new CartridgeBF(shared, size, settings);
   else if(type == "BFSC")
-    cartridge = new CartridgeBFSC(image, size, settings);
+    cartridge = new CartridgeBFSC(shared, size, settings);
   else if(type == "DF")
-    cartridge = new CartridgeDF(image, size, settings);
+    cartridge = new CartridgeDF(shared, size, settings);
   else if(type == "DFSC")
-    cartridge = new CartridgeDFSC(image, size, settings);
+    cartridge = new CartridgeDFSC(shared, size, settings);
   else if(type == "F0" || type == "MB")
-    cartridge = new CartridgeF0(image, size, settings);
+    cartridge = new CartridgeF0(shared, size, settings);
   else if(type == "F4")
     cartridge = new CartridgeF4(image, size, settings);
   else if(type == "F4SC")
@@ -246,7 +254,7 @@ Cartridge* Cartridge::create(const uInt8* image, uInt32 size, string& md5,
   else if(type == "SB")
     cartridge = new CartridgeSB(image, size, settings);
   else if(type == "X07")
-    cartridge = new CartridgeX07(image, size, settings);
+    cartridge = new CartridgeX07(shared, size, settings);
   else if(dtype == "WRONG_SIZE")
   {
     string err = "Invalid cart size for type '" + type + "'";
@@ -297,6 +305,12 @@ Cartridge::Cartridge(const Settings& settings)
     myStartBank(0),
     myBankChanged(true),
     myCodeAccessBase(NULL),
+    myCodeAccessSize(0),
+    myBankPageAccess(NULL),
+    myBankPages(0),
+    myBankPageTables(0),
+    myCodeAccessMissing(false),
+    mySharedImageSize(0),
     myBankLocked(false)
 {
 }
@@ -304,8 +318,8 @@ Cartridge::Cartridge(const Settings& settings)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Cartridge::~Cartridge()
 {
-  if(myCodeAccessBase)
-    delete[] myCodeAccessBase;
+  delete[] myCodeAccessBase;
+  delete[] myBankPageAccess;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -366,20 +380,120 @@ void Cartridge::triggerReadFromWritePort(uInt16 address)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge::createCodeAccessBase(uInt32 size)
 {
-#ifdef DEBUGGER_SUPPORT
-  myCodeAccessBase = new uInt8[size];
-  memset(myCodeAccessBase, CartDebug::ROW, size);
-#else
   myCodeAccessBase = NULL;
+#ifdef DEBUGGER_SUPPORT
+  myCodeAccessSize = size;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::enableCodeAccess()
+{
+#ifdef DEBUGGER_SUPPORT
+  if(myCodeAccessBase || myCodeAccessSize == 0)
+    return;
+
+  myCodeAccessBase = new uInt8[myCodeAccessSize];
+  memset(myCodeAccessBase, CartDebug::ROW, myCodeAccessSize);
+
+  // Installing the cart also switches to its startup bank (and resets
+  // other banking state), so its state is saved and restored around it
+  if(myCodeAccessMissing && mySystem)
+  {
+    Serializer state;
+    if(state.isValid() && save(state))
+    {
+      bool locked = myBankLocked;
+      myBankLocked = false;
+      myCodeAccessMissing = false;
+      install(*mySystem);
+      state.reset();
+      load(state);
+      myBankLocked = locked;
+    }
+  }
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::createBankPageAccess(uInt16 banks, uInt16 pages)
+{
+  delete[] myBankPageAccess;
+  myBankPageAccess = new System::PageAccess[banks * pages];
+  myBankPages = pages;
+  myBankPageTables = banks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* Cartridge::shareImage(const Common::SharedPtr<uInt8>& image,
+                             uInt32 imagesize, uInt32 size)
+{
+  if(imagesize >= size)
+    mySharedImage = image;
+  else
+  {
+    uInt8* copy = new uInt8[size];
+    memcpy(copy, image.get(), imagesize);
+    memset(copy + imagesize, 0, size - imagesize);
+    mySharedImage = Common::SharedPtr<uInt8>(copy, Common::ArrayDeleter<uInt8>());
+  }
+  mySharedImageSize = size;
+
+  return mySharedImage.get();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::unshareImage(uInt8*& image)
+{
+  if(mySharedImage.unique())
+    return;
+
+  uInt8* from = mySharedImage.get();
+  uInt8* copy = new uInt8[mySharedImageSize];
+  memcpy(copy, from, mySharedImageSize);
+
+  rebasePageAccess(&System::PageAccess::directPeekBase,
+                   from, mySharedImageSize, copy);
+
+  image = copy + (image - from);
+  mySharedImage = Common::SharedPtr<uInt8>(copy, Common::ArrayDeleter<uInt8>());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::rebasePageAccess(uInt8* System::PageAccess::*field,
+                                 const uInt8* from, uInt32 size, uInt8* to)
+{
+  for(uInt32 i = 0; i < (uInt32)myBankPageTables * myBankPages; ++i)
+  {
+    uInt8*& base = myBankPageAccess[i].*field;
+    if(base >= from && base < from + size)
+      base = to + (base - from);
+  }
+  if(mySystem)
+  {
+    for(uInt16 page = 0; page < mySystem->numberOfPages(); ++page)
+    {
+      System::PageAccess access = mySystem->getPageAccess(page);
+      uInt8*& base = access.*field;
+      if(base >= from && base < from + size)
+      {
+        base = to + (base - from);
+        mySystem->setPageAccess(page, access);
+      }
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Cartridge::autodetectType(const uInt8* image, uInt32 size)
 {
   // Guess type based on size
   const char* type = 0;
 
+  // Most detectors look for byte signatures; these are all counted at once
+  uInt32 hits[Sig_NumSignatures];
+  countSignatures(image, size, hits);
+
   if((size % 8448) == 0 || size == 6144)
   {
     type = "AR";
@@ -391,11 +505,11 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   else if((size == 2048) ||
           (size == 4096 && memcmp(image, image + 2048, 2048) == 0))
   {
-    type = isProbablyCV(image, size) ? "CV" : "2K";
+    type = isProbablyCV(hits) ? "CV" : "2K";
   }
   else if(size == 4096)
   {
-    if(isProbablyCV(image,size))
+    if(isProbablyCV(hits))
       type = "CV";
     else if(isProbably4KSC(image,size))
       type = "4KSC";
@@ -405,24 +519,23 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   else if(size == 8*1024)  // 8K
   {
     // First check for *potential* F8
-    uInt8 signature[] = { 0x8D, 0xF9, 0x1F };  // STA $1FF9
-    bool f8 = searchForBytes(image, size, signature, 3, 2);
+    bool f8 = hits[Sig_STA_1FF9] >= 2;  // STA $1FF9
 
     if(isProbablySC(image, size))
       type = "F8SC";
     else if(memcmp(image, image + 4096, 4096) == 0)
       type = "4K";
-    else if(isProbablyE0(image, size))
+    else if(isProbablyE0(hits))
       type = "E0";
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = "3E";
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = "3F";
-    else if(isProbablyUA(image, size))
+    else if(isProbablyUA(hits))
       type = "UA";
-    else if(isProbablyFE(image, size) && !f8)
+    else if(isProbablyFE(hits) && !f8)
       type = "FE";
-    else if(isProbably0840(image, size))
+    else if(isProbably0840(hits))
       type = "0840";
     else
       type = "F8";
@@ -439,12 +552,12 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   {
     if(isProbablySC(image, size))
       type = "F6SC";
-    else if(isProbablyE7(image, size))
+    else if(isProbablyE7(hits))
       type = "E7";
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = "3E";
   /* no known 16K 3F ROMS
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = "3F";
   */
     else
@@ -458,18 +571,18 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   {
     if(isProbablyARM(image, size))
       type = "FA2";
-    else /*if(isProbablyDPCplus(image, size))*/
+    else /*if(isProbablyDPCplus(hits))*/
       type = "DPC+";
   }
   else if(size == 32*1024)  // 32K
   {
     if(isProbablySC(image, size))
       type = "F4SC";
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = "3E";
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = "3F";
-    else if(isProbablyDPCplus(image, size))
+    else if(isProbablyDPCplus(hits))
       type = "DPC+";
     else if(isProbablyCTY(image, size))
       type = "CTY";
@@ -480,50 +593,50 @@ string Cartridge::autodetectType(const uInt8* image, uInt32 size)
   }
   else if(size == 64*1024)  // 64K
   {
-    if(isProbably3E(image, size))
+    if(isProbably3E(hits))
       type = "3E";
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = "3F";
     else if(isProbably4A50(image, size))
       type = "4A50";
-    else if(isProbablyEF(image, size, type))
+    else if(isProbablyEF(image, size, hits, type))
       ; // type has been set directly in the function
-    else if(isProbablyX07(image, size))
+    else if(isProbablyX07(hits))
       type = "X07";
     else
       type = "F0";
   }
   else if(size == 128*1024)  // 128K
   {
-    if(isProbably3E(image, size))
+    if(isProbably3E(hits))
       type = "3E";
     else if(isProbablyDF(image, size, type))
       ; // type has been set directly in the function
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = "3F";
     else if(isProbably4A50(image, size))
       type = "4A50";
-    else if(isProbablySB(image, size))
+    else if(isProbablySB(hits))
       type = "SB";
     else
       type = "MC";
   }
   else if(size == 256*1024)  // 256K
   {
-    if(isProbably3E(image, size))
+    if(isProbably3E(hits))
       type = "3E";
     else if(isProbablyBF(image, size, type))
       ; // type has been set directly in the function
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = "3F";
-    else /*if(isProbablySB(image, size))*/
+    else /*if(isProbablySB(hits))*/
       type = "SB";
   }
   else  // what else can we do?
   {
-    if(isProbably3E(image, size))
+    if(isProbably3E(hits))
       type = "3E";
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = "3F";
     else
       type = "4K";  // Most common bankswitching type
@@ -560,6 +673,59 @@ bool Cartridge::searchForBytes(const uInt8* image, uInt32 imagesize,
   return (count >= minhits);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::countSignatures(const uInt8* image, uInt32 size, uInt32* hits)
+{
+  // The signatures, in the order of the Signature enumeration
+  static const SignatureSearch::Signature signatures[Sig_NumSignatures] = {
+    { { 0x8D, 0xF9, 0x1F }, 3 },              // STA $1FF9
+    { { 0xAD, 0x00, 0x08 }, 3 },              // LDA $0800
+    { { 0xAD, 0x40, 0x08 }, 3 },              // LDA $0840
+    { { 0x2C, 0x00, 0x08 }, 3 },              // BIT $0800
+    { { 0x0C, 0x00, 0x08, 0x4C }, 4 },        // NOP $0800; JMP ...
+    { { 0x0C, 0xFF, 0x0F, 0x4C }, 4 },        // NOP $0FFF; JMP ...
+    { { 0x85, 0x3E, 0xA9, 0x00 }, 4 },        // STA $3E; LDA #$00
+    { { 0x85, 0x3F }, 2 },                    // STA $3F
+    { { 0x9D, 0xFF, 0xF3 }, 3 },              // STA $F3FF.X
+    { { 0x99, 0x00, 0xF4 }, 3 },              // STA $F400.Y
+    { { 'D', 'P', 'C', '+' }, 4 },            // DPC+
+    { { 0x8D, 0xE0, 0x1F }, 3 },              // STA $1FE0
+    { { 0x8D, 0xE0, 0x5F }, 3 },              // STA $5FE0
+    { { 0x8D, 0xE9, 0xFF }, 3 },              // STA $FFE9
+    { { 0x0C, 0xE0, 0x1F }, 3 },              // NOP $1FE0
+    { { 0xAD, 0xE0, 0x1F }, 3 },              // LDA $1FE0
+    { { 0xAD, 0xE9, 0xFF }, 3 },              // LDA $FFE9
+    { { 0xAD, 0xED, 0xFF }, 3 },              // LDA $FFED
+    { { 0xAD, 0xF3, 0xBF }, 3 },              // LDA $BFF3
+    { { 0xAD, 0xE2, 0xFF }, 3 },              // LDA $FFE2
+    { { 0xAD, 0xE5, 0xFF }, 3 },              // LDA $FFE5
+    { { 0xAD, 0xE5, 0x1F }, 3 },              // LDA $1FE5
+    { { 0xAD, 0xE7, 0x1F }, 3 },              // LDA $1FE7
+    { { 0x0C, 0xE7, 0x1F }, 3 },              // NOP $1FE7
+    { { 0x8D, 0xE7, 0xFF }, 3 },              // STA $FFE7
+    { { 0x8D, 0xE7, 0x1F }, 3 },              // STA $1FE7
+    { { 0x0C, 0xE0, 0xFF }, 3 },              // NOP $FFE0
+    { { 0xAD, 0xE0, 0xFF }, 3 },              // LDA $FFE0
+    { { 0x20, 0x00, 0xD0, 0xC6, 0xC5 }, 5 },  // JSR $D000; DEC $C5
+    { { 0x20, 0xC3, 0xF8, 0xA5, 0x82 }, 5 },  // JSR $F8C3; LDA $82
+    { { 0xD0, 0xFB, 0x20, 0x73, 0xFE }, 5 },  // BNE $FB; JSR $FE73
+    { { 0x20, 0x00, 0xF0, 0x84, 0xD6 }, 5 },  // JSR $F000; STY $D6
+    { { 0xBD, 0x00, 0x08 }, 3 },              // LDA $0800,x
+    { { 0x8D, 0x40, 0x02 }, 3 },              // STA $240
+    { { 0xAD, 0x40, 0x02 }, 3 },              // LDA $240
+    { { 0xBD, 0x1F, 0x02 }, 3 },              // LDA $21F,X
+    { { 0xAD, 0x0D, 0x08 }, 3 },              // LDA $080D
+    { { 0xAD, 0x1D, 0x08 }, 3 },              // LDA $081D
+    { { 0xAD, 0x2D, 0x08 }, 3 },              // LDA $082D
+    { { 0x0C, 0x0D, 0x08 }, 3 },              // NOP $080D
+    { { 0x0C, 0x1D, 0x08 }, 3 },              // NOP $081D
+    { { 0x0C, 0x2D, 0x08 }, 3 }               // NOP $082D
+  };
+  static const SignatureSearch search(signatures, Sig_NumSignatures);
+
+  search.search(image, size, hits);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge::isProbablySC(const uInt8* image, uInt32 size)
 {
@@ -612,49 +778,34 @@ bool Cartridge::isProbablyARM(const uInt8* image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbably0840(const uInt8* image, uInt32 size)
+bool Cartridge::isProbably0840(const uInt32* hits)
 {
   // 0840 cart bankswitching is triggered by accessing addresses 0x0800
   // or 0x0840 at least twice
-  uInt8 signature1[3][3] = {
-    { 0xAD, 0x00, 0x08 },  // LDA $0800
-    { 0xAD, 0x40, 0x08 },  // LDA $0840
-    { 0x2C, 0x00, 0x08 }   // BIT $0800
-  };
-  for(uInt32 i = 0; i < 3; ++i)
-    if(searchForBytes(image, size, signature1[i], 3, 2))
-      return true;
-
-  uInt8 signature2[2][4] = {
-    { 0x0C, 0x00, 0x08, 0x4C },  // NOP $0800; JMP ...
-    { 0x0C, 0xFF, 0x0F, 0x4C }   // NOP $0FFF; JMP ...
-  };
-  for(uInt32 i = 0; i < 2; ++i)
-    if(searchForBytes(image, size, signature2[i], 4, 2))
-      return true;
-
-  return false;
+  return hits[Sig_LDA_0800] >= 2 ||      // LDA $0800
+         hits[Sig_LDA_0840] >= 2 ||      // LDA $0840
+         hits[Sig_BIT_0800] >= 2 ||      // BIT $0800
+         hits[Sig_NOP_0800_JMP] >= 2 ||  // NOP $0800; JMP ...
+         hits[Sig_NOP_0FFF_JMP] >= 2;    // NOP $0FFF; JMP ...
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbably3E(const uInt8* image, uInt32 size)
+bool Cartridge::isProbably3E(const uInt32* hits)
 {
   // 3E cart bankswitching is triggered by storing the bank number
   // in address 3E using 'STA $3E', commonly followed by an
   // immediate mode LDA
-  uInt8 signature[] = { 0x85, 0x3E, 0xA9, 0x00 };  // STA $3E; LDA #$00
-  return searchForBytes(image, size, signature, 4, 1);
+  return hits[Sig_STA_3E_LDA_00] >= 1;  // STA $3E; LDA #$00
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbably3F(const uInt8* image, uInt32 size)
+bool Cartridge::isProbably3F(const uInt32* hits)
 {
   // 3F cart bankswitching is triggered by storing the bank number
   // in address 3F using 'STA $3F'
   // We expect it will be present at least 2 times, since there are
   // at least two banks
-  uInt8 signature[] = { 0x85, 0x3F };  // STA $3F
-  return searchForBytes(image, size, signature, 2, 2);
+  return hits[Sig_STA_3F] >= 2;  // STA $3F
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -682,30 +833,23 @@ bool Cartridge::isProbablyCTY(const uInt8* image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyCV(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyCV(const uInt32* hits)
 {
   // CV RAM access occurs at addresses $f3ff and $f400
   // These signatures are attributed to the MESS project
-  uInt8 signature[2][3] = {
-    { 0x9D, 0xFF, 0xF3 },  // STA $F3FF.X
-    { 0x99, 0x00, 0xF4 }   // STA $F400.Y
-  };
-  if(searchForBytes(image, size, signature[0], 3, 1))
-    return true;
-  else
-    return searchForBytes(image, size, signature[1], 3, 1);
+  return hits[Sig_STA_F3FF_X] >= 1 ||  // STA $F3FF.X
+         hits[Sig_STA_F400_Y] >= 1;    // STA $F400.Y
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyDPCplus(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyDPCplus(const uInt32* hits)
 {
   // DPC+ ARM code has 2 occurrences of the string DPC+
-  uInt8 signature[] = { 'D', 'P', 'C', '+' };
-  return searchForBytes(image, size, signature, 4, 2);
+  return hits[Sig_DPCplus] >= 2;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyE0(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyE0(const uInt32* hits)
 {
   // E0 cart bankswitching is triggered by accessing addresses
   // $FE0 to $FF9 using absolute non-indexed addressing
@@ -713,25 +857,25 @@ bool Cartridge::isProbablyE0(const uInt8* image, uInt32 size)
   // search for only certain known signatures
   // Thanks to "stella@casperkitty.com" for this advice
   // These signatures are attributed to the MESS project
-  uInt8 signature[8][3] = {
-   { 0x8D, 0xE0, 0x1F },  // STA $1FE0
-   { 0x8D, 0xE0, 0x5F },  // STA $5FE0
-   { 0x8D, 0xE9, 0xFF },  // STA $FFE9
-   { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-   { 0xAD, 0xE0, 0x1F },  // LDA $1FE0
-   { 0xAD, 0xE9, 0xFF },  // LDA $FFE9
-   { 0xAD, 0xED, 0xFF },  // LDA $FFED
-   { 0xAD, 0xF3, 0xBF }   // LDA $BFF3
+  static const Signature signature[8] = {
+    Sig_STA_1FE0,  // STA $1FE0
+    Sig_STA_5FE0,  // STA $5FE0
+    Sig_STA_FFE9,  // STA $FFE9
+    Sig_NOP_1FE0,  // NOP $1FE0
+    Sig_LDA_1FE0,  // LDA $1FE0
+    Sig_LDA_FFE9,  // LDA $FFE9
+    Sig_LDA_FFED,  // LDA $FFED
+    Sig_LDA_BFF3   // LDA $BFF3
   };
   for(uInt32 i = 0; i < 8; ++i)
-    if(searchForBytes(image, size, signature[i], 3, 1))
+    if(hits[signature[i]] >= 1)
       return true;
 
   return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyE7(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyE7(const uInt32* hits)
 {
   // E7 cart bankswitching is triggered by accessing addresses
   // $FE0 to $FE6 using absolute non-indexed addressing
@@ -739,24 +883,25 @@ bool Cartridge::isProbablyE7(const uInt8* image, uInt32 size)
   // search for only certain known signatures
   // Thanks to "stella@casperkitty.com" for this advice
   // These signatures are attributed to the MESS project
-  uInt8 signature[7][3] = {
-   { 0xAD, 0xE2, 0xFF },  // LDA $FFE2
-   { 0xAD, 0xE5, 0xFF },  // LDA $FFE5
-   { 0xAD, 0xE5, 0x1F },  // LDA $1FE5
-   { 0xAD, 0xE7, 0x1F },  // LDA $1FE7
-   { 0x0C, 0xE7, 0x1F },  // NOP $1FE7
-   { 0x8D, 0xE7, 0xFF },  // STA $FFE7
-   { 0x8D, 0xE7, 0x1F }   // STA $1FE7
+  static const Signature signature[7] = {
+    Sig_LDA_FFE2,  // LDA $FFE2
+    Sig_LDA_FFE5,  // LDA $FFE5
+    Sig_LDA_1FE5,  // LDA $1FE5
+    Sig_LDA_1FE7,  // LDA $1FE7
+    Sig_NOP_1FE7,  // NOP $1FE7
+    Sig_STA_FFE7,  // STA $FFE7
+    Sig_STA_1FE7   // STA $1FE7
   };
   for(uInt32 i = 0; i < 7; ++i)
-    if(searchForBytes(image, size, signature[i], 3, 1))
+    if(hits[signature[i]] >= 1)
       return true;
 
   return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyEF(const uInt8* image, uInt32 size, const char*& type)
+bool Cartridge::isProbablyEF(const uInt8* image, uInt32 size,
+                             const uInt32* hits, const char*& type)
 {
   // Newer EF carts store strings 'EFEF' and 'EFSC' starting at address $FFF8
   // This signature is attributed to "RevEng" of AtariAge
@@ -776,21 +921,10 @@ bool Cartridge::isProbablyEF(const uInt8* image, uInt32 size, const char*& type)
   // Otherwise, EF cart bankswitching switches banks by accessing addresses
   // 0xFE0 to 0xFEF, usually with either a NOP or LDA
   // It's likely that the code will switch to bank 0, so that's what is tested
-  bool isEF = false;
-  uInt8 signature[4][3] = {
-    { 0x0C, 0xE0, 0xFF },  // NOP $FFE0
-    { 0xAD, 0xE0, 0xFF },  // LDA $FFE0
-    { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-    { 0xAD, 0xE0, 0x1F }   // LDA $1FE0
-  };
-  for(uInt32 i = 0; i < 4; ++i)
-  {
-    if(searchForBytes(image, size, signature[i], 3, 1))
-    {
-      isEF = true;
-      break;
-    }
-  }
+  bool isEF = hits[Sig_NOP_FFE0] >= 1 ||  // NOP $FFE0
+              hits[Sig_LDA_FFE0] >= 1 ||  // LDA $FFE0
+              hits[Sig_NOP_1FE0] >= 1 ||  // NOP $1FE0
+              hits[Sig_LDA_1FE0] >= 1;    // LDA $1FE0
 
   // Now that we know that the ROM is EF, we need to check if it's
   // the SC variant
@@ -863,69 +997,49 @@ bool Cartridge::isProbablyFA2(const uInt8* image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyFE(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyFE(const uInt32* hits)
 {
   // FE bankswitching is very weird, but always seems to include a
   // 'JSR $xxxx'
   // These signatures are attributed to the MESS project
-  uInt8 signature[4][5] = {
-    { 0x20, 0x00, 0xD0, 0xC6, 0xC5 },  // JSR $D000; DEC $C5
-    { 0x20, 0xC3, 0xF8, 0xA5, 0x82 },  // JSR $F8C3; LDA $82
-    { 0xD0, 0xFB, 0x20, 0x73, 0xFE },  // BNE $FB; JSR $FE73
-    { 0x20, 0x00, 0xF0, 0x84, 0xD6 }   // JSR $F000; STY $D6
-  };
-  for(uInt32 i = 0; i < 4; ++i)
-    if(searchForBytes(image, size, signature[i], 5, 1))
-      return true;
-
-  return false;
+  return hits[Sig_JSR_D000_DEC_C5] >= 1 ||  // JSR $D000; DEC $C5
+         hits[Sig_JSR_F8C3_LDA_82] >= 1 ||  // JSR $F8C3; LDA $82
+         hits[Sig_BNE_JSR_FE73] >= 1 ||     // BNE $FB; JSR $FE73
+         hits[Sig_JSR_F000_STY_D6] >= 1;    // JSR $F000; STY $D6
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablySB(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablySB(const uInt32* hits)
 {
   // SB cart bankswitching switches banks by accessing address 0x0800
-  uInt8 signature[2][3] = {
-    { 0xBD, 0x00, 0x08 },  // LDA $0800,x
-    { 0xAD, 0x00, 0x08 }   // LDA $0800
-  };
-  if(searchForBytes(image, size, signature[0], 3, 1))
-    return true;
-  else
-    return searchForBytes(image, size, signature[1], 3, 1);
+  return hits[Sig_LDA_0800_X] >= 1 ||  // LDA $0800,x
+         hits[Sig_LDA_0800] >= 1;      // LDA $0800
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyUA(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyUA(const uInt32* hits)
 {
   // UA cart bankswitching switches to bank 1 by accessing address 0x240
   // using 'STA $240' or 'LDA $240'
-  uInt8 signature[3][3] = {
-    { 0x8D, 0x40, 0x02 },  // STA $240
-    { 0xAD, 0x40, 0x02 },  // LDA $240
-    { 0xBD, 0x1F, 0x02 }   // LDA $21F,X
-  };
-  for(uInt32 i = 0; i < 3; ++i)
-    if(searchForBytes(image, size, signature[i], 3, 1))
-      return true;
-
-  return false;
+  return hits[Sig_STA_0240] >= 1 ||   // STA $240
+         hits[Sig_LDA_0240] >= 1 ||   // LDA $240
+         hits[Sig_LDA_021F_X] >= 1;   // LDA $21F,X
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Cartridge::isProbablyX07(const uInt8* image, uInt32 size)
+bool Cartridge::isProbablyX07(const uInt32* hits)
 {
   // X07 bankswitching switches to bank 0, 1, 2, etc by accessing address 0x08xd
-  uInt8 signature[6][3] = {
-    { 0xAD, 0x0D, 0x08 },  // LDA $080D
-    { 0xAD, 0x1D, 0x08 },  // LDA $081D
-    { 0xAD, 0x2D, 0x08 },  // LDA $082D
-    { 0x0C, 0x0D, 0x08 },  // NOP $080D
-    { 0x0C, 0x1D, 0x08 },  // NOP $081D
-    { 0x0C, 0x2D, 0x08 }   // NOP $082D
+  static const Signature signature[6] = {
+    Sig_LDA_080D,  // LDA $080D
+    Sig_LDA_081D,  // LDA $081D
+    Sig_LDA_082D,  // LDA $082D
+    Sig_NOP_080D,  // NOP $080D
+    Sig_NOP_081D,  // NOP $081D
+    Sig_NOP_082D   // NOP $082D
   };
   for(uInt32 i = 0; i < 6; ++i)
-    if(searchForBytes(image, size, signature[i], 3, 1))
+    if(hits[signature[i]] >= 1)
       return true;
 
   return false;
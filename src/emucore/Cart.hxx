@@ -30,7 +30,9 @@ class GuiObject;
 
 #include "bspf.hxx"
 #include "Array.hxx"
+#include "SharedPtr.hxx"
 #include "Device.hxx"
+#include "System.hxx"
 #include "Settings.hxx"
 #include "Font.hxx"
 
@@ -39,6 +41,11 @@ struct RamArea {
 };
 typedef Common::Array<RamArea> RamAreaList;
 
+// The DPC music OSC runs at 20 kHz and the 6507 at 3579575 / 3 Hz, so
+// DPC_OSC_CYCLES CPU cycles make exactly DPC_OSC_CLOCKS music clocks
+#define DPC_OSC_CLOCKS 2400
+#define DPC_OSC_CYCLES 143183
+
 /**
   A cartridge is a device which contains the machine code for a 
   game and handles any bankswitching performed by the cartridge.
@@ -55,7 +62,8 @@ class Cartridge : public Device
       Create a new cartridge object allocated on the heap.  The
       type of cartridge created depends on the properties object.
 
-      @param image    A pointer to the ROM image
+      @param image    The ROM image; carts for large images keep using it
+                      directly instead of copying it
       @param size     The size of the ROM image 
       @param md5      The md5sum for the given ROM image (can be updated)
       @param dtype    The detected bankswitch type of the ROM image
@@ -65,10 +73,20 @@ class Cartridge : public Device
       @param settings The settings associated with the system
       @return   Pointer to the new cartridge object allocated on the heap
     */
-    static Cartridge* create(const uInt8* image, uInt32 size, string& md5,
+    static Cartridge* create(const Common::SharedPtr<uInt8>& image,
+                             uInt32 size, string& md5,
                              string& dtype, string& id,
                              const OSystem& system, Settings& settings);
 
+    /**
+      Try to auto-detect the bankswitching type of the cartridge
+
+      @param image  A pointer to the ROM image
+      @param size   The size of the ROM image 
+      @return The "best guess" for the cartridge type
+    */
+    static string autodetectType(const uInt8* image, uInt32 size);
+
     /**
       Create a new cartridge
 
@@ -124,6 +142,17 @@ class Cartridge : public Device
 
     const RamAreaList& ramAreas() { return myRamAreaList; }
 
+    /**
+      Allocate the code-access array (see createCodeAccessBase), if that
+      hasn't been done yet, and point all page access methods at it.
+      The debugger calls this when it starts recording access types;
+      until then no memory is set aside for the array.  Since the page
+      access methods are made by install(), the cart is installed again
+      if any of them were made without the array, with its state saved
+      beforehand and loaded back afterwards.
+    */
+    void enableCodeAccess();
+
   public:
     //////////////////////////////////////////////////////////////////////
     // The following methods are cart-specific and must be implemented
@@ -202,6 +231,16 @@ class Cartridge : public Device
     */
     virtual void setRomName(const string& name) { }
 
+    /**
+      Write the profile of any ARM code run by the cart to the given
+      stream.  Only carts with an ARM processor can be profiled, and then
+      only when profiling was enabled (the 'thumb.profile' setting).
+
+      @param out  The stream to write the profile to
+      @return  False if the cart has no profile to write, else true
+    */
+    virtual bool saveARMProfile(ostream& out) const { return false; }
+
     /**
       Get debugger widget responsible for accessing the inner workings
       of the cart.  This will need to be overridden and implemented by
@@ -232,13 +271,146 @@ class Cartridge : public Device
     /**
       Create an array that holds code-access information for every byte
       of the ROM (indicated by 'size').  Note that this is only used by
-      the debugger, and is unavailable otherwise.
+      the debugger, and is unavailable otherwise.  The array itself isn't
+      allocated until enableCodeAccess() is called; before that,
+      myCodeAccessBase is null.
 
       @param size  The size of the code-access array to create
     */
     void createCodeAccessBase(uInt32 size);
 
+    /**
+      Get the code-access location for the given offset into the ROM, to
+      be used for the page access methods.  This is null while the
+      code-access array isn't allocated.
+
+      @param offset  The offset into the code-access array
+    */
+    uInt8* codeAccess(uInt32 offset)
+    {
+      if(myCodeAccessBase)
+        return myCodeAccessBase + offset;
+
+      myCodeAccessMissing = true;
+      return 0;
+    }
+
+    /**
+      Create storage for the precomputed page access tables of each bank
+      (or segment).  The cart fills in these tables once when it's
+      installed, so that a bankswitch only has to copy the appropriate
+      table into the system, instead of rebuilding it page by page.
+
+      @param banks  The number of tables to create
+      @param pages  The number of pages described by each table
+    */
+    void createBankPageAccess(uInt16 banks, uInt16 pages);
+
+    /**
+      Get the precomputed page access table for the given bank.
+
+      @param bank  The bank (or segment) to get the table for
+    */
+    System::PageAccess* bankPageAccess(uInt16 bank) const
+      { return myBankPageAccess + bank * myBankPages; }
+
+    /**
+      Install the precomputed page access table for the given bank into
+      the system, starting at the page containing the given address.
+
+      @param bank     The bank (or segment) to install
+      @param address  The address of the first page the table describes
+    */
+    void installBankPageAccess(uInt16 bank, uInt16 address)
+    {
+      mySystem->setPageAccess(address >> mySystem->pageShift(), myBankPages,
+                              bankPageAccess(bank));
+    }
+
+    /**
+      Use the given ROM image in place, instead of copying it.  The cart
+      keeps a reference to the image for as long as it exists.  If the
+      image is smaller than the cart expects, a copy padded with zeroes
+      is used instead.
+
+      @param image      The ROM image passed to the cart
+      @param imagesize  The size of the ROM image
+      @param size       The size of the image the cart uses
+      @return  A pointer to the image to use
+    */
+    uInt8* shareImage(const Common::SharedPtr<uInt8>& image, uInt32 imagesize,
+                      uInt32 size);
+
+    /**
+      Make sure the image from shareImage() can be modified without
+      affecting anyone else using it, by copying it if it's still shared.
+      All page accesses pointing into the old image are moved to the
+      copy.  Carts call this before patching their image.
+
+      @param image  The cart's pointer to the image (updated if copied)
+    */
+    void unshareImage(uInt8*& image);
+
   private:
+    /**
+      Move the given page access pointers (such as directPeekBase)
+      that point into the block 'from' of the given size
+      to the same offset in 'to', both in the precomputed bank tables and
+      in the pages currently installed in the system.
+    */
+    void rebasePageAccess(uInt8* System::PageAccess::*field,
+                          const uInt8* from, uInt32 size, uInt8* to);
+
+    /**
+      The byte signatures looked for during autodetection; see
+      countSignatures() below
+    */
+    enum Signature {
+      Sig_STA_1FF9,         // F8
+      Sig_LDA_0800,         // 0840 and SB
+      Sig_LDA_0840,         // 0840
+      Sig_BIT_0800,
+      Sig_NOP_0800_JMP,
+      Sig_NOP_0FFF_JMP,
+      Sig_STA_3E_LDA_00,    // 3E
+      Sig_STA_3F,           // 3F
+      Sig_STA_F3FF_X,       // CV
+      Sig_STA_F400_Y,
+      Sig_DPCplus,          // DPC+
+      Sig_STA_1FE0,         // E0
+      Sig_STA_5FE0,
+      Sig_STA_FFE9,
+      Sig_NOP_1FE0,         // E0 and EF
+      Sig_LDA_1FE0,
+      Sig_LDA_FFE9,         // E0
+      Sig_LDA_FFED,
+      Sig_LDA_BFF3,
+      Sig_LDA_FFE2,         // E7
+      Sig_LDA_FFE5,
+      Sig_LDA_1FE5,
+      Sig_LDA_1FE7,
+      Sig_NOP_1FE7,
+      Sig_STA_FFE7,
+      Sig_STA_1FE7,
+      Sig_NOP_FFE0,         // EF
+      Sig_LDA_FFE0,
+      Sig_JSR_D000_DEC_C5,  // FE
+      Sig_JSR_F8C3_LDA_82,
+      Sig_BNE_JSR_FE73,
+      Sig_JSR_F000_STY_D6,
+      Sig_LDA_0800_X,       // SB
+      Sig_STA_0240,         // UA
+      Sig_LDA_0240,
+      Sig_LDA_021F_X,
+      Sig_LDA_080D,         // X07
+      Sig_LDA_081D,
+      Sig_LDA_082D,
+      Sig_NOP_080D,
+      Sig_NOP_081D,
+      Sig_NOP_082D,
+      Sig_NumSignatures
+    };
+
     /**
       Get an image pointer and size for a ROM that is part of a larger,
       multi-ROM image.
@@ -254,15 +426,6 @@ class Cartridge : public Device
     static string createFromMultiCart(const uInt8*& image, uInt32& size,
         uInt32 numroms, string& md5, string& id, Settings& settings);
 
-    /**
-      Try to auto-detect the bankswitching type of the cartridge
-
-      @param image  A pointer to the ROM image
-      @param size   The size of the ROM image 
-      @return The "best guess" for the cartridge type
-    */
-    static string autodetectType(const uInt8* image, uInt32 size);
-
     /**
       Search the image for the specified byte signature
 
@@ -278,6 +441,16 @@ class Cartridge : public Device
                                const uInt8* signature, uInt32 sigsize,
                                uInt32 minhits);
 
+    /**
+      Count the hits of all autodetection signatures in a single pass over
+      the image, as searchForBytes would count each of them
+
+      @param image  A pointer to the ROM image
+      @param size   The size of the ROM image
+      @param hits   Receives the hits, indexed by Signature
+    */
+    static void countSignatures(const uInt8* image, uInt32 size, uInt32* hits);
+
     /**
       Returns true if the image is probably a SuperChip (256 bytes RAM)
     */
@@ -296,17 +469,17 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably a 0840 bankswitching cartridge
     */
-    static bool isProbably0840(const uInt8* image, uInt32 size);
+    static bool isProbably0840(const uInt32* hits);
 
     /**
       Returns true if the image is probably a 3E bankswitching cartridge
     */
-    static bool isProbably3E(const uInt8* image, uInt32 size);
+    static bool isProbably3E(const uInt32* hits);
 
     /**
       Returns true if the image is probably a 3F bankswitching cartridge
     */
-    static bool isProbably3F(const uInt8* image, uInt32 size);
+    static bool isProbably3F(const uInt32* hits);
 
     /**
       Returns true if the image is probably a 4A50 bankswitching cartridge
@@ -321,27 +494,28 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably a CV bankswitching cartridge
     */
-    static bool isProbablyCV(const uInt8* image, uInt32 size);
+    static bool isProbablyCV(const uInt32* hits);
 
     /**
       Returns true if the image is probably a DPC+ bankswitching cartridge
     */
-    static bool isProbablyDPCplus(const uInt8* image, uInt32 size);
+    static bool isProbablyDPCplus(const uInt32* hits);
 
     /**
       Returns true if the image is probably a E0 bankswitching cartridge
     */
-    static bool isProbablyE0(const uInt8* image, uInt32 size);
+    static bool isProbablyE0(const uInt32* hits);
 
     /**
       Returns true if the image is probably a E7 bankswitching cartridge
     */
-    static bool isProbablyE7(const uInt8* image, uInt32 size);
+    static bool isProbablyE7(const uInt32* hits);
 
     /**
       Returns true if the image is probably an EF/EFSC bankswitching cartridge
     */
-    static bool isProbablyEF(const uInt8* image, uInt32 size, const char*& type);
+    static bool isProbablyEF(const uInt8* image, uInt32 size,
+                             const uInt32* hits, const char*& type);
 
     /**
       Returns true if the image is probably a BF/BFSC bankswitching cartridge
@@ -365,22 +539,22 @@ class Cartridge : public Device
     /**
       Returns true if the image is probably an FE bankswitching cartridge
     */
-    static bool isProbablyFE(const uInt8* image, uInt32 size);
+    static bool isProbablyFE(const uInt32* hits);
 
     /**
       Returns true if the image is probably a SB bankswitching cartridge
     */
-    static bool isProbablySB(const uInt8* image, uInt32 size);
+    static bool isProbablySB(const uInt32* hits);
 
     /**
       Returns true if the image is probably a UA bankswitching cartridge
     */
-    static bool isProbablyUA(const uInt8* image, uInt32 size);
+    static bool isProbablyUA(const uInt32* hits);
 
     /**
       Returns true if the image is probably an X07 bankswitching cartridge
     */
-    static bool isProbablyX07(const uInt8* image, uInt32 size);
+    static bool isProbablyX07(const uInt32* hits);
 
   protected:
     // Settings class for the application
@@ -393,13 +567,28 @@ class Cartridge : public Device
     bool myBankChanged;
 
     // The array containing information about every byte of ROM indicating
-    // whether it is used as code.
+    // whether it is used as code (see createCodeAccessBase), and its size
     uInt8* myCodeAccessBase;
+    uInt32 myCodeAccessSize;
 
   private:
     // Contains RamArea entries for those carts with accessible RAM.
     RamAreaList myRamAreaList;
 
+    // Precomputed page access tables for each bank, the number of
+    // pages described by each table and the number of tables
+    System::PageAccess* myBankPageAccess;
+    uInt16 myBankPages;
+    uInt16 myBankPageTables;
+
+    // Indicates if page access methods were made by codeAccess() while
+    // the code-access array wasn't allocated
+    bool myCodeAccessMissing;
+
+    // The ROM image used in place (see shareImage), and its size
+    Common::SharedPtr<uInt8> mySharedImage;
+    uInt32 mySharedImageSize;
+
     // If myBankLocked is true, ignore attempts at bankswitching. This is used
     // by the debugger, when disassembling/dumping ROM.
     bool myBankLocked;
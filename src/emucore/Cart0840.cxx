@@ -74,6 +74,21 @@ void Cartridge0840::install(System& system)
   for(uInt32 i = 0x0800; i < 0x0FFF; i += (1 << shift))
     mySystem->setPageAccess(i >> shift, access);
 
+  // Precompute the page access methods for each bank
+  createBankPageAccess(bankCount(), (0x2000 - 0x1000) >> shift);
+  for(uInt16 b = 0; b < bankCount(); ++b)
+  {
+    uInt32 offset = b << 12;
+    System::PageAccess* table = bankPageAccess(b);
+
+    // Map ROM image into the system
+    for(uInt32 address = 0x1000; address < 0x2000; address += (1 << shift))
+      table[(address & 0x0FFF) >> shift] =
+        System::PageAccess(&myImage[offset + (address & 0x0FFF)], 0,
+                           codeAccess(offset + (address & 0x0FFF)),
+                           this, System::PA_READ);
+  }
+
   // Install pages for bank 0
   bank(myStartBank);
 }
@@ -150,19 +165,9 @@ bool Cartridge0840::bank(uInt16 bank)
 
   // Remember what bank we're in
   myCurrentBank = bank;
-  uInt16 offset = myCurrentBank << 12;
-  uInt16 shift = mySystem->pageShift();
 
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
-
-  // Map ROM image into the system
-  for(uInt32 address = 0x1000; address < 0x2000; address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
+  // Install the precomputed page access methods for this bank
+  installBankPageAccess(myCurrentBank, 0x1000);
   return myBankChanged = true;
 }
 
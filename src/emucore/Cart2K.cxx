@@ -82,7 +82,7 @@ void Cartridge2K::install(System& system)
   for(uInt32 address = 0x1000; address < 0x2000; address += (1 << shift))
   {
     access.directPeekBase = &myImage[address & myMask];
-    access.codeAccessBase = &myCodeAccessBase[address & myMask];
+    access.codeAccessBase = codeAccess(address & myMask);
     mySystem->setPageAccess(address >> shift, access);
   }
 }
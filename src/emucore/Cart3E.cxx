@@ -90,10 +90,45 @@ void Cartridge3E::install(System& system)
   for(uInt32 j = 0x1800; j < 0x2000; j += (1 << shift))
   {
     access.directPeekBase = &myImage[(mySize - 2048) + (j & 0x07FF)];
-    access.codeAccessBase = &myCodeAccessBase[(mySize - 2048) + (j & 0x07FF)];
+    access.codeAccessBase = codeAccess((mySize - 2048) + (j & 0x07FF));
     mySystem->setPageAccess(j >> shift, access);
   }
 
+  // Precompute the page access methods for the first segment; the ROM
+  // banks (including a partial last bank) come first, followed by the
+  // 32 banks of RAM
+  uInt16 romBanks = (mySize + 0x07FF) >> 11;
+  createBankPageAccess(romBanks + 32, 0x0800 >> shift);
+  for(uInt16 b = 0; b < romBanks; ++b)
+  {
+    uInt32 offset = b << 11;
+    System::PageAccess* table = bankPageAccess(b);
+
+    // Map ROM image into the system
+    for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
+      table[(address & 0x07FF) >> shift] =
+        System::PageAccess(&myImage[offset + (address & 0x07FF)], 0,
+                           codeAccess(offset + (address & 0x07FF)),
+                           this, System::PA_READ);
+  }
+  for(uInt16 b = 0; b < 32; ++b)
+  {
+    uInt32 offset = b << 10;
+    System::PageAccess* table = bankPageAccess(romBanks + b);
+
+    // Map read-port and write-port RAM image into the system
+    for(uInt32 address = 0x1000; address < 0x1400; address += (1 << shift))
+    {
+      uInt8* ram = &myRAM[offset + (address & 0x03FF)];
+      uInt8* code = codeAccess(mySize + offset + (address & 0x03FF));
+
+      table[(address & 0x03FF) >> shift] =
+        System::PageAccess(ram, 0, code, this, System::PA_READ);
+      table[(0x0400 + (address & 0x03FF)) >> shift] =
+        System::PageAccess(0, ram, code, this, System::PA_WRITE);
+    }
+  }
+
   // Install pages for the startup bank into the first segment
   bank(myStartBank);
 }
@@ -176,20 +211,9 @@ bool Cartridge3E::bank(uInt16 bank)
       // around to a valid bank number
       myCurrentBank = bank % (mySize >> 11);
     }
-  
-    uInt32 offset = myCurrentBank << 11;
-    uInt16 shift = mySystem->pageShift();
-  
-    // Setup the page access methods for the current bank
-    System::PageAccess access(0, 0, 0, this, System::PA_READ);
 
-    // Map ROM image into the system
-    for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
-    {
-      access.directPeekBase = &myImage[offset + (address & 0x07FF)];
-      access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
-      mySystem->setPageAccess(address >> shift, access);
-    }
+    // Install the precomputed page access methods for this bank
+    installBankPageAccess(myCurrentBank, 0x1000);
   }
   else
   {
@@ -197,31 +221,8 @@ bool Cartridge3E::bank(uInt16 bank)
     bank %= 32;
     myCurrentBank = bank + 256;
 
-    uInt32 offset = bank << 10;
-    uInt16 shift = mySystem->pageShift();
-    uInt32 address;
-  
-    // Setup the page access methods for the current bank
-    System::PageAccess access(0, 0, 0, this, System::PA_READ);
-
-    // Map read-port RAM image into the system
-    for(address = 0x1000; address < 0x1400; address += (1 << shift))
-    {
-      access.directPeekBase = &myRAM[offset + (address & 0x03FF)];
-      access.codeAccessBase = &myCodeAccessBase[mySize + offset + (address & 0x03FF)];
-      mySystem->setPageAccess(address >> shift, access);
-    }
-
-    access.directPeekBase = 0;
-    access.type = System::PA_WRITE;
-
-    // Map write-port RAM image into the system
-    for(address = 0x1400; address < 0x1800; address += (1 << shift))
-    {
-      access.directPokeBase = &myRAM[offset + (address & 0x03FF)];
-      access.codeAccessBase = &myCodeAccessBase[mySize + offset + (address & 0x03FF)];
-      mySystem->setPageAccess(address >> shift, access);
-    }
+    // Install the precomputed page access methods for this RAM bank
+    installBankPageAccess(((mySize + 0x07FF) >> 11) + bank, 0x1000);
   }
   return myBankChanged = true;
 }
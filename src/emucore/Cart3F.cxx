@@ -78,10 +78,27 @@ void Cartridge3F::install(System& system)
   for(uInt32 j = 0x1800; j < 0x2000; j += (1 << shift))
   {
     access.directPeekBase = &myImage[(mySize - 2048) + (j & 0x07FF)];
-    access.codeAccessBase = &myCodeAccessBase[(mySize - 2048) + (j & 0x07FF)];
+    access.codeAccessBase = codeAccess((mySize - 2048) + (j & 0x07FF));
     mySystem->setPageAccess(j >> shift, access);
   }
 
+  // Precompute the page access methods for each bank (including a
+  // partial last bank, which bank() also accepts)
+  uInt16 banks = (mySize + 0x07FF) >> 11;
+  createBankPageAccess(banks, (0x1800 - 0x1000) >> shift);
+  for(uInt16 b = 0; b < banks; ++b)
+  {
+    uInt32 offset = b << 11;
+    System::PageAccess* table = bankPageAccess(b);
+
+    // Map ROM image into the system
+    for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
+      table[(address & 0x07FF) >> shift] =
+        System::PageAccess(&myImage[offset + (address & 0x07FF)], 0,
+                           codeAccess(offset + (address & 0x07FF)),
+                           this, System::PA_READ);
+  }
+
   // Install pages for startup bank into the first segment
   bank(myStartBank);
 }
@@ -138,19 +155,8 @@ bool Cartridge3F::bank(uInt16 bank)
     myCurrentBank = bank % (mySize >> 11);
   }
 
-  uInt32 offset = myCurrentBank << 11;
-  uInt16 shift = mySystem->pageShift();
-
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
-
-  // Map ROM image into the system
-  for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x07FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
+  // Install the precomputed page access methods for this bank
+  installBankPageAccess(myCurrentBank, 0x1000);
   return myBankChanged = true;
 }
 
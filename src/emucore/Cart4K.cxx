@@ -59,7 +59,7 @@ void Cartridge4K::install(System& system)
   for(uInt32 address = 0x1000; address < 0x2000; address += (1 << shift))
   {
     access.directPeekBase = &myImage[address & 0x0FFF];
-    access.codeAccessBase = &myCodeAccessBase[address & 0x0FFF];
+    access.codeAccessBase = codeAccess(address & 0x0FFF);
     mySystem->setPageAccess(address >> mySystem->pageShift(), access);
   }
 }
@@ -24,11 +24,12 @@
 #include "CartBF.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeBF::CartridgeBF(const uInt8* image, uInt32 size, const Settings& settings)
+CartridgeBF::CartridgeBF(const Common::SharedPtr<uInt8>& image,
+                         uInt32 size, const Settings& settings)
   : Cartridge(settings)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(262144u, size));
+  // Use the ROM image in place, rather than copying it
+  myImage = shareImage(image, size, 262144);
   createCodeAccessBase(262144);
 
   // Remember startup bank
@@ -51,9 +52,42 @@ void CartridgeBF::reset()
 void CartridgeBF::install(System& system)
 {
   mySystem = &system;
+  uInt16 shift = mySystem->pageShift();
+  uInt16 mask = mySystem->pageMask();
 
   // Make sure the system we're being installed in has a page size that'll work
-  assert((0x1000 & mySystem->pageMask()) == 0);
+  assert((0x1000 & mask) == 0);
+
+  System::PageAccess access(0, 0, 0, this, System::PA_READ);
+
+  // Precompute the page access methods for each bank
+  createBankPageAccess(bankCount(), (0x2000 - 0x1000) >> shift);
+  for(uInt16 b = 0; b < bankCount(); ++b)
+  {
+    uInt32 offset = b << 12;
+    System::PageAccess* table = bankPageAccess(b);
+
+    // Set the page accessing methods for the hot spots; only the hot
+    // spots themselves are handled by peek(), while the rest of their
+    // pages are accessed directly
+    for(uInt32 i = (0x1F80 & ~mask); i < 0x2000; i += (1 << shift))
+    {
+      access.directPeekBase = &myImage[offset + (i & 0x0FFF)];
+      access.codeAccessBase = codeAccess(offset + (i & 0x0FFF));
+      access.hotspots = mySystem->hotspotMask(i, 0x1F80, 0x1FBF);
+      table[(i - 0x1000) >> shift] = access;
+    }
+    access.hotspots = 0;
+
+    // Setup the page access methods for the bank
+    for(uInt32 address = 0x1000; address < (0x1F80U & ~mask);
+        address += (1 << shift))
+    {
+      access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
+      access.codeAccessBase = codeAccess(offset + (address & 0x0FFF));
+      table[(address - 0x1000) >> shift] = access;
+    }
+  }
 
   // Install pages for the startup bank
   bank(myStartBank);
@@ -90,27 +124,9 @@ bool CartridgeBF::bank(uInt16 bank)
 
   // Remember what bank we're in
   myCurrentBank = bank;
-  uInt32 offset = myCurrentBank << 12;
-  uInt16 shift = mySystem->pageShift();
-  uInt16 mask = mySystem->pageMask();
-
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
-
-  // Set the page accessing methods for the hot spots
-  for(uInt32 i = (0x1F80 & ~mask); i < 0x2000; i += (1 << shift))
-  {
-    access.codeAccessBase = &myCodeAccessBase[offset + (i & 0x0FFF)];
-    mySystem->setPageAccess(i >> shift, access);
-  }
 
-  // Setup the page access methods for the current bank
-  for(uInt32 address = 0x1000; address < (0x1F80U & ~mask);
-      address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
+  // Install the precomputed page access methods for this bank
+  installBankPageAccess(myCurrentBank, 0x1000);
   return myBankChanged = true;
 }
 
@@ -129,6 +145,7 @@ uInt16 CartridgeBF::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeBF::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
   myImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 } 
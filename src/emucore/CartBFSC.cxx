@@ -24,11 +24,12 @@
 #include "CartBFSC.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeBFSC::CartridgeBFSC(const uInt8* image, uInt32 size, const Settings& settings)
+CartridgeBFSC::CartridgeBFSC(const Common::SharedPtr<uInt8>& image,
+                             uInt32 size, const Settings& settings)
   : Cartridge(settings)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(262144u, size));
+  // Use the ROM image in place, rather than copying it
+  myImage = shareImage(image, size, 262144);
   createCodeAccessBase(262144);
 
   // This cart contains 128 bytes extended RAM @ 0x1000
@@ -74,7 +75,7 @@ void CartridgeBFSC::install(System& system)
   for(uInt32 j = 0x1000; j < 0x1080; j += (1 << shift))
   {
     access.directPokeBase = &myRAM[j & 0x007F];
-    access.codeAccessBase = &myCodeAccessBase[j & 0x007F];
+    access.codeAccessBase = codeAccess(j & 0x007F);
     mySystem->setPageAccess(j >> shift, access);
   }
  
@@ -84,10 +85,39 @@ void CartridgeBFSC::install(System& system)
   for(uInt32 k = 0x1080; k < 0x1100; k += (1 << shift))
   {
     access.directPeekBase = &myRAM[k & 0x007F];
-    access.codeAccessBase = &myCodeAccessBase[0x80 + (k & 0x007F)];
+    access.codeAccessBase = codeAccess(0x80 + (k & 0x007F));
     mySystem->setPageAccess(k >> shift, access);
   }
 
+  // Precompute the page access methods for each bank
+  createBankPageAccess(bankCount(), (0x2000 - 0x1100) >> shift);
+  for(uInt16 b = 0; b < bankCount(); ++b)
+  {
+    uInt32 offset = b << 12;
+    System::PageAccess* table = bankPageAccess(b);
+
+    // Set the page accessing methods for the hot spots; only the hot
+    // spots themselves are handled by peek(), while the rest of their
+    // pages are accessed directly
+    for(uInt32 i = (0x1F80 & ~mask); i < 0x2000; i += (1 << shift))
+    {
+      access.directPeekBase = &myImage[offset + (i & 0x0FFF)];
+      access.codeAccessBase = codeAccess(offset + (i & 0x0FFF));
+      access.hotspots = mySystem->hotspotMask(i, 0x1F80, 0x1FBF);
+      table[(i - 0x1100) >> shift] = access;
+    }
+    access.hotspots = 0;
+
+    // Setup the page access methods for the bank
+    for(uInt32 address = 0x1100; address < (0x1F80U & ~mask);
+        address += (1 << shift))
+    {
+      access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
+      access.codeAccessBase = codeAccess(offset + (address & 0x0FFF));
+      table[(address - 0x1100) >> shift] = access;
+    }
+  }
+
   // Install pages for the startup bank
   bank(myStartBank);
 }
@@ -141,27 +171,9 @@ bool CartridgeBFSC::bank(uInt16 bank)
 
   // Remember what bank we're in
   myCurrentBank = bank;
-  uInt32 offset = myCurrentBank << 12;
-  uInt16 shift = mySystem->pageShift();
-  uInt16 mask = mySystem->pageMask();
-
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
-
-  // Set the page accessing methods for the hot spots
-  for(uInt32 i = (0x1F80 & ~mask); i < 0x2000; i += (1 << shift))
-  {
-    access.codeAccessBase = &myCodeAccessBase[offset + (i & 0x0FFF)];
-    mySystem->setPageAccess(i >> shift, access);
-  }
 
-  // Setup the page access methods for the current bank
-  for(uInt32 address = 0x1100; address < (0x1F80U & ~mask);
-      address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
+  // Install the precomputed page access methods for this bank
+  installBankPageAccess(myCurrentBank, 0x1100);
   return myBankChanged = true;
 }
 
@@ -190,7 +202,10 @@ bool CartridgeBFSC::patch(uInt16 address, uInt8 value)
     myRAM[address & 0x007F] = value;
   }
   else
+  {
+    unshareImage(myImage);
     myImage[(myCurrentBank << 12) + address] = value;
+  }
 
   return myBankChanged = true;
 } 
@@ -131,7 +131,7 @@ bool CartridgeCM::bank(uInt16 bank)
   for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
   {
     access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
+    access.codeAccessBase = codeAccess(offset + (address & 0x0FFF));
     mySystem->setPageAccess(address >> shift, access);
   }
 
@@ -143,12 +143,12 @@ bool CartridgeCM::bank(uInt16 bank)
     if(mySWCHA & 0x10)
     {
       access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
-      access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
+      access.codeAccessBase = codeAccess(offset + (address & 0x0FFF));
     }
     else
     {
       access.directPeekBase = &myRAM[address & 0x7FF];
-      access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
+      access.codeAccessBase = codeAccess(offset + (address & 0x07FF));
     }
 
     if((mySWCHA & 0x30) == 0x20)
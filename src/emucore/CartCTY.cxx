@@ -27,7 +27,8 @@
 #include "CartCTY.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeCTY::CartridgeCTY(const uInt8* image, uInt32 size, const OSystem& osystem)
+CartridgeCTY::CartridgeCTY(const Common::SharedPtr<uInt8>& image,
+                           uInt32 size, const OSystem& osystem)
   : Cartridge(osystem.settings()),
     myOSystem(osystem),
     myOperationType(0),
@@ -36,10 +37,10 @@ CartridgeCTY::CartridgeCTY(const uInt8* image, uInt32 size, const OSystem& osyst
     myRandomNumber(0x2B435044),
     myRamAccessTimeout(0),
     mySystemCycles(0),
-    myFractionalClocks(0.0)
+    myFractionalClocks(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(32768u, size));
+  // Use the ROM image in place, rather than copying it
+  myImage = shareImage(image, size, 32768);
   createCodeAccessBase(32768);
 
   // This cart contains 64 bytes extended RAM @ 0x1000
@@ -71,7 +72,7 @@ void CartridgeCTY::reset()
 
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myFractionalClocks = 0;
 
   // Upon reset we switch to the startup bank
   bank(myStartBank);
@@ -261,7 +262,7 @@ bool CartridgeCTY::bank(uInt16 bank)
   System::PageAccess access(0, 0, 0, this, System::PA_READ);
   for(uInt32 address = 0x1080; address < 0x2000; address += (1 << shift))
   {
-    access.codeAccessBase = &myCodeAccessBase[myCurrentBank + (address & 0x0FFF)];
+    access.codeAccessBase = codeAccess(myCurrentBank + (address & 0x0FFF));
     mySystem->setPageAccess(address >> shift, access);
   }
   return myBankChanged = true;
@@ -292,7 +293,10 @@ bool CartridgeCTY::patch(uInt16 address, uInt8 value)
     myRAM[address & 0x003F] = value;
   }
   else
+  {
+    unshareImage(myImage);
     myImage[myCurrentBank + address] = value;
+  }
 
   return myBankChanged = true;
 } 
@@ -318,7 +322,8 @@ bool CartridgeCTY::save(Serializer& out) const
     out.putBool(myLDAimmediate);
     out.putInt(myRandomNumber);
     out.putInt(mySystemCycles);
-    out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+    out.putInt((uInt32)((uInt64)myFractionalClocks * 100000000 /
+                        DPC_OSC_CYCLES));
 
   }
   catch(...)
@@ -347,7 +352,8 @@ bool CartridgeCTY::load(Serializer& in)
     myLDAimmediate = in.getBool();
     myRandomNumber = in.getInt();
     mySystemCycles = (Int32)in.getInt();
-    myFractionalClocks = (double)in.getInt() / 100000000.0;
+    myFractionalClocks = (uInt32)((uInt64)in.getInt() * DPC_OSC_CYCLES /
+                                  100000000);
   }
   catch(...)
   {
@@ -538,9 +544,9 @@ inline void CartridgeCTY::updateMusicModeDataFetchers()
   mySystemCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = (Int32)clocks;
-  myFractionalClocks = clocks - (double)wholeClocks;
+  uInt64 clocks = (uInt64)cycles * DPC_OSC_CLOCKS + myFractionalClocks;
+  Int32 wholeClocks = (Int32)(clocks / DPC_OSC_CYCLES);
+  myFractionalClocks = (uInt32)(clocks % DPC_OSC_CYCLES);
 
   if(wholeClocks <= 0)
     return;
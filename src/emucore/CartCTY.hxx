@@ -118,11 +118,12 @@ class CartridgeCTY : public Cartridge
     /**
       Create a new cartridge using the specified image
 
-      @param image     Pointer to the ROM image
+      @param image     The ROM image (used in place, not copied)
       @param size      The size of the ROM image
       @param osystem   A reference to the OSystem currently in use
     */
-    CartridgeCTY(const uInt8* image, uInt32 size, const OSystem& osystem);
+    CartridgeCTY(const Common::SharedPtr<uInt8>& image, uInt32 size,
+                 const OSystem& osystem);
  
     /**
       Destructor
@@ -275,8 +276,8 @@ class CartridgeCTY : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
-    // The 32K ROM image of the cartridge
-    uInt8 myImage[32768];
+    // The 32K ROM image of the cartridge (see Cartridge::shareImage)
+    uInt8* myImage;
 
     // The 64 bytes of RAM accessible at $1000 - $1080
     uInt8 myRAM[64];
@@ -310,8 +311,9 @@ class CartridgeCTY : public Cartridge
     // System cycle count when the last update to music data fetchers occurred
     Int32 mySystemCycles;
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    // Fractional DPC music OSC clocks unused during the last update,
+    // in units of 1/DPC_OSC_CYCLES of a clock
+    uInt32 myFractionalClocks;
 };
 
 #endif
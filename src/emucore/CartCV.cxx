@@ -96,7 +96,7 @@ void CartridgeCV::install(System& system)
   for(uInt32 address = 0x1800; address < 0x2000; address += (1 << shift))
   {
     access.directPeekBase = &myImage[address & 0x07FF];
-    access.codeAccessBase = &myCodeAccessBase[address & 0x07FF];
+    access.codeAccessBase = codeAccess(address & 0x07FF);
     mySystem->setPageAccess(address >> mySystem->pageShift(), access);
   }
 
@@ -116,7 +116,7 @@ void CartridgeCV::install(System& system)
   for(uInt32 k = 0x1000; k < 0x1400; k += (1 << shift))
   {
     access.directPeekBase = &myRAM[k & 0x03FF];
-    access.codeAccessBase = &myCodeAccessBase[2048 + (k & 0x03FF)];
+    access.codeAccessBase = codeAccess(2048 + (k & 0x03FF));
     mySystem->setPageAccess(k >> shift, access);
   }
 }
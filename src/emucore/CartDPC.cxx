@@ -29,7 +29,7 @@ CartridgeDPC::CartridgeDPC(const uInt8* image, uInt32 size,
   : Cartridge(settings),
     mySize(size),
     mySystemCycles(0),
-    myFractionalClocks(0.0)
+    myFractionalClocks(0)
 {
   // Make a copy of the entire image
   memcpy(myImage, image, BSPF_min(size, 8192u + 2048u + 256u));
@@ -65,7 +65,7 @@ void CartridgeDPC::reset()
 {
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myFractionalClocks = 0;
 
   // Upon reset we switch to the startup bank
   bank(myStartBank);
@@ -97,6 +97,34 @@ void CartridgeDPC::install(System& system)
   for(uInt32 j = 0x1000; j < 0x1080; j += (1 << shift))
     mySystem->setPageAccess(j >> shift, access);
 
+  // Precompute the page access methods for each bank
+  access.type = System::PA_READ;
+  createBankPageAccess(bankCount(), (0x2000 - 0x1080) >> shift);
+  for(uInt16 b = 0; b < bankCount(); ++b)
+  {
+    uInt32 offset = b << 12;
+    System::PageAccess* table = bankPageAccess(b);
+
+    // Set the page accessing methods for the hot spots; the whole page
+    // goes through peek(), since every access to it clocks the random
+    // number generator
+    access.directPeekBase = 0;
+    for(uInt32 i = (0x1FF8 & ~mask); i < 0x2000; i += (1 << shift))
+    {
+      access.codeAccessBase = codeAccess(offset + (i & 0x0FFF));
+      table[(i - 0x1080) >> shift] = access;
+    }
+
+    // Setup the page access methods for the bank
+    for(uInt32 address = 0x1080; address < (0x1FF8U & ~mask);
+        address += (1 << shift))
+    {
+      access.directPeekBase = &myProgramImage[offset + (address & 0x0FFF)];
+      access.codeAccessBase = codeAccess(offset + (address & 0x0FFF));
+      table[(address - 0x1080) >> shift] = access;
+    }
+  }
+
   // Install pages for the startup bank
   bank(myStartBank);
 }
@@ -127,9 +155,9 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
   mySystemCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = (Int32)clocks;
-  myFractionalClocks = clocks - (double)wholeClocks;
+  uInt64 clocks = (uInt64)cycles * DPC_OSC_CLOCKS + myFractionalClocks;
+  Int32 wholeClocks = (Int32)(clocks / DPC_OSC_CYCLES);
+  myFractionalClocks = (uInt32)(clocks % DPC_OSC_CYCLES);
 
   if(wholeClocks <= 0)
   {
@@ -414,27 +442,9 @@ bool CartridgeDPC::bank(uInt16 bank)
 
   // Remember what bank we're in
   myCurrentBank = bank;
-  uInt16 offset = myCurrentBank << 12;
-  uInt16 shift = mySystem->pageShift();
-  uInt16 mask = mySystem->pageMask();
-
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
-
-  // Set the page accessing methods for the hot spots
-  for(uInt32 i = (0x1FF8 & ~mask); i < 0x2000; i += (1 << shift))
-  {
-    access.codeAccessBase = &myCodeAccessBase[offset + (i & 0x0FFF)];
-    mySystem->setPageAccess(i >> shift, access);
-  }
 
-  // Setup the page access methods for the current bank
-  for(uInt32 address = 0x1080; address < (0x1FF8U & ~mask);
-      address += (1 << shift))
-  {
-    access.directPeekBase = &myProgramImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
+  // Install the precomputed page access methods for this bank
+  installBankPageAccess(myCurrentBank, 0x1080);
   return myBankChanged = true;
 }
 
@@ -502,7 +512,8 @@ bool CartridgeDPC::save(Serializer& out) const
     out.putByte(myRandomNumber);
 
     out.putInt(mySystemCycles);
-    out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+    out.putInt((uInt32)((uInt64)myFractionalClocks * 100000000 /
+                        DPC_OSC_CYCLES));
   }
   catch(...)
   {
@@ -545,7 +556,8 @@ bool CartridgeDPC::load(Serializer& in)
 
     // Get system cycles and fractional clocks
     mySystemCycles = (Int32)in.getInt();
-    myFractionalClocks = (double)in.getInt() / 100000000.0;
+    myFractionalClocks = (uInt32)((uInt64)in.getInt() * DPC_OSC_CYCLES /
+                                  100000000);
   }
   catch(...)
   {
@@ -215,8 +215,9 @@ class CartridgeDPC : public Cartridge
     // System cycle count when the last update to music data fetchers occurred
     Int32 mySystemCycles;
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    // Fractional DPC music OSC clocks unused during the last update,
+    // in units of 1/DPC_OSC_CYCLES of a clock
+    uInt32 myFractionalClocks;
 };
 
 #endif
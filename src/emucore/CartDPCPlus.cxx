@@ -19,6 +19,7 @@
 
 #include <cassert>
 #include <cstring>
+#include <fstream>
 
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
@@ -28,20 +29,19 @@
 #include "CartDPCPlus.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeDPCPlus::CartridgeDPCPlus(const uInt8* image, uInt32 size,
-                                   const Settings& settings)
+CartridgeDPCPlus::CartridgeDPCPlus(const Common::SharedPtr<uInt8>& image,
+                                   uInt32 size, const Settings& settings)
   : Cartridge(settings),
     myFastFetch(false),
     myLDAimmediate(false),
     myParameterPointer(0),
     mySystemCycles(0),
-    myFractionalClocks(0.0)
+    myFractionalClocks(0)
 {
-  // Store image, making sure it's at least 29KB
+  // Use the image in place, making sure it's at least 29KB
   uInt32 minsize = 4096 * 6 + 4096 + 1024 + 255;
   mySize = BSPF_max(minsize, size);
-  myImage = new uInt8[mySize];
-  memcpy(myImage, image, size);
+  myImage = shareImage(image, size, mySize);
   createCodeAccessBase(4096 * 6);
 
   // Pointer to the program ROM (24K @ 0 byte offset)
@@ -63,6 +63,10 @@ CartridgeDPCPlus::CartridgeDPCPlus(const uInt8* image, uInt32 size,
   myThumbEmulator = new Thumbulator((uInt16*)(myProgramImage-0xC00),
                                     (uInt16*)myDPCRAM,
                                      settings.getBool("thumb.trapfatal"));
+
+  // Profile the ARM code for the lifetime of the cart, if requested
+  myProfileFile = settings.getString("thumb.profile");
+  myThumbEmulator->enableProfiling(myProfileFile != "");
 #endif
   setInitialState();
 
@@ -73,9 +77,14 @@ CartridgeDPCPlus::CartridgeDPCPlus(const uInt8* image, uInt32 size,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeDPCPlus::~CartridgeDPCPlus()
 {
-  delete[] myImage;
-
 #ifdef THUMB_SUPPORT
+  if(myProfileFile != "")
+  {
+    ofstream out(myProfileFile.c_str());
+    if(!saveARMProfile(out) || !out)
+      cerr << "ERROR: Couldn't write ARM profile to '" << myProfileFile
+           << "'" << endl;
+  }
   delete myThumbEmulator;
 #endif
 }
@@ -85,7 +94,7 @@ void CartridgeDPCPlus::reset()
 {
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myFractionalClocks = 0;
 
   setInitialState();
 
@@ -122,6 +131,11 @@ void CartridgeDPCPlus::systemCyclesReset()
 
   // Adjust the cycle counter so that it reflects the new value
   mySystemCycles -= cycles;
+
+#ifdef THUMB_SUPPORT
+  // The TIA resets the system cycles at the start of every frame
+  myThumbEmulator->profileFrame();
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -169,9 +183,9 @@ inline void CartridgeDPCPlus::updateMusicModeDataFetchers()
   mySystemCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = (Int32)clocks;
-  myFractionalClocks = clocks - (double)wholeClocks;
+  uInt64 clocks = (uInt64)cycles * DPC_OSC_CLOCKS + myFractionalClocks;
+  Int32 wholeClocks = (Int32)(clocks / DPC_OSC_CYCLES);
+  myFractionalClocks = (uInt32)(clocks % DPC_OSC_CYCLES);
 
   if(wholeClocks <= 0)
   {
@@ -181,7 +195,7 @@ inline void CartridgeDPCPlus::updateMusicModeDataFetchers()
   // Let's update counters and flags of the music mode data fetchers
   for(int x = 0; x <= 2; ++x)
   {
-    myMusicCounters[x] += myMusicFrequencies[x];
+    myMusicCounters[x] += myMusicFrequencies[x] * wholeClocks;
   }
 }
 
@@ -209,18 +223,13 @@ inline void CartridgeDPCPlus::callFunction(uInt8 value)
     case 254:
     case 255:
       // Call user written ARM code (most likely be C compiled for ARM)
-      try {
-        myThumbEmulator->run();
-      }
-      catch(const string& error) {
-        if(!mySystem->autodetectMode())
-        {
+      if(!myThumbEmulator->run() && !mySystem->autodetectMode())
+      {
       #ifdef DEBUGGER_SUPPORT
-          Debugger::debugger().startWithFatalError(error);
+        Debugger::debugger().startWithFatalError(myThumbEmulator->errorMessage());
       #else
-          cout << error << endl;
+        cout << myThumbEmulator->errorMessage() << endl;
       #endif
-        }
       }
       break;
   #endif
@@ -615,7 +624,7 @@ bool CartridgeDPCPlus::bank(uInt16 bank)
   // Map Program ROM image into the system
   for(uInt32 address = 0x1080; address < 0x2000; address += (1 << shift))
   {
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
+    access.codeAccessBase = codeAccess(offset + (address & 0x0FFF));
     mySystem->setPageAccess(address >> shift, access);
   }
   return myBankChanged = true;
@@ -641,6 +650,17 @@ bool CartridgeDPCPlus::patch(uInt16 address, uInt8 value)
   // For now, we ignore attempts to patch the DPC address space
   if(address >= 0x0080)
   {
+    // The ARM code reads the program ROM too, so it must follow any copy
+    uInt8* image = myImage;
+    unshareImage(myImage);
+    if(myImage != image)
+    {
+      myProgramImage += myImage - image;
+#ifdef THUMB_SUPPORT
+      myThumbEmulator->setROM((uInt16*)(myProgramImage-0xC00));
+#endif
+    }
+
     myProgramImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
     return myBankChanged = true;
   }
@@ -703,7 +723,8 @@ bool CartridgeDPCPlus::save(Serializer& out) const
     out.putInt(myRandomNumber);
 
     out.putInt(mySystemCycles);
-    out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+    out.putInt((uInt32)((uInt64)myFractionalClocks * 100000000 /
+                        DPC_OSC_CYCLES));
   }
   catch(...)
   {
@@ -764,7 +785,8 @@ bool CartridgeDPCPlus::load(Serializer& in)
 
     // Get system cycles and fractional clocks
     mySystemCycles = (Int32)in.getInt();
-    myFractionalClocks = (double)in.getInt() / 100000000.0;
+    myFractionalClocks = (uInt32)((uInt64)in.getInt() * DPC_OSC_CYCLES /
+                                  100000000);
   }
   catch(...)
   {
@@ -777,3 +799,16 @@ bool CartridgeDPCPlus::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeDPCPlus::saveARMProfile(ostream& out) const
+{
+#ifdef THUMB_SUPPORT
+  if(myThumbEmulator->profilingEnabled())
+  {
+    myThumbEmulator->saveProfile(out);
+    return true;
+  }
+#endif
+  return false;
+}
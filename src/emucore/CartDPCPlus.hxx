@@ -51,11 +51,12 @@ class CartridgeDPCPlus : public Cartridge
     /**
       Create a new cartridge using the specified image
 
-      @param image     Pointer to the ROM image
+      @param image     The ROM image (used in place, not copied)
       @param size      The size of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeDPCPlus(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeDPCPlus(const Common::SharedPtr<uInt8>& image, uInt32 size,
+                     const Settings& settings);
  
     /**
       Destructor
@@ -140,6 +141,15 @@ class CartridgeDPCPlus : public Cartridge
     */
     string name() const { return "CartridgeDPC+"; }
 
+    /**
+      Write the profile of the ARM code run by the cart to the given
+      stream, if profiling is enabled.
+
+      @param out  The stream to write the profile to
+      @return  False if the ARM code isn't being profiled, else true
+    */
+    bool saveARMProfile(ostream& out) const;
+
   #ifdef DEBUGGER_SUPPORT
     /**
       Get debugger widget responsible for accessing the inner workings
@@ -197,7 +207,7 @@ class CartridgeDPCPlus : public Cartridge
     void callFunction(uInt8 value);
 
   private:
-    // The ROM image and size
+    // The ROM image and size (see Cartridge::shareImage)
     uInt8* myImage;
     uInt32 mySize;
 
@@ -213,6 +223,10 @@ class CartridgeDPCPlus : public Cartridge
 #ifdef THUMB_SUPPORT
     // Pointer to the Thumb ARM emulator object
     Thumbulator* myThumbEmulator;
+
+    // File the ARM profile is written to when the cart is destroyed
+    // (empty when the ARM code isn't being profiled)
+    string myProfileFile;
 #endif
 
     // Pointer to the 1K frequency table
@@ -263,8 +277,9 @@ class CartridgeDPCPlus : public Cartridge
     // System cycle count when the last update to music data fetchers occurred
     Int32 mySystemCycles;
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    // Fractional DPC music OSC clocks unused during the last update,
+    // in units of 1/DPC_OSC_CYCLES of a clock
+    uInt32 myFractionalClocks;
 };
 
 #endif
@@ -65,17 +65,36 @@ void CartridgeE0::install(System& system)
   for(uInt32 i = 0x1C00; i < (0x1FE0U & ~mask); i += (1 << shift))
   {
     access.directPeekBase = &myImage[7168 + (i & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[7168 + (i & 0x03FF)];
+    access.codeAccessBase = codeAccess(7168 + (i & 0x03FF));
     mySystem->setPageAccess(i >> shift, access);
   }
   myCurrentSlice[3] = 7;
 
-  // Set the page accessing methods for the hot spots in the last segment
-  access.directPeekBase = 0;
-  access.codeAccessBase = &myCodeAccessBase[8128];
+  // Set the page accessing methods for the hot spots in the last segment;
+  // only the hot spots themselves are handled by peek()
   access.type = System::PA_READ;
   for(uInt32 j = (0x1FE0 & ~mask); j < 0x2000; j += (1 << shift))
+  {
+    access.directPeekBase = &myImage[7168 + (j & 0x03FF)];
+    access.codeAccessBase = codeAccess(7168 + (j & 0x03FF));
+    access.hotspots = mySystem->hotspotMask(j, 0x1FE0, 0x1FF7);
     mySystem->setPageAccess(j >> shift, access);
+  }
+
+  // Precompute the page access methods for each slice; these are the
+  // same for all of the first three segments
+  createBankPageAccess(8, 0x0400 >> shift);
+  for(uInt16 slice = 0; slice < 8; ++slice)
+  {
+    uInt16 offset = slice << 10;
+    System::PageAccess* table = bankPageAccess(slice);
+
+    for(uInt32 address = 0; address < 0x0400; address += (1 << shift))
+      table[address >> shift] =
+        System::PageAccess(&myImage[offset + address], 0,
+                           codeAccess(offset + address),
+                           this, System::PA_READ);
+  }
 
   // Install some default slices for the other segments
   segmentZero(4);
@@ -133,18 +152,9 @@ void CartridgeE0::segmentZero(uInt16 slice)
 
   // Remember the new slice
   myCurrentSlice[0] = slice;
-  uInt16 offset = slice << 10;
-  uInt16 shift = mySystem->pageShift();
-
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
 
-  for(uInt32 address = 0x1000; address < 0x1400; address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x03FF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
+  // Install the precomputed page access methods for this slice
+  installBankPageAccess(slice, 0x1000);
   myBankChanged = true;
 }
 
@@ -155,18 +165,9 @@ void CartridgeE0::segmentOne(uInt16 slice)
 
   // Remember the new slice
   myCurrentSlice[1] = slice;
-  uInt16 offset = slice << 10;
-  uInt16 shift = mySystem->pageShift();
-
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
 
-  for(uInt32 address = 0x1400; address < 0x1800; address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x03FF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
+  // Install the precomputed page access methods for this slice
+  installBankPageAccess(slice, 0x1400);
   myBankChanged = true;
 }
 
@@ -177,18 +178,9 @@ void CartridgeE0::segmentTwo(uInt16 slice)
 
   // Remember the new slice
   myCurrentSlice[2] = slice;
-  uInt16 offset = slice << 10;
-  uInt16 shift = mySystem->pageShift();
-
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
 
-  for(uInt32 address = 0x1800; address < 0x1C00; address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x03FF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
+  // Install the precomputed page access methods for this slice
+  installBankPageAccess(slice, 0x1800);
   myBankChanged = true;
 }
 
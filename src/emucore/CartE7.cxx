@@ -77,22 +77,54 @@ void CartridgeE7::install(System& system)
 
   System::PageAccess access(0, 0, 0, this, System::PA_READ);
 
-  // Set the page accessing methods for the hot spots
+  // Set the page accessing methods for the hot spots; only the hot spots
+  // themselves are handled by peek(), the rest of the page always points
+  // to the last ROM slice
   for(uInt32 i = (0x1FE0 & ~mask); i < 0x2000; i += (1 << shift))
   {
-    access.codeAccessBase = &myCodeAccessBase[8128];
+    access.directPeekBase = &myImage[7 * 2048 + (i & 0x07FF)];
+    access.codeAccessBase = codeAccess(7 * 2048 + (i & 0x07FF));
+    access.hotspots = mySystem->hotspotMask(i, 0x1FE0, 0x1FEB);
     mySystem->setPageAccess(i >> shift, access);
   }
+  access.hotspots = 0;
 
   // Setup the second segment to always point to the last ROM slice
   for(uInt32 j = 0x1A00; j < (0x1FE0U & ~mask); j += (1 << shift))
   {
     access.directPeekBase = &myImage[7 * 2048 + (j & 0x07FF)];
-    access.codeAccessBase = &myCodeAccessBase[7 * 2048 + (j & 0x07FF)];
+    access.codeAccessBase = codeAccess(7 * 2048 + (j & 0x07FF));
     mySystem->setPageAccess(j >> shift, access);
   }
   myCurrentSlice[1] = 7;
 
+  // Precompute the page access methods for each slice of the first
+  // segment; slice 7 maps the 1K of RAM instead of ROM
+  createBankPageAccess(8, 0x0800 >> shift);
+  for(uInt16 slice = 0; slice < 8; ++slice)
+  {
+    uInt16 offset = slice << 11;
+    System::PageAccess* table = bankPageAccess(slice);
+
+    for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
+    {
+      System::PageAccess& page = table[(address & 0x07FF) >> shift];
+
+      if(slice != 7)  // ROM
+        page = System::PageAccess(&myImage[offset + (address & 0x07FF)], 0,
+                   codeAccess(offset + (address & 0x07FF)),
+                   this, System::PA_READ);
+      else if(address < 0x1400)  // RAM writing pages
+        page = System::PageAccess(0, &myRAM[address & 0x03FF],
+                   codeAccess(8192 + (address & 0x03FF)),
+                   this, System::PA_WRITE);
+      else  // RAM reading pages
+        page = System::PageAccess(&myRAM[address & 0x03FF], 0,
+                   codeAccess(8192 + (address & 0x03FF)),
+                   this, System::PA_READ);
+    }
+  }
+
   // Install some default banks for the RAM and first segment
   bankRAM(0);
   bank(myStartBank);
@@ -182,7 +214,7 @@ void CartridgeE7::bankRAM(uInt16 bank)
   for(uInt32 j = 0x1800; j < 0x1900; j += (1 << shift))
   {
     access.directPokeBase = &myRAM[1024 + offset + (j & 0x00FF)];
-    access.codeAccessBase = &myCodeAccessBase[8192 + 1024 + offset + (j & 0x00FF)];
+    access.codeAccessBase = codeAccess(8192 + 1024 + offset + (j & 0x00FF));
     mySystem->setPageAccess(j >> shift, access);
   }
 
@@ -192,7 +224,7 @@ void CartridgeE7::bankRAM(uInt16 bank)
   for(uInt32 k = 0x1900; k < 0x1A00; k += (1 << shift))
   {
     access.directPeekBase = &myRAM[1024 + offset + (k & 0x00FF)];
-    access.codeAccessBase = &myCodeAccessBase[8192 + 1024 + offset + (k & 0x00FF)];
+    access.codeAccessBase = codeAccess(8192 + 1024 + offset + (k & 0x00FF));
     mySystem->setPageAccess(k >> shift, access);
   }
   myBankChanged = true;
@@ -205,44 +237,9 @@ bool CartridgeE7::bank(uInt16 slice)
 
   // Remember what bank we're in
   myCurrentSlice[0] = slice;
-  uInt16 offset = slice << 11;
-  uInt16 shift = mySystem->pageShift();
-
-  // Setup the page access methods for the current bank
-  if(slice != 7)
-  {
-    System::PageAccess access(0, 0, 0, this, System::PA_READ);
-
-    // Map ROM image into first segment
-    for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
-    {
-      access.directPeekBase = &myImage[offset + (address & 0x07FF)];
-      access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
-      mySystem->setPageAccess(address >> shift, access);
-    }
-  }
-  else
-  {
-    System::PageAccess access(0, 0, 0, this, System::PA_WRITE);
 
-    // Set the page accessing method for the 1K slice of RAM writing pages
-    for(uInt32 j = 0x1000; j < 0x1400; j += (1 << shift))
-    {
-      access.directPokeBase = &myRAM[j & 0x03FF];
-      access.codeAccessBase = &myCodeAccessBase[8192 + (j & 0x03FF)];
-      mySystem->setPageAccess(j >> shift, access);
-    }
-
-    // Set the page accessing method for the 1K slice of RAM reading pages
-    access.directPokeBase = 0;
-    access.type = System::PA_READ;
-    for(uInt32 k = 0x1400; k < 0x1800; k += (1 << shift))
-    {
-      access.directPeekBase = &myRAM[k & 0x03FF];
-      access.codeAccessBase = &myCodeAccessBase[8192 + (k & 0x03FF)];
-      mySystem->setPageAccess(k >> shift, access);
-    }
-  }
+  // Install the precomputed page access methods for this slice
+  installBankPageAccess(slice, 0x1000);
   return myBankChanged = true;
 }
 
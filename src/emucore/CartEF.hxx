@@ -47,11 +47,12 @@ class CartridgeEF : public Cartridge
     /**
       Create a new cartridge using the specified image
 
-      @param image     Pointer to the ROM image
+      @param image     The ROM image (used in place, not copied)
       @param size      The size of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeEF(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeEF(const Common::SharedPtr<uInt8>& image, uInt32 size,
+                const Settings& settings);
 
     /**
       Destructor
@@ -162,8 +163,8 @@ class CartridgeEF : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
-    // The 64K ROM image of the cartridge
-    uInt8 myImage[65536];
+    // The 64K ROM image of the cartridge (see Cartridge::shareImage)
+    uInt8* myImage;
 };
 
 #endif
@@ -44,11 +44,12 @@ class CartridgeF0 : public Cartridge
     /**
       Create a new cartridge using the specified image
 
-      @param image     Pointer to the ROM image
+      @param image     The ROM image (used in place, not copied)
       @param size      The size of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeF0(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeF0(const Common::SharedPtr<uInt8>& image, uInt32 size,
+                const Settings& settings);
 
     /**
       Destructor
@@ -165,8 +166,8 @@ class CartridgeF0 : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
-    // The 64K ROM image of the cartridge
-    uInt8 myImage[65536];
+    // The 64K ROM image of the cartridge (see Cartridge::shareImage)
+    uInt8* myImage;
 };
 
 #endif
@@ -26,11 +26,12 @@
 #include "CartX07.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeX07::CartridgeX07(const uInt8* image, uInt32 size, const Settings& settings)
+CartridgeX07::CartridgeX07(const Common::SharedPtr<uInt8>& image,
+                           uInt32 size, const Settings& settings)
   : Cartridge(settings)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(65536u, size));
+  // Use the ROM image in place, rather than copying it
+  myImage = shareImage(image, size, 65536);
   createCodeAccessBase(65536);
 
   // Remember startup bank
@@ -66,6 +67,21 @@ void CartridgeX07::install(System& system)
   for(uInt32 i = 0x00; i < 0x1000; i += (1 << shift))
     mySystem->setPageAccess(i >> shift, access);
 
+  // Precompute the page access methods for each bank
+  createBankPageAccess(bankCount(), (0x2000 - 0x1000) >> shift);
+  for(uInt16 b = 0; b < bankCount(); ++b)
+  {
+    uInt32 offset = b << 12;
+    System::PageAccess* table = bankPageAccess(b);
+
+    // Map ROM image into the system
+    for(uInt32 address = 0x1000; address < 0x2000; address += (1 << shift))
+      table[(address & 0x0FFF) >> shift] =
+        System::PageAccess(&myImage[offset + (address & 0x0FFF)], 0,
+                           codeAccess(offset + (address & 0x0FFF)),
+                           this, System::PA_READ);
+  }
+
   // Install pages for the startup bank
   bank(myStartBank);
 }
@@ -122,19 +138,9 @@ bool CartridgeX07::bank(uInt16 bank)
 
   // Remember what bank we're in
   myCurrentBank = (bank & 0x0f);
-  uInt32 offset = myCurrentBank << 12;
-  uInt16 shift = mySystem->pageShift();
 
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
-
-  // Map ROM image into the system
-  for(uInt32 address = 0x1000; address < 0x2000; address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
+  // Install the precomputed page access methods for this bank
+  installBankPageAccess(myCurrentBank, 0x1000);
   return myBankChanged = true;
 }
 
@@ -153,6 +159,7 @@ uInt16 CartridgeX07::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeX07::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
   myImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 } 
@@ -53,11 +53,12 @@ class CartridgeX07 : public Cartridge
     /**
       Create a new cartridge using the specified image
 
-      @param image     Pointer to the ROM image
+      @param image     The ROM image (used in place, not copied)
       @param size      The size of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeX07(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeX07(const Common::SharedPtr<uInt8>& image, uInt32 size,
+                 const Settings& settings);
  
     /**
       Destructor
@@ -168,8 +169,8 @@ class CartridgeX07 : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
-    // The 64K ROM image of the cartridge
-    uInt8 myImage[65536];
+    // The 64K ROM image of the cartridge (see Cartridge::shareImage)
+    uInt8* myImage;
 };
 
 #endif
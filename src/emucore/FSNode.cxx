@@ -175,6 +175,12 @@ bool FilesystemNode::rename(const string& newfile)
   return (_realNode && _realNode->exists()) ? _realNode->rename(newfile) : false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNode::getFileInfo(uInt32& size, uInt32& modified) const
+{
+  return _realNode ? _realNode->getFileInfo(size, modified) : false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 FilesystemNode::read(uInt8*& image) const
 {
@@ -227,6 +227,18 @@ class FilesystemNode
      */
     virtual bool rename(const string& newfile);
 
+    /**
+     * Get the size and last modification time of the file, which together
+     * tell whether its contents may have changed since they were last
+     * looked at.  For a file inside a ZIP archive, these are the size and
+     * modification time of the archive itself.
+     *
+     * @param size      The size of the file in bytes
+     * @param modified  The time the file was last modified, in seconds
+     * @return  true if the information is available, false otherwise.
+     */
+    virtual bool getFileInfo(uInt32& size, uInt32& modified) const;
+
     /**
      * Read data (binary format) into the given buffer.
      *
@@ -371,6 +383,15 @@ class AbstractFSNode
      */
     virtual bool rename(const string& newfile) = 0;
 
+    /**
+     * Get the size and last modification time of the file.
+     *
+     * @param size      The size of the file in bytes
+     * @param modified  The time the file was last modified, in seconds
+     * @return  true if the information is available, false otherwise.
+     */
+    virtual bool getFileInfo(uInt32& size, uInt32& modified) const { return false; }
+
     /**
      * Read data (binary format) into the given buffer.
      *
@@ -31,6 +31,7 @@
 #include "Menu.hxx"
 #include "OSystem.hxx"
 #include "Settings.hxx"
+#include "Sound.hxx"
 #include "TIA.hxx"
 
 #include "FrameBuffer.hxx"
@@ -169,8 +170,8 @@ FBInitStatus FrameBuffer::initialize(const string& title,
 
   // Create surfaces for TIA statistics and general messages
   myStatsMsg.color = kBtnTextColor;
-  myStatsMsg.w = myOSystem->infoFont().getMaxCharWidth() * 24 + 2;
-  myStatsMsg.h = (myOSystem->infoFont().getFontHeight() + 2) * 2;
+  myStatsMsg.w = myOSystem->infoFont().getMaxCharWidth() * 28 + 2;
+  myStatsMsg.h = (myOSystem->infoFont().getFontHeight() + 2) * 3;
 
  if(myStatsMsg.surface == NULL)
   {
@@ -225,8 +226,31 @@ void FrameBuffer::update()
         myStatsMsg.surface->fillRect(0, 0, myStatsMsg.w, myStatsMsg.h, kBGColor);
         myStatsMsg.surface->drawString(myOSystem->infoFont(),
           msg, 1, 1, myStatsMsg.w, myStatsMsg.color, kTextAlignLeft);
+        // Sound register writes only get dropped when the sound callback
+        // falls far behind, so the count is only shown when it happens
+        string bankswitch = info.BankSwitch;
+        uInt32 dropped = myOSystem->sound().droppedWrites();
+        if(dropped > 0)
+        {
+          ostringstream buf;
+          buf << bankswitch << " (" << dropped << " lost)";
+          bankswitch = buf.str();
+        }
         myStatsMsg.surface->drawString(myOSystem->infoFont(),
-          info.BankSwitch, 1, 15, myStatsMsg.w, myStatsMsg.color, kTextAlignLeft);
+          bankswitch, 1, 15, myStatsMsg.w, myStatsMsg.color, kTextAlignLeft);
+
+        // The sound latency, queue fill level and underruns, if there's sound
+        uInt32 latency, fill, underruns, lines = 2;
+        if(myOSystem->sound().queueStats(latency, fill, underruns))
+        {
+          BSPF_snprintf(msg, 30, "%ums %u%% %u underruns",
+                        latency, fill, underruns);
+          myStatsMsg.surface->drawString(myOSystem->infoFont(),
+            msg, 1, 29, myStatsMsg.w, myStatsMsg.color, kTextAlignLeft);
+          lines = 3;
+        }
+        myStatsMsg.surface->setHeight(
+          (myOSystem->infoFont().getFontHeight() + 2) * lines);
         myStatsMsg.surface->addDirtyRect(0, 0, 0, 0);  // force a full draw
         myStatsMsg.surface->setPos(myImageRect.x() + 1, myImageRect.y() + 1);
         myStatsMsg.surface->update();
@@ -17,6 +17,8 @@
 // $Id$
 //============================================================================
 
+#include <cassert>
+
 //#define DEBUG_OUTPUT
 #define debugStream cout
 
@@ -44,6 +46,10 @@
 #endif
 #include "Settings.hxx"
 
+#ifdef BENCHMARK_SUPPORT
+  #include "Bench.hxx"
+#endif
+
 #include "M6502.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -62,7 +68,10 @@ M6502::M6502(uInt32 systemCyclesPerProcessorCycle, const Settings& settings)
     myLastSrcAddressA(-1),
     myLastSrcAddressX(-1),
     myLastSrcAddressY(-1),
-    myDataAddressForPoke(0)
+    myDataAddressForPoke(0),
+    myDecodedPages(0),
+    myPageShift(0),
+    myPageMask(0)
 {
 #ifdef DEBUGGER_SUPPORT
   myDebugger    = NULL;
@@ -73,6 +82,13 @@ M6502::M6502(uInt32 systemCyclesPerProcessorCycle, const Settings& settings)
   myJustHitTrapFlag = false;
 #endif
 
+  // Nothing has been decoded yet, and the block for pages which can't be
+  // run from the cache is empty
+  myDecodedBlocks = new DecodedBlock[NumDecodedBlocks];
+  for(uInt32 b = 0; b < NumDecodedBlocks; ++b)
+    myDecodedBlocks[b].base = 0;
+  memset(&myUncachedBlock, 0, sizeof(DecodedBlock));
+
   // Compute the System Cycle table
   for(uInt32 t = 0; t < 256; ++t)
   {
@@ -90,6 +106,9 @@ debugStream << "( Fm  Ln Cyc Clk) ( P0  P1  M0  M1  BL)  "
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::~M6502()
 {
+  delete[] myDecodedBlocks;
+  delete[] myDecodedPages;
+
 #ifdef DEBUGGER_SUPPORT
   myBreakConds.clear();
   myBreakCondNames.clear();
@@ -101,6 +120,14 @@ void M6502::install(System& system)
 {
   // Remember which system I'm installed in
   mySystem = &system;
+
+  // Pages are decoded the first time code runs from them
+  assert(system.pageShift() <= 6);
+  myPageShift = system.pageShift();
+  myPageMask = system.pageMask();
+  delete[] myDecodedPages;
+  myDecodedPages = new DecodedBlock*[system.numberOfPages()];
+  flushDecodedInstructions();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -136,9 +163,12 @@ void M6502::reset()
   myLastSrcAddressS = myLastSrcAddressA =
     myLastSrcAddressX = myLastSrcAddressY = -1;
   myDataAddressForPoke = 0;
+
+  flushDecodedInstructions();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debug>
 inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
 {
   ////////////////////////////////////////////////
@@ -152,7 +182,7 @@ inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
   mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
 
 #ifdef DEBUGGER_SUPPORT
-  if(myReadTraps != NULL && myReadTraps->isSet(address))
+  if(debug && myReadTraps != NULL && myReadTraps->isSet(address))
   {
     myJustHitTrapFlag = true;
     myHitTrapInfo.message = "RTrap: ";
@@ -168,6 +198,7 @@ inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debug>
 inline void M6502::poke(uInt16 address, uInt8 value)
 {
   ////////////////////////////////////////////////
@@ -181,7 +212,7 @@ inline void M6502::poke(uInt16 address, uInt8 value)
   mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
 
 #ifdef DEBUGGER_SUPPORT
-  if(myWriteTraps != NULL && myWriteTraps->isSet(address))
+  if(debug && myWriteTraps != NULL && myWriteTraps->isSet(address))
   {
     myJustHitTrapFlag = true;
     myHitTrapInfo.message = "WTrap: ";
@@ -196,6 +227,23 @@ inline void M6502::poke(uInt16 address, uInt8 value)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502::execute(uInt32 number)
+{
+#ifdef BENCHMARK_SUPPORT
+  Bench::Timer timer(Bench::CPU);
+#endif
+
+#ifdef DEBUGGER_SUPPORT
+  // The decoded instruction cache bypasses the system, so the access
+  // types for the disassembler are only recorded by the 'debug' variant
+  if(debugChecksActive() || mySystem->accessTracking())
+    return execute<true>(number);
+#endif
+  return execute<false>(number);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debug>
+bool M6502::execute(uInt32 number)
 {
   // Clear all of the execution status bits except for the fatal error bit
   myExecutionStatus &= FatalErrorBit;
@@ -206,68 +254,54 @@ bool M6502::execute(uInt32 number)
     for(; !myExecutionStatus && (number != 0); --number)
     {
 #ifdef DEBUGGER_SUPPORT
-      if(myJustHitTrapFlag)
+      if(debug)
       {
-        if(myDebugger && myDebugger->start(myHitTrapInfo.message, myHitTrapInfo.address))
+        if(myJustHitTrapFlag)
         {
-          myJustHitTrapFlag = false;
-          return true;
+          if(myDebugger && myDebugger->start(myHitTrapInfo.message, myHitTrapInfo.address))
+          {
+            myJustHitTrapFlag = false;
+            return true;
+          }
         }
-      }
 
-      if(myBreakPoints != NULL)
-      {
-        if(myBreakPoints->isSet(PC))
+        if(myBreakPoints != NULL)
         {
-          if(myDebugger && myDebugger->start("BP: ", PC))
-            return true;
+          if(myBreakPoints->isSet(PC))
+          {
+            if(myDebugger && myDebugger->start("BP: ", PC))
+              return true;
+          }
         }
-      }
 
-      int cond = evalCondBreaks();
-      if(cond > -1)
-      {
-        string buf = "CBP: " + myBreakCondNames[cond];
-        if(myDebugger && myDebugger->start(buf))
-          return true;
+        int cond = evalCondBreaks();
+        if(cond > -1)
+        {
+          string buf = "CBP: " + myBreakCondNames[cond];
+          if(myDebugger && myDebugger->start(buf))
+            return true;
+        }
       }
 #endif
-      uInt16 operandAddress = 0, intermediateAddress = 0;
-      uInt8 operand = 0;
-
       // Reset the peek/poke address pointers
       myLastPeekAddress = myLastPokeAddress = myDataAddressForPoke = 0;
 
-      // Fetch instruction at the program counter
-      IR = peek(PC++, DISASM_CODE);  // This address represents a code section
-
-#ifdef DEBUG_OUTPUT
-      debugStream << ::hex << setw(2) << (int)A << " "
-                  << ::hex << setw(2) << (int)X << " "
-                  << ::hex << setw(2) << (int)Y << " "
-                  << ::hex << setw(2) << (int)SP << "  "
-                  << setw(4) << (PC-1) << ": "
-                  << setw(2) << (int)IR << "       "
-//      << "<" << ourAddressingModeTable[IR] << " ";
-//      debugStream << hex << setw(4) << operandAddress << " ";
-//                  << setw(3) << ourInstructionMnemonicTable[IR]
-
-//      debugStream << "PS=" << ::hex << setw(2) << (int)PS() << " ";
-
-//      debugStream << "Cyc=" << dec << mySystem->cycles();
-                  << endl;
-#endif
-
-      // Call code to execute the instruction
-      switch(IR)
+      // Run the instruction from the decoded instruction cache if possible
+      if(!debug)
       {
-        // 6502 instruction emulation is generated by an M4 macro file
-        #include "M6502.ins"
-
-        default:
-          // Oops, illegal instruction executed so set fatal error flag
-          myExecutionStatus |= FatalErrorBit;
+        const DecodedInstruction& instruction = decodedInstruction(PC);
+        if(instruction.cycles)
+        {
+          executeDecoded(instruction);
+          myTotalInstructionCount++;
+          continue;
+        }
       }
+
+      // Fetch instruction at the program counter
+      IR = peek<debug>(PC++, DISASM_CODE);  // This address represents a code section
+
+      executeInstruction<debug, false>(myUncachedBlock.instruction[0]);
       myTotalInstructionCount++;
     }
 
@@ -302,6 +336,133 @@ bool M6502::execute(uInt32 number)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debug, bool decoded>
+inline void M6502::executeInstruction(const DecodedInstruction& instruction)
+{
+  uInt16 operandAddress = 0, intermediateAddress = 0;
+  uInt8 operand = 0;
+
+#ifdef DEBUG_OUTPUT
+  debugStream << ::hex << setw(2) << (int)A << " "
+              << ::hex << setw(2) << (int)X << " "
+              << ::hex << setw(2) << (int)Y << " "
+              << ::hex << setw(2) << (int)SP << "  "
+              << setw(4) << (PC-1) << ": "
+              << setw(2) << (int)IR << "       "
+//  << "<" << ourAddressingModeTable[IR] << " ";
+//  debugStream << hex << setw(4) << operandAddress << " ";
+//              << setw(3) << ourInstructionMnemonicTable[IR]
+
+//  debugStream << "PS=" << ::hex << setw(2) << (int)PS() << " ";
+
+//  debugStream << "Cyc=" << dec << mySystem->cycles();
+              << endl;
+#endif
+
+  // Call code to execute the instruction
+  switch(IR)
+  {
+    // 6502 instruction emulation is generated by an M4 macro file
+    #include "M6502.ins"
+
+    default:
+      // Oops, illegal instruction executed so set fatal error flag
+      myExecutionStatus |= FatalErrorBit;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::executeDecoded(const DecodedInstruction& instruction)
+{
+  // Account for the leading reads of the instruction's bytes, exactly as
+  // peek() would have done for each of them; they're all distinct, except
+  // maybe the opcode fetch
+  uInt32 cycles = instruction.cycles;
+  myNumberOfDistinctAccesses += cycles - (PC == myLastAddress ? 1 : 0);
+  myLastAddress = myLastPeekAddress = PC + cycles - 1;
+  myLastAccessWasRead = true;
+  mySystem->incrementCycles(cycles * mySystemCyclesPerProcessorCycle);
+  mySystem->setDataBusState(instruction.bytes[cycles - 1]);
+
+  IR = instruction.bytes[0];
+  PC++;
+  executeInstruction<false, true>(instruction);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline const M6502::DecodedInstruction& M6502::decodedInstruction(uInt16 address)
+{
+  uInt16 page = (address >> myPageShift) & (mySystem->numberOfPages() - 1);
+  DecodedBlock* block = myDecodedPages[page];
+  if(!block)
+    block = decodePage(page);
+
+  return block->instruction[address & myPageMask];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6502::DecodedBlock* M6502::decodePage(uInt16 page)
+{
+  const System::PageAccess& access = mySystem->getPageAccess(page);
+  const uInt8* base = access.directPeekBase;
+  uInt32 size = myPageMask + 1;
+
+  // Only ROM is decoded; pages of RAM are recognized by any page writing
+  // directly to the same memory
+  bool decodable = base && !access.hotspots;
+  for(uInt32 p = 0; decodable && p < mySystem->numberOfPages(); ++p)
+  {
+    const uInt8* poke = mySystem->getPageAccess(p).directPokeBase;
+    if(poke && poke < base + size && base < poke + size)
+      decodable = false;
+  }
+  if(!decodable)
+    return myDecodedPages[page] = &myUncachedBlock;
+
+  DecodedBlock& block = decodedBlock(base);
+  if(block.base != base)
+  {
+    evictDecodedBlock(block);
+    block.base = base;
+
+    // Instructions whose leading reads don't fit in the page aren't cached
+    for(uInt32 offset = 0; offset < size; ++offset)
+    {
+      DecodedInstruction& instruction = block.instruction[offset];
+      uInt32 fetches = ourInstructionFetchTable[base[offset]];
+      for(uInt32 i = 0; i < 3; ++i)
+        instruction.bytes[i] = offset + i < size ? base[offset + i] : 0;
+      instruction.cycles = offset + fetches <= size ? fetches : 0;
+    }
+  }
+
+  return myDecodedPages[page] = &block;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::evictDecodedBlock(DecodedBlock& block)
+{
+  if(!block.base)
+    return;
+
+  for(uInt32 page = 0; page < mySystem->numberOfPages(); ++page)
+    if(myDecodedPages[page] == &block)
+      myDecodedPages[page] = 0;
+
+  block.base = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::flushDecodedInstructions()
+{
+  for(uInt32 b = 0; b < NumDecodedBlocks; ++b)
+    myDecodedBlocks[b].base = 0;
+
+  for(uInt32 page = 0; page < mySystem->numberOfPages(); ++page)
+    myDecodedPages[page] = 0;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::interruptHandler()
 {
@@ -422,6 +583,8 @@ bool M6502::load(Serializer& in)
     return false;
   }
 
+  flushDecodedInstructions();
+
   return true;
 }
 
@@ -468,6 +631,15 @@ const StringList& M6502::getCondBreakNames() const
   return myBreakCondNames;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502::debugChecksActive() const
+{
+  return myJustHitTrapFlag || myBreakConds.size() > 0 ||
+         (myBreakPoints != NULL && !myBreakPoints->isEmpty()) ||
+         (myReadTraps != NULL && !myReadTraps->isEmpty()) ||
+         (myWriteTraps != NULL && !myWriteTraps->isEmpty());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int32 M6502::evalCondBreaks()
 {
@@ -512,3 +684,24 @@ uInt32 M6502::ourInstructionCycleTable[256] = {
     2, 6, 2, 8, 3, 3, 5, 5, 2, 2, 2, 2, 4, 4, 6, 6,  // e
     2, 5, 2, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7   // f
 };
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 M6502::ourInstructionFetchTable[256] = {
+//  0  1  2  3  4  5  6  7  8  9  a  b  c  d  e  f
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3,  // 0
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 3, 2, 3, 3, 3, 3, 3,  // 1
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3,  // 2
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 3, 2, 3, 3, 3, 3, 3,  // 3
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3,  // 4
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 3, 2, 3, 3, 3, 3, 3,  // 5
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3,  // 6
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 3, 2, 3, 3, 3, 3, 3,  // 7
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3,  // 8
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 3, 2, 3, 3, 3, 3, 3,  // 9
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3,  // a
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 3, 2, 3, 3, 3, 3, 3,  // b
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3,  // c
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 3, 2, 3, 3, 3, 3, 3,  // d
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3,  // e
+    2, 2, 0, 2, 2, 2, 2, 2, 2, 3, 2, 3, 3, 3, 3, 3   // f
+};
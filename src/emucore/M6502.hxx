@@ -206,6 +206,35 @@ class M6502 : public Serializable
     */
     string name() const { return "M6502"; }
 
+    /**
+      Forget the instructions decoded for the given page, since the way
+      it's accessed has changed.  Invoked by System::setPageAccess().
+
+      @param page The page whose access methods have changed
+    */
+    void invalidateDecodedPage(uInt16 page) { myDecodedPages[page] = 0; }
+
+    /**
+      Forget the instructions decoded from the given page of memory, if
+      any, since it's being written to.  Invoked by System::poke() for
+      directly accessed pages.
+
+      @param base The start of the page of memory being written to
+    */
+    void invalidateDecodedMemory(const uInt8* base)
+    {
+      DecodedBlock& block = decodedBlock(base);
+      if(block.base == base)
+        evictDecodedBlock(block);
+    }
+
+    /**
+      Forget all decoded instructions.  This must be invoked whenever
+      memory is changed behind the back of the system, such as when the
+      ROM is patched.
+    */
+    void flushDecodedInstructions();
+
 #ifdef DEBUGGER_SUPPORT
   public:
     /**
@@ -226,11 +255,100 @@ class M6502 : public Serializable
 #endif
 
   private:
+    /**
+      Execute instructions as described for execute() above.  The 'debug'
+      variant checks breakpoints, conditional breaks and read/write traps
+      for every instruction; the other one skips these checks entirely,
+      and is used whenever none of them are active.
+
+      @param number Indicates the number of instructions to execute
+      @return true iff execution stops normally
+    */
+    template<bool debug> bool execute(uInt32 number);
+
+    /**
+      An instruction decoded from a page of ROM: its opcode and the two
+      bytes following it, along with the number of processor cycles taken
+      by the reads of these bytes that the instruction starts with.  The
+      cycles are zero if the instruction can't be run from the cache.
+    */
+    struct DecodedInstruction
+    {
+      uInt8 bytes[3];
+      uInt8 cycles;
+    };
+
+    /**
+      The instructions decoded from one page of memory, one per address
+    */
+    struct DecodedBlock
+    {
+      const uInt8* base;  // The page of memory, or the null pointer if unused
+      DecodedInstruction instruction[64];
+    };
+
+    /**
+      Execute the instruction whose opcode is in IR.  The 'decoded' variant
+      takes the instruction's own bytes from the given decoded instruction,
+      where the reads of them have already been accounted for.
+
+      @param instruction The decoded instruction (only used if 'decoded')
+    */
+    template<bool debug, bool decoded>
+    void executeInstruction(const DecodedInstruction& instruction);
+
+    /**
+      Execute the given decoded instruction, which is at the program
+      counter.  All its leading reads of its own bytes are accounted for
+      at once, since nothing else can access the bus in between.
+
+      @param instruction The decoded instruction
+    */
+    void executeDecoded(const DecodedInstruction& instruction);
+
+    /**
+      Get the decoded instruction at the specified address, decoding its
+      page first if necessary.  Instructions that can't be run from the
+      cache have no cycles.
+
+      @param address The address of the instruction
+      @return The decoded instruction
+    */
+    const DecodedInstruction& decodedInstruction(uInt16 address);
+
+    /**
+      Decode the instructions of the given page, if it's a directly
+      accessed page of ROM without any hotspots, and remember the result.
+
+      @param page The page to decode
+      @return The decoded instructions of the page
+    */
+    DecodedBlock* decodePage(uInt16 page);
+
+    /**
+      Get the block in the cache used for the given page of memory.
+
+      @param base The start of the page of memory
+      @return The block for the page (possibly used by another page)
+    */
+    DecodedBlock& decodedBlock(const uInt8* base)
+    {
+      return myDecodedBlocks[((size_t)base >> myPageShift) %
+                             NumDecodedBlocks];
+    }
+
+    /**
+      Remove the given block from the cache, making sure no page uses it.
+
+      @param block The block to remove
+    */
+    void evictDecodedBlock(DecodedBlock& block);
+
     /**
       Get the byte at the specified address and update the cycle count.
       Addresses marked as code are hints to the debugger/disassembler to
       conclusively determine code sections, even if the disassembler cannot
-      find them itself.
+      find them itself.  Read traps are only checked in the 'debug' variant.
 
       @param address  The address from which the value should be loaded
       @param flags    Indicates that this address has the given flags
@@ -238,16 +356,44 @@ class M6502 : public Serializable
 
       @return The byte at the specified address
     */
-    uInt8 peek(uInt16 address, uInt8 flags);
+    template<bool debug> uInt8 peek(uInt16 address, uInt8 flags);
 
     /**
       Change the byte at the specified address to the given value and
-      update the cycle count.
+      update the cycle count.  Write traps are only checked in the 'debug'
+      variant.
 
       @param address  The address where the value should be stored
       @param value    The value to be stored at the address
     */
-    void poke(uInt16 address, uInt8 value);
+    template<bool debug> void poke(uInt16 address, uInt8 value);
+
+    /**
+      Get a byte of the current instruction at the specified address as
+      part of the reads the instruction starts with.  The 'decoded' variant
+      simply answers the byte taken from the decoded instruction cache.
+
+      @param address  The address from which the value should be loaded
+      @param flags    Indicates that this address has the given flags
+                      for type of access (CODE, DATA, GFX, etc)
+      @param decodedByte The byte from the decoded instruction
+
+      @return The byte at the specified address
+    */
+    template<bool debug, bool decoded>
+    uInt8 peekCode(uInt16 address, uInt8 flags, uInt8 decodedByte)
+    {
+      return decoded ? decodedByte : peek<debug>(address, flags);
+    }
+
+#ifdef DEBUGGER_SUPPORT
+    /**
+      Answers whether any breakpoints, conditional breaks or traps are
+      active (or a trap is pending), requiring the 'debug' variant of
+      execute() to be used.
+    */
+    bool debugChecksActive() const;
+#endif
 
     /**
       Get the 8-bit value of the Processor Status register.
@@ -357,6 +503,23 @@ class M6502 : public Serializable
     /// is set to zero
     uInt16 myDataAddressForPoke;
 
+    /// The number of blocks in the decoded instruction cache
+    enum { NumDecodedBlocks = 256 };
+
+    /// The decoded instruction cache, where each block is shared by all
+    /// pages using the same page of memory (such as a bank of ROM)
+    DecodedBlock* myDecodedBlocks;
+
+    /// The decoded instructions used by each page, or the null pointer
+    /// if the page hasn't been decoded since its access methods changed
+    DecodedBlock** myDecodedPages;
+
+    /// The block used by pages which can't be run from the cache
+    DecodedBlock myUncachedBlock;
+
+    /// The page shift and mask of the system (see System::pageShift())
+    uInt16 myPageShift, myPageMask;
+
 #ifdef DEBUGGER_SUPPORT
     /// Pointer to the debugger for this processor or the null pointer
     Debugger* myDebugger;
@@ -383,6 +546,13 @@ class M6502 : public Serializable
       cycles will be added during the execution of an instruction.
     */
     static uInt32 ourInstructionCycleTable[256];
+
+    /**
+      Table of the number of reads of its own bytes each instruction starts
+      with (including the dummy read of implied instructions), or zero for
+      illegal instructions.  These are the reads done by PEEK_CODE.
+    */
+    static uInt8 ourInstructionFetchTable[256];
 };
 
 #endif
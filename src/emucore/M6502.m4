@@ -21,6 +21,11 @@
   Recompile with the following:
     'm4 M6502.m4 > M6502.ins'
 
+  The generated code is included by M6502::executeInstruction(), so every
+  memory access goes through the matching peek<debug>/poke<debug>.  The
+  reads of the instruction's own bytes which it starts with use PEEK_CODE
+  instead, so they can be taken from the decoded instruction cache.
+
   @author  Bradford W. Mott and Stephen Anthony
 */
 
@@ -44,6 +49,11 @@
   #endif
 #endif
 
+#ifndef PEEK_CODE
+  #define PEEK_CODE(_addr, _flags, _byte) \
+    peekCode<debug, decoded>(_addr, _flags, instruction.bytes[_byte])
+#endif
+
 #ifndef SET_LAST_POKE
   #ifdef DEBUGGER_SUPPORT
     #define SET_LAST_POKE(_addr) myDataAddressForPoke = _addr;
@@ -54,221 +64,221 @@
 
 
 define(M6502_IMPLIED, `{
-  peek(PC, DISASM_NONE);
+  PEEK_CODE(PC, DISASM_NONE, 1);
 }')
 
 define(M6502_IMMEDIATE_READ, `{
-  operand = peek(PC++, DISASM_CODE);
+  operand = PEEK_CODE(PC++, DISASM_CODE, 1);
 }')
 
 define(M6502_ABSOLUTE_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  intermediateAddress |= ((uInt16)peek(PC++, DISASM_CODE) << 8);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  intermediateAddress |= ((uInt16)PEEK_CODE(PC++, DISASM_CODE, 2) << 8);
+  operand = peek<debug>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ABSOLUTE_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  operandAddress |= ((uInt16)peek(PC++, DISASM_CODE) << 8);
+  operandAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  operandAddress |= ((uInt16)PEEK_CODE(PC++, DISASM_CODE, 2) << 8);
 }')
 
 define(M6502_ABSOLUTE_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  operandAddress |= ((uInt16)peek(PC++, DISASM_CODE) << 8);
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operandAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  operandAddress |= ((uInt16)PEEK_CODE(PC++, DISASM_CODE, 2) << 8);
+  operand = peek<debug>(operandAddress, DISASM_DATA);
+  poke<debug>(operandAddress, operand);
 }')
 
 define(M6502_ABSOLUTEX_READ, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = ((uInt16)peek(PC++, DISASM_CODE) << 8);
+  uInt16 low = PEEK_CODE(PC++, DISASM_CODE, 1);
+  uInt16 high = ((uInt16)PEEK_CODE(PC++, DISASM_CODE, 2) << 8);
   intermediateAddress = high | (uInt8)(low + X);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debug>(intermediateAddress, DISASM_DATA);
   if((low + X) > 0xFF)
   {
     intermediateAddress = (high | low) + X;
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debug>(intermediateAddress, DISASM_DATA);
   }
 }')
 
 define(M6502_ABSOLUTEX_WRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = ((uInt16)peek(PC++, DISASM_CODE) << 8);
-  peek(high | (uInt8)(low + X), DISASM_DATA);
+  uInt16 low = PEEK_CODE(PC++, DISASM_CODE, 1);
+  uInt16 high = ((uInt16)PEEK_CODE(PC++, DISASM_CODE, 2) << 8);
+  peek<debug>(high | (uInt8)(low + X), DISASM_DATA);
   operandAddress = (high | low) + X;
 }')
 
 define(M6502_ABSOLUTEX_READMODIFYWRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = ((uInt16)peek(PC++, DISASM_CODE) << 8);
-  peek(high | (uInt8)(low + X), DISASM_DATA);
+  uInt16 low = PEEK_CODE(PC++, DISASM_CODE, 1);
+  uInt16 high = ((uInt16)PEEK_CODE(PC++, DISASM_CODE, 2) << 8);
+  peek<debug>(high | (uInt8)(low + X), DISASM_DATA);
   operandAddress = (high | low) + X;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operand = peek<debug>(operandAddress, DISASM_DATA);
+  poke<debug>(operandAddress, operand);
 }')
 
 define(M6502_ABSOLUTEY_READ, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = ((uInt16)peek(PC++, DISASM_CODE) << 8);
+  uInt16 low = PEEK_CODE(PC++, DISASM_CODE, 1);
+  uInt16 high = ((uInt16)PEEK_CODE(PC++, DISASM_CODE, 2) << 8);
   intermediateAddress = high | (uInt8)(low + Y);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debug>(intermediateAddress, DISASM_DATA);
   if((low + Y) > 0xFF)
   {
     intermediateAddress = (high | low) + Y;
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debug>(intermediateAddress, DISASM_DATA);
   }
 }')
 
 define(M6502_ABSOLUTEY_WRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = ((uInt16)peek(PC++, DISASM_CODE) << 8);
-  peek(high | (uInt8)(low + Y), DISASM_DATA);
+  uInt16 low = PEEK_CODE(PC++, DISASM_CODE, 1);
+  uInt16 high = ((uInt16)PEEK_CODE(PC++, DISASM_CODE, 2) << 8);
+  peek<debug>(high | (uInt8)(low + Y), DISASM_DATA);
   operandAddress = (high | low) + Y;
 }')
 
 define(M6502_ABSOLUTEY_READMODIFYWRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = ((uInt16)peek(PC++, DISASM_CODE) << 8);
-  peek(high | (uInt8)(low + Y), DISASM_DATA);
+  uInt16 low = PEEK_CODE(PC++, DISASM_CODE, 1);
+  uInt16 high = ((uInt16)PEEK_CODE(PC++, DISASM_CODE, 2) << 8);
+  peek<debug>(high | (uInt8)(low + Y), DISASM_DATA);
   operandAddress = (high | low) + Y;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operand = peek<debug>(operandAddress, DISASM_DATA);
+  poke<debug>(operandAddress, operand);
 }')
 
 define(M6502_ZERO_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  operand = peek<debug>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZERO_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
+  operandAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
 }')
 
 define(M6502_ZERO_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operandAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  operand = peek<debug>(operandAddress, DISASM_DATA);
+  poke<debug>(operandAddress, operand);
 }')
 
 define(M6502_ZEROX_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  peek<debug>(intermediateAddress, DISASM_DATA);
   intermediateAddress += X;
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debug>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZEROX_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_DATA);
+  operandAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  peek<debug>(operandAddress, DISASM_DATA);
   operandAddress = (operandAddress + X) & 0xFF;
 }')
 
 define(M6502_ZEROX_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_DATA);
+  operandAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  peek<debug>(operandAddress, DISASM_DATA);
   operandAddress = (operandAddress + X) & 0xFF;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operand = peek<debug>(operandAddress, DISASM_DATA);
+  poke<debug>(operandAddress, operand);
 }')
 
 define(M6502_ZEROY_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  peek<debug>(intermediateAddress, DISASM_DATA);
   intermediateAddress += Y;
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debug>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZEROY_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_DATA);
+  operandAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  peek<debug>(operandAddress, DISASM_DATA);
   operandAddress = (operandAddress + Y) & 0xFF;
 }')
 
 define(M6502_ZEROY_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_DATA);
+  operandAddress = PEEK_CODE(PC++, DISASM_CODE, 1);
+  peek<debug>(operandAddress, DISASM_DATA);
   operandAddress = (operandAddress + Y) & 0xFF;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operand = peek<debug>(operandAddress, DISASM_DATA);
+  poke<debug>(operandAddress, operand);
 }')
 
 define(M6502_INDIRECT, `{
-  uInt16 addr = peek(PC++, DISASM_CODE);
-  addr |= ((uInt16)peek(PC++, DISASM_CODE) << 8);
+  uInt16 addr = PEEK_CODE(PC++, DISASM_CODE, 1);
+  addr |= ((uInt16)PEEK_CODE(PC++, DISASM_CODE, 2) << 8);
 
   // Simulate the error in the indirect addressing mode!
   uInt16 high = NOTSAMEPAGE(addr, addr + 1) ? (addr & 0xff00) : (addr + 1);
 
-  operandAddress = peek(addr, DISASM_DATA);
-  operandAddress |= ((uInt16)peek(high, DISASM_DATA) << 8);
+  operandAddress = peek<debug>(addr, DISASM_DATA);
+  operandAddress |= ((uInt16)peek<debug>(high, DISASM_DATA) << 8);
 }')
 
 define(M6502_INDIRECTX_READ, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  peek(pointer, DISASM_DATA);
+  uInt8 pointer = PEEK_CODE(PC++, DISASM_CODE, 1);
+  peek<debug>(pointer, DISASM_DATA);
   pointer += X;
-  intermediateAddress = peek(pointer++, DISASM_DATA);
-  intermediateAddress |= ((uInt16)peek(pointer, DISASM_DATA) << 8);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debug>(pointer++, DISASM_DATA);
+  intermediateAddress |= ((uInt16)peek<debug>(pointer, DISASM_DATA) << 8);
+  operand = peek<debug>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_INDIRECTX_WRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  peek(pointer, DISASM_DATA);
+  uInt8 pointer = PEEK_CODE(PC++, DISASM_CODE, 1);
+  peek<debug>(pointer, DISASM_DATA);
   pointer += X;
-  operandAddress = peek(pointer++, DISASM_DATA);
-  operandAddress |= ((uInt16)peek(pointer, DISASM_DATA) << 8);
+  operandAddress = peek<debug>(pointer++, DISASM_DATA);
+  operandAddress |= ((uInt16)peek<debug>(pointer, DISASM_DATA) << 8);
 }')
 
 define(M6502_INDIRECTX_READMODIFYWRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  peek(pointer, DISASM_DATA);
+  uInt8 pointer = PEEK_CODE(PC++, DISASM_CODE, 1);
+  peek<debug>(pointer, DISASM_DATA);
   pointer += X;
-  operandAddress = peek(pointer++, DISASM_DATA);
-  operandAddress |= ((uInt16)peek(pointer, DISASM_DATA) << 8);
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operandAddress = peek<debug>(pointer++, DISASM_DATA);
+  operandAddress |= ((uInt16)peek<debug>(pointer, DISASM_DATA) << 8);
+  operand = peek<debug>(operandAddress, DISASM_DATA);
+  poke<debug>(operandAddress, operand);
 }')
 
 define(M6502_INDIRECTY_READ, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  uInt16 low = peek(pointer++, DISASM_DATA);
-  uInt16 high = ((uInt16)peek(pointer, DISASM_DATA) << 8);
+  uInt8 pointer = PEEK_CODE(PC++, DISASM_CODE, 1);
+  uInt16 low = peek<debug>(pointer++, DISASM_DATA);
+  uInt16 high = ((uInt16)peek<debug>(pointer, DISASM_DATA) << 8);
   intermediateAddress = high | (uInt8)(low + Y);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debug>(intermediateAddress, DISASM_DATA);
   if((low + Y) > 0xFF)
   {
     intermediateAddress = (high | low) + Y;
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debug>(intermediateAddress, DISASM_DATA);
   }
 }')
 
 define(M6502_INDIRECTY_WRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  uInt16 low = peek(pointer++, DISASM_DATA);
-  uInt16 high = ((uInt16)peek(pointer, DISASM_DATA) << 8);
-  peek(high | (uInt8)(low + Y), DISASM_DATA);
+  uInt8 pointer = PEEK_CODE(PC++, DISASM_CODE, 1);
+  uInt16 low = peek<debug>(pointer++, DISASM_DATA);
+  uInt16 high = ((uInt16)peek<debug>(pointer, DISASM_DATA) << 8);
+  peek<debug>(high | (uInt8)(low + Y), DISASM_DATA);
   operandAddress = (high | low) + Y;
 }')
 
 define(M6502_INDIRECTY_READMODIFYWRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  uInt16 low = peek(pointer++, DISASM_DATA);
-  uInt16 high = ((uInt16)peek(pointer, DISASM_DATA) << 8);
-  peek(high | (uInt8)(low + Y), DISASM_DATA);
+  uInt8 pointer = PEEK_CODE(PC++, DISASM_CODE, 1);
+  uInt16 low = peek<debug>(pointer++, DISASM_DATA);
+  uInt16 high = ((uInt16)peek<debug>(pointer, DISASM_DATA) << 8);
+  peek<debug>(high | (uInt8)(low + Y), DISASM_DATA);
   operandAddress = (high | low) + Y;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operand = peek<debug>(operandAddress, DISASM_DATA);
+  poke<debug>(operandAddress, operand);
 }')
 
 
 define(M6502_BCC, `{
   if(!C)
   {
-    peek(PC, DISASM_NONE);
+    peek<debug>(PC, DISASM_NONE);
     uInt16 address = PC + (Int8)operand;
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debug>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -276,10 +286,10 @@ define(M6502_BCC, `{
 define(M6502_BCS, `{
   if(C)
   {
-    peek(PC, DISASM_NONE);
+    peek<debug>(PC, DISASM_NONE);
     uInt16 address = PC + (Int8)operand;
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debug>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -287,10 +297,10 @@ define(M6502_BCS, `{
 define(M6502_BEQ, `{
   if(!notZ)
   {
-    peek(PC, DISASM_NONE);
+    peek<debug>(PC, DISASM_NONE);
     uInt16 address = PC + (Int8)operand;
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debug>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -298,10 +308,10 @@ define(M6502_BEQ, `{
 define(M6502_BMI, `{
   if(N)
   {
-    peek(PC, DISASM_NONE);
+    peek<debug>(PC, DISASM_NONE);
     uInt16 address = PC + (Int8)operand;
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debug>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -309,10 +319,10 @@ define(M6502_BMI, `{
 define(M6502_BNE, `{
   if(notZ)
   {
-    peek(PC, DISASM_NONE);
+    peek<debug>(PC, DISASM_NONE);
     uInt16 address = PC + (Int8)operand;
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debug>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -320,10 +330,10 @@ define(M6502_BNE, `{
 define(M6502_BPL, `{
   if(!N)
   {
-    peek(PC, DISASM_NONE);
+    peek<debug>(PC, DISASM_NONE);
     uInt16 address = PC + (Int8)operand;
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debug>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -331,10 +341,10 @@ define(M6502_BPL, `{
 define(M6502_BVC, `{
   if(!V)
   {
-    peek(PC, DISASM_NONE);
+    peek<debug>(PC, DISASM_NONE);
     uInt16 address = PC + (Int8)operand;
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debug>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -342,10 +352,10 @@ define(M6502_BVC, `{
 define(M6502_BVS, `{
   if(V)
   {
-    peek(PC, DISASM_NONE);
+    peek<debug>(PC, DISASM_NONE);
     uInt16 address = PC + (Int8)operand;
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debug>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -449,7 +459,7 @@ define(M6502_ASL, `{
   C = operand & 0x80;
 
   operand <<= 1;
-  poke(operandAddress, operand);
+  poke<debug>(operandAddress, operand);
 
   notZ = operand;
   N = operand & 0x80;
@@ -484,18 +494,18 @@ define(M6502_BIT, `{
 }')
 
 define(M6502_BRK, `{
-  peek(PC++, DISASM_CODE);
+  PEEK_CODE(PC++, DISASM_CODE, 1);
 
   B = true;
 
-  poke(0x0100 + SP--, PC >> 8);
-  poke(0x0100 + SP--, PC & 0x00ff);
-  poke(0x0100 + SP--, PS());
+  poke<debug>(0x0100 + SP--, PC >> 8);
+  poke<debug>(0x0100 + SP--, PC & 0x00ff);
+  poke<debug>(0x0100 + SP--, PS());
 
   I = true;
 
-  PC = peek(0xfffe, DISASM_NONE);
-  PC |= ((uInt16)peek(0xffff, DISASM_NONE) << 8);
+  PC = peek<debug>(0xfffe, DISASM_NONE);
+  PC |= ((uInt16)peek<debug>(0xffff, DISASM_NONE) << 8);
 }')
 
 define(M6502_CLC, `{
@@ -540,7 +550,7 @@ define(M6502_CPY, `{
 
 define(M6502_DCP, `{
   uInt8 value = operand - 1;
-  poke(operandAddress, value);
+  poke<debug>(operandAddress, value);
 
   uInt16 value2 = (uInt16)A - (uInt16)value;
   notZ = value2;
@@ -550,7 +560,7 @@ define(M6502_DCP, `{
 
 define(M6502_DEC, `{
   uInt8 value = operand - 1;
-  poke(operandAddress, value);
+  poke<debug>(operandAddress, value);
 
   notZ = value;
   N = value & 0x80;
@@ -579,7 +589,7 @@ define(M6502_EOR, `{
 
 define(M6502_INC, `{
   uInt8 value = operand + 1;
-  poke(operandAddress, value);
+  poke<debug>(operandAddress, value);
 
   notZ = value;
   N = value & 0x80;
@@ -599,7 +609,7 @@ define(M6502_INY, `{
 
 define(M6502_ISB, `{
   operand = operand + 1;
-  poke(operandAddress, operand);
+  poke<debug>(operandAddress, operand);
 
   // N, V, Z, C flags are the same in either mode (C calculated at the end)
   Int32 sum = A - operand - (C ? 0 : 1);
@@ -633,16 +643,16 @@ define(M6502_JMP, `{
 }')
 
 define(M6502_JSR, `{
-  uInt8 low = peek(PC++, DISASM_CODE);
-  peek(0x0100 + SP, DISASM_NONE);
+  uInt8 low = PEEK_CODE(PC++, DISASM_CODE, 1);
+  peek<debug>(0x0100 + SP, DISASM_NONE);
 
   // It seems that the 650x does not push the address of the next instruction
   // on the stack it actually pushes the address of the next instruction
   // minus one.  This is compensated for in the RTS instruction
-  poke(0x0100 + SP--, PC >> 8);
-  poke(0x0100 + SP--, PC & 0xff);
+  poke<debug>(0x0100 + SP--, PC >> 8);
+  poke<debug>(0x0100 + SP--, PC & 0xff);
 
-  PC = (low | ((uInt16)peek(PC, DISASM_CODE) << 8));
+  PC = (low | ((uInt16)peek<debug>(PC, DISASM_CODE) << 8));
 }')
 
 define(M6502_LAS, `{
@@ -681,7 +691,7 @@ define(M6502_LSR, `{
   C = operand & 0x01;
 
   operand = (operand >> 1) & 0x7f;
-  poke(operandAddress, operand);
+  poke<debug>(operandAddress, operand);
 
   notZ = operand;
   N = operand & 0x80;
@@ -716,28 +726,28 @@ define(M6502_ORA, `{
 }')
 
 define(M6502_PHA, `{
-  poke(0x0100 + SP--, A);
+  poke<debug>(0x0100 + SP--, A);
 }')
 
 define(M6502_PHP, `{
-  poke(0x0100 + SP--, PS());
+  poke<debug>(0x0100 + SP--, PS());
 }')
 
 define(M6502_PLA, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  A = peek(0x0100 + SP, DISASM_NONE);
+  peek<debug>(0x0100 + SP++, DISASM_NONE);
+  A = peek<debug>(0x0100 + SP, DISASM_NONE);
   notZ = A;
   N = A & 0x80;
 }')
 
 define(M6502_PLP, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  PS(peek(0x0100 + SP, DISASM_NONE));
+  peek<debug>(0x0100 + SP++, DISASM_NONE);
+  PS(peek<debug>(0x0100 + SP, DISASM_NONE));
 }')
 
 define(M6502_RLA, `{
   uInt8 value = (operand << 1) | (C ? 1 : 0);
-  poke(operandAddress, value);
+  poke<debug>(operandAddress, value);
 
   A &= value;
   C = operand & 0x80;
@@ -752,7 +762,7 @@ define(M6502_ROL, `{
   C = operand & 0x80;
 
   operand = (operand << 1) | (oldC ? 1 : 0);
-  poke(operandAddress, operand);
+  poke<debug>(operandAddress, operand);
 
   notZ = operand;
   N = operand & 0x80;
@@ -777,7 +787,7 @@ define(M6502_ROR, `{
   C = operand & 0x01;
 
   operand = ((operand >> 1) & 0x7f) | (oldC ? 0x80 : 0x00);
-  poke(operandAddress, operand);
+  poke<debug>(operandAddress, operand);
 
   notZ = operand;
   N = operand & 0x80;
@@ -802,7 +812,7 @@ define(M6502_RRA, `{
   C = operand & 0x01;
 
   operand = ((operand >> 1) & 0x7f) | (oldC ? 0x80 : 0x00);
-  poke(operandAddress, operand);
+  poke<debug>(operandAddress, operand);
 
   if(!D)
   {
@@ -835,21 +845,21 @@ define(M6502_RRA, `{
 }')
 
 define(M6502_RTI, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  PS(peek(0x0100 + SP++, DISASM_NONE));
-  PC = peek(0x0100 + SP++, DISASM_NONE);
-  PC |= ((uInt16)peek(0x0100 + SP, DISASM_NONE) << 8);
+  peek<debug>(0x0100 + SP++, DISASM_NONE);
+  PS(peek<debug>(0x0100 + SP++, DISASM_NONE));
+  PC = peek<debug>(0x0100 + SP++, DISASM_NONE);
+  PC |= ((uInt16)peek<debug>(0x0100 + SP, DISASM_NONE) << 8);
 }')
 
 define(M6502_RTS, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  PC = peek(0x0100 + SP++, DISASM_NONE);
-  PC |= ((uInt16)peek(0x0100 + SP, DISASM_NONE) << 8);
-  peek(PC++, DISASM_CODE);
+  peek<debug>(0x0100 + SP++, DISASM_NONE);
+  PC = peek<debug>(0x0100 + SP++, DISASM_NONE);
+  PC |= ((uInt16)peek<debug>(0x0100 + SP, DISASM_NONE) << 8);
+  peek<debug>(PC++, DISASM_CODE);
 }')
 
 define(M6502_SAX, `{
-  poke(operandAddress, A & X);
+  poke<debug>(operandAddress, A & X);
 }')
 
 define(M6502_SBC, `{
@@ -904,26 +914,26 @@ define(M6502_SEI, `{
 define(M6502_SHA, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1)); 
+  poke<debug>(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1)); 
 }')
 
 define(M6502_SHS, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
   SP = A & X;
-  poke(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1)); 
+  poke<debug>(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1)); 
 }')
 
 define(M6502_SHX, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, X & (((operandAddress >> 8) & 0xff) + 1)); 
+  poke<debug>(operandAddress, X & (((operandAddress >> 8) & 0xff) + 1)); 
 }')
 
 define(M6502_SHY, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, Y & (((operandAddress >> 8) & 0xff) + 1)); 
+  poke<debug>(operandAddress, Y & (((operandAddress >> 8) & 0xff) + 1)); 
 }')
 
 define(M6502_SLO, `{
@@ -931,7 +941,7 @@ define(M6502_SLO, `{
   C = operand & 0x80;
 
   operand <<= 1;
-  poke(operandAddress, operand);
+  poke<debug>(operandAddress, operand);
 
   A |= operand;
   notZ = A;
@@ -943,7 +953,7 @@ define(M6502_SRE, `{
   C = operand & 0x01;
 
   operand = (operand >> 1) & 0x7f;
-  poke(operandAddress, operand);
+  poke<debug>(operandAddress, operand);
 
   A ^= operand;
   notZ = A;
@@ -951,15 +961,15 @@ define(M6502_SRE, `{
 }')
 
 define(M6502_STA, `{
-  poke(operandAddress, A);
+  poke<debug>(operandAddress, A);
 }')
 
 define(M6502_STX, `{
-  poke(operandAddress, X);
+  poke<debug>(operandAddress, X);
 }')
 
 define(M6502_STY, `{
-  poke(operandAddress, Y);
+  poke<debug>(operandAddress, Y);
 }')
 
 define(M6502_TAX, `{
@@ -30,10 +30,10 @@
 #endif
 
 #include "Sound.hxx"
+#include "SoundNull.hxx"
+#include "SoundHeadless.hxx"
 #ifdef SOUND_SUPPORT
   #include "SoundSDL.hxx"
-#else
-  #include "SoundNull.hxx"
 #endif
 
 /**
@@ -78,6 +78,20 @@ class MediaFactory
     {
       Sound* sound = (Sound*) NULL;
 
+      // Headless mode never opens the audio device
+      // The benchmark still generates samples, since that's part of the
+      // cost, and so does recording them
+      if(osystem->settings().getBool("headless"))
+      {
+      #ifdef BENCHMARK_SUPPORT
+        return new SoundHeadless(osystem);
+      #else
+        if(osystem->settings().getString("audiorecord") != "")
+          return new SoundHeadless(osystem);
+        return new SoundNull(osystem);
+      #endif
+      }
+
     #ifdef SOUND_SUPPORT
       sound = new SoundSDL(osystem);
     #else
@@ -64,6 +64,7 @@
 #include "ConsoleFont.hxx"
 #include "Widget.hxx"
 #include "Console.hxx"
+#include "TIA.hxx"
 #include "Random.hxx"
 #include "StateManager.hxx"
 #include "Version.hxx"
@@ -182,7 +183,17 @@ bool OSystem::create()
   // Get relevant information about the video hardware
   // This must be done before any graphics context is created, since
   // it may be needed to initialize the size of graphical objects
-  if(!queryVideoHardware())
+  // In headless mode, the video hardware is never touched
+  if(mySettings->getBool("headless"))
+  {
+    if(SDL_WasInit(SDL_INIT_TIMER) == 0)
+      if(SDL_Init(SDL_INIT_TIMER) < 0)
+        return false;
+
+    myDesktopWidth  = 640;
+    myDesktopHeight = 480;
+  }
+  else if(!queryVideoHardware())
     return false;
 
   ////////////////////////////////////////////////////////////////////
@@ -332,6 +343,9 @@ void OSystem::setConfigPaths()
   node = FilesystemNode(s);
   myPropertiesFile = node.getPath();
   mySettings->setValue("propsfile", node.getShortPath());
+
+  node = FilesystemNode(myBaseDir + "rominfo.cache");
+  myRomInfoCacheFile = node.getPath();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -381,6 +395,10 @@ FBInitStatus OSystem::createFrameBuffer()
   // OpenGL rendering modes, and even when they do, does it really
   // need to be dynamic?
 
+  // Headless mode never creates a window
+  if(mySettings->getBool("headless"))
+    return kFailComplete;
+
   bool firstTime = (myFrameBuffer == NULL);
   if(firstTime)
     myFrameBuffer = MediaFactory::createVideo(this);
@@ -523,14 +541,17 @@ string OSystem::createConsole(const FilesystemNode& rom, const string& md5sum,
     myConsole->initializeAudio();
     myEventHandler->reset(EventHandler::S_EMULATE);
     myEventHandler->setMouseControllerMode(mySettings->getString("usemouse"));
-    if(createFrameBuffer() != kSuccess)  // Takes care of initializeVideo()
+
+    // Headless mode only runs the emulation core, so there's no framebuffer
+    bool headless = mySettings->getBool("headless");
+    if(!headless && createFrameBuffer() != kSuccess)  // Takes care of initializeVideo()
     {
       logMessage("ERROR: Couldn't create framebuffer for console", 0);
       myEventHandler->reset(EventHandler::S_LAUNCHER);
       return "ERROR: Couldn't create framebuffer for console";
     }
 
-    if(showmessage)
+    if(showmessage && !headless)
     {
       if(id == "")
         myFrameBuffer->showMessage("New console created");
@@ -545,7 +566,8 @@ string OSystem::createConsole(const FilesystemNode& rom, const string& md5sum,
     // Update the timing info for a new console run
     resetLoopTiming();
 
-    myFrameBuffer->setCursorState();
+    if(!headless)
+      myFrameBuffer->setCursorState();
 
     // Also check if certain virtual buttons should be held down
     // These must be checked each time a new console is being created
@@ -689,10 +711,11 @@ Console* OSystem::openConsole(const FilesystemNode& romfile, string& md5,
 
   Console* console = (Console*) NULL;
 
-  // Open the cartridge image and read it in
-  uInt8* image = 0;
-  uInt32 size  = 0;
-  if((image = openROM(romfile, md5, size)) != 0)
+  // Open the cartridge image and read it in; the cart may keep using the
+  // image directly rather than making its own copy
+  uInt32 size = 0;
+  Common::SharedPtr<uInt8> image = openROM(romfile, md5, size);
+  if(image)
   {
     // Get a valid set of properties, including any entered on the commandline
     // For initial creation of the Cart, we're only concerned with the BS type
@@ -743,33 +766,31 @@ Console* OSystem::openConsole(const FilesystemNode& romfile, string& md5,
       console = new Console(this, cart, props);
   }
 
-  // Free the image since we don't need it any longer
-  if(image != 0 && size > 0)
-    delete[] image;
-
   return console;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8* OSystem::openROM(const FilesystemNode& rom, string& md5, uInt32& size)
+Common::SharedPtr<uInt8> OSystem::openROM(const FilesystemNode& rom,
+                                          string& md5, uInt32& size)
 {
   // This method has a documented side-effect:
   // It not only loads a ROM and creates an array with its contents,
   // but also adds a properties entry if the one for the ROM doesn't
   // contain a valid name
 
-  uInt8* image = 0;
-  if((size = rom.read(image)) == 0)
+  uInt8* buffer = 0;
+  if((size = rom.read(buffer)) == 0)
   {
-    delete[] image;
-    return (uInt8*) 0;
+    delete[] buffer;
+    return Common::SharedPtr<uInt8>();
   }
+  Common::SharedPtr<uInt8> image(buffer, Common::ArrayDeleter<uInt8>());
 
   // If we get to this point, we know we have a valid file to open
   // Now we make sure that the file has a valid properties entry
   // To save time, only generate an MD5 if we really need one
   if(md5 == "")
-    md5 = MD5(image, size);
+    md5 = MD5(buffer, size);
 
   // Some games may not have a name, since there may not
   // be an entry in stella.pro.  In that case, we use the rom name
@@ -909,7 +930,12 @@ uInt64 OSystem::getTicks() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::mainLoop()
 {
-  if(mySettings->getString("timing") == "sleep")
+  if(mySettings->getBool("headless"))
+  {
+    // No video or events; just run the emulation as fast as possible
+    headlessLoop();
+  }
+  else if(mySettings->getString("timing") == "sleep")
   {
     // Sleep-based wait: good for CPU, bad for graphical sync
     for(;;)
@@ -957,6 +983,37 @@ void OSystem::mainLoop()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::headlessLoop()
+{
+  if(!myConsole)
+    return;
+
+  // Frames are emulated back-to-back, without any wall-clock frame timing,
+  // and the TIA frame buffers are never drawn
+  const uInt64 frames = BSPF_max(mySettings->getInt("frames"), 0);
+  TIA& tia = myConsole->tia();
+
+  myTimingInfo.start = getTicks();
+  while(myTimingInfo.totalFrames < frames && !myQuitLoop)
+  {
+    tia.update();
+    myTimingInfo.totalFrames++;
+  }
+  myTimingInfo.current = getTicks();
+  myTimingInfo.totalTime = myTimingInfo.current - myTimingInfo.start;
+
+  ostringstream buf;
+  double executionTime   = (double) myTimingInfo.totalTime / 1000000.0;
+  double framesPerSecond = executionTime > 0.0 ?
+    (double) myTimingInfo.totalFrames / executionTime : 0.0;
+  buf << "Headless run stats:" << endl
+      << "  Total frames emulated: " << myTimingInfo.totalFrames << endl
+      << "  Total time (sec):      " << executionTime << endl
+      << "  Frames per second:     " << framesPerSecond << endl;
+  logMessage(buf.str(), 0);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool OSystem::queryVideoHardware()
 {
@@ -354,6 +354,14 @@ class OSystem
     */
     const string& propertiesFile() const { return myPropertiesFile; }
 
+    /**
+      This method should be called to get the full path of the file
+      where the launcher caches information about ROMs (rominfo.cache).
+
+      @return String representing the full path of the ROM info cache.
+    */
+    const string& romInfoCacheFile() const { return myRomInfoCacheFile; }
+
     /**
       This method should be called to get the full path of the currently
       loaded ROM.
@@ -618,6 +626,7 @@ class OSystem
     string myConfigFile;
     string myPaletteFile;
     string myPropertiesFile;
+    string myRomInfoCacheFile;
 
     FilesystemNode myRomFile;
     string myRomMD5;
@@ -686,10 +695,12 @@ class OSystem
                     (will be recalculated if necessary)
       @param size   The amount of data read into the image array
 
-      @return  Pointer to the array, with size >=0 indicating valid data
-               (calling method is responsible for deleting it)
+      @return  Shared pointer to the array, which is empty if the ROM
+               couldn't be read; the array is freed when the last
+               reference to it (usually the cartridge) goes away
     */
-    uInt8* openROM(const FilesystemNode& rom, string& md5, uInt32& size);
+    Common::SharedPtr<uInt8> openROM(const FilesystemNode& rom, string& md5,
+                                     uInt32& size);
 
     /**
       Gets all possible info about the given console.
@@ -705,6 +716,13 @@ class OSystem
     */
     void resetLoopTiming();
 
+    /**
+      The main loop used in headless mode.  Emulates the number of frames
+      given by the 'frames' setting as fast as possible, without drawing
+      anything or processing events, and reports the framerate achieved.
+    */
+    void headlessLoop();
+
     /**
       Validate the directory name, and create it if necessary.
       Also, update the settings with the new name.  For now, validation
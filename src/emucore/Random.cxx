@@ -31,7 +31,9 @@ Random::Random()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Random::initSeed()
 {
-  if(ourSystem)
+  if(ourFixedSeed)
+    myValue = ourFixedSeed;
+  else if(ourSystem)
     myValue = ourSystem->getTicks();
   else
     myValue = (uInt32)time(0);
@@ -45,3 +47,4 @@ uInt32 Random::next()
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const OSystem* Random::ourSystem = NULL;
+uInt32 Random::ourFixedSeed = 0;
@@ -63,12 +63,24 @@ class Random
     */
     static void setSystem(const OSystem* system) { ourSystem = system; }
 
+    /**
+      Class method which makes every instance created from now on start
+      from the given seed, instead of one based on the current time.
+      This makes emulation runs repeatable (a seed of 0 disables it).
+
+      @param seed  The seed to use, or 0 for time-based seeding
+    */
+    static void setFixedSeed(uInt32 seed) { ourFixedSeed = seed; }
+
   private:
     // Indicates the next random number
     uInt32 myValue;
 
     // Set the OSystem we're using
     static const OSystem* ourSystem;
+
+    // Seed used for all instances, when non-zero
+    static uInt32 ourFixedSeed;
 };
 
 #endif
@@ -82,6 +82,8 @@ Settings::Settings(OSystem* osystem)
   setInternal("sound", "true");
   setInternal("fragsize", "512");
   setInternal("freq", "31400");
+  setInternal("resampling", "medium");
+  setInternal("ratecontrol", "false");
   setInternal("volume", "100");
 
   // Input event options
@@ -135,6 +137,9 @@ Settings::Settings(OSystem* osystem)
   setInternal("loglevel", "1");
   setInternal("logtoconsole", "0");
   setInternal("tiadriven", "false");
+  setInternal("tiaspans", "true");
+  setInternal("tiasimd", "true");
+  setInternal("tiarepeat", "true");
   setInternal("cpurandom", "true");
   setInternal("ramrandom", "true");
   setInternal("avoxport", "");
@@ -153,6 +158,7 @@ Settings::Settings(OSystem* osystem)
 
   // Thumb ARM emulation options
   setInternal("thumb.trapfatal", "true");
+  setInternal("thumb.profile", "");
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -231,7 +237,7 @@ string Settings::loadCommandLine(int argc, char** argv)
       // Take care of arguments without an option or ones that shouldn't
       // be saved to the config file
       if(key == "rominfo" || key == "debug" || key == "holdreset" ||
-         key == "holdselect" || key == "takesnapshot")
+         key == "holdselect" || key == "takesnapshot" || key == "headless")
       {
         setExternal(key, "true");
         continue;
@@ -300,6 +306,9 @@ void Settings::validate()
   i = getInt("freq");
   if(!(i == 11025 || i == 22050 || i == 31400 || i == 44100 || i == 48000))
     setInternal("freq", "31400");
+  s = getString("resampling");
+  if(s != "low" && s != "medium" && s != "high")
+    setInternal("resampling", "medium");
 #endif
 
   i = getInt("joydeadzone");
@@ -395,6 +404,9 @@ void Settings::usage()
     << "  -sound        <1|0>          Enable sound generation\n"
     << "  -fragsize     <number>       The size of sound fragments (must be a power of two)\n"
     << "  -freq         <number>       Set sound sample output frequency (11025|22050|31400|44100|48000)\n"
+    << "  -resampling   <low|medium|   Set quality of resampling to the output frequency\n"
+    << "                 high>\n"
+    << "  -ratecontrol  <1|0>          Adjust sound rate slightly to keep latency low and steady\n"
     << "  -volume       <number>       Set the volume (0 - 100)\n"
     << endl
   #endif
@@ -446,8 +458,14 @@ void Settings::usage()
     << "  -holdjoy0     <U,D,L,R,F>    Start the emulator with the left joystick direction/fire button held down\n"
     << "  -holdjoy1     <U,D,L,R,F>    Start the emulator with the right joystick direction/fire button held down\n"
     << "  -tiadriven    <1|0>          Drive unused TIA pins randomly on a read/peek\n"
+    << "  -tiaspans     <1|0>          Draw TIA scanlines in runs of constant color (0 draws pixel by pixel)\n"
+    << "  -tiasimd      <1|0>          Draw TIA scanlines with SIMD instructions, if the CPU supports them\n"
+    << "  -tiarepeat    <1|0>          Copy TIA scanlines drawn from the same state as the previous one\n"
     << "  -cpurandom    <1|0>          Randomize the contents of CPU registers on reset\n"
     << "  -ramrandom    <1|0>          Randomize the contents of RAM on reset\n"
+    << "  -headless                    Run the ROM without video/audio output, then exit\n"
+    << "  -frames       <number>       Number of frames to emulate in headless mode\n"
+    << "  -audiorecord  <file>         Record the sound to file (WAV if it ends in .wav, else raw)\n"
     << "  -help                        Show the text you're now reading\n"
   #ifdef DEBUGGER_SUPPORT
     << endl
@@ -464,6 +482,8 @@ void Settings::usage()
     << "   -break         <address>    Set a breakpoint at 'address'\n"
     << "   -debug                      Start in debugger mode\n"
     << endl
+    << "   -thumb.profile <file>       Profile the ARM code of DPC+ ROMs, saving to 'file' on exit\n"
+    << endl
     << "   -bs          <arg>          Sets the 'Cartridge.Type' (bankswitch) property\n"
     << "   -type        <arg>          Same as using -bs\n"
     << "   -channels    <arg>          Sets the 'Cartridge.Sound' property\n"
@@ -0,0 +1,195 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <cassert>
+#include <cstring>
+
+#include "Array.hxx"
+#include "SignatureSearch.hxx"
+
+// Set in transitions into states where a signature ends
+#define MATCH_FLAG 0x8000
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SignatureSearch::SignatureSearch(const Signature* signatures, uInt32 count)
+  : myCount(count),
+    myNumStates(1),
+    myNumClasses(1)
+{
+  mySizes = new uInt32[myCount];
+
+  uInt32 maxStates = 1;
+  for(uInt32 i = 0; i < myCount; ++i)
+  {
+    assert(signatures[i].size > 0 && signatures[i].size <= 8);
+    mySizes[i] = signatures[i].size;
+    maxStates += signatures[i].size;
+  }
+  assert(myCount < 65535);
+
+  // The automaton is first built with a transition for every byte
+  uInt16* next = new uInt16[maxStates << 8];
+  myFail = new uInt16[maxStates];
+  myMatch = new uInt16[maxStates];
+  myMatchState = new uInt16[maxStates];
+  memset(next, 0, (maxStates << 8) * sizeof(uInt16));
+  memset(myMatch, 0, maxStates * sizeof(uInt16));
+
+  // Build the trie of all signatures; while doing so, a transition to
+  // state 0 means there's no child for that byte (the root is never a
+  // child of another state)
+  for(uInt32 i = 0; i < myCount; ++i)
+  {
+    uInt32 state = 0;
+    for(uInt32 j = 0; j < mySizes[i]; ++j)
+    {
+      uInt16& child = next[(state << 8) | signatures[i].bytes[j]];
+      if(child == 0)
+        child = myNumStates++;
+      state = child;
+    }
+    assert(myMatch[state] == 0);  // signatures must be unique
+    myMatch[state] = i + 1;
+  }
+
+  // Add the failure transitions breadth-first, so the state a failure
+  // leads to is always complete before it's needed
+  Common::Array<uInt16> queue;
+  myFail[0] = myMatchState[0] = 0;
+  for(uInt32 c = 0; c < 256; ++c)
+  {
+    uInt16 child = next[c];
+    if(child != 0)
+    {
+      myFail[child] = 0;
+      myMatchState[child] = myMatch[child] ? child : 0;
+      queue.push_back(child);
+    }
+  }
+  for(uInt32 q = 0; q < queue.size(); ++q)
+  {
+    uInt32 state = queue[q];
+    for(uInt32 c = 0; c < 256; ++c)
+    {
+      uInt16& child = next[(state << 8) | c];
+      uInt16 fallback = next[(myFail[state] << 8) | c];
+      if(child != 0)
+      {
+        myFail[child] = fallback;
+        myMatchState[child] = myMatch[child] ? child : myMatchState[fallback];
+        queue.push_back(child);
+      }
+      else
+        child = fallback;
+    }
+  }
+
+  // Bytes that appear in no signature all behave the same, so they share
+  // class 0; every other byte gets a class of its own.  This shrinks the
+  // transition table enough to stay in the L1 cache.
+  int representative[256];
+  representative[0] = -1;
+  memset(myClass, 0, sizeof(myClass));
+  for(uInt32 i = 0; i < myCount; ++i)
+  {
+    for(uInt32 j = 0; j < mySizes[i]; ++j)
+    {
+      uInt8 b = signatures[i].bytes[j];
+      if(myClass[b] == 0)
+      {
+        representative[myNumClasses] = b;
+        myClass[b] = myNumClasses++;
+      }
+    }
+  }
+  for(uInt32 b = 0; b < 256; ++b)
+  {
+    if(myClass[b] == 0)
+    {
+      representative[0] = b;
+      break;
+    }
+  }
+  assert(myNumStates * myNumClasses <= MATCH_FLAG);
+
+  // The compressed table holds the row of the next state, flagged when
+  // a signature ends there, so most bytes only cost a single lookup
+  myNext = new uInt16[myNumStates * myNumClasses];
+  for(uInt32 s = 0; s < myNumStates; ++s)
+  {
+    for(uInt32 c = 0; c < myNumClasses; ++c)
+    {
+      uInt32 child = representative[c] < 0 ? 0 :
+                     next[(s << 8) | representative[c]];
+      myNext[s * myNumClasses + c] = child * myNumClasses |
+          (myMatchState[child] != 0 ? MATCH_FLAG : 0);
+    }
+  }
+  delete[] next;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SignatureSearch::~SignatureSearch()
+{
+  delete[] mySizes;
+  delete[] myNext;
+  delete[] myFail;
+  delete[] myMatch;
+  delete[] myMatchState;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SignatureSearch::search(const uInt8* image, uInt32 size,
+                             uInt32* hits) const
+{
+  // The position where counting may resume for each signature
+  uInt32* resume = new uInt32[myCount];
+  for(uInt32 i = 0; i < myCount; ++i)
+    hits[i] = resume[i] = 0;
+
+  // A match ending at the last byte would start in the last 'size'
+  // bytes of the image, which searchForBytes never looks at
+  uInt32 row = 0;
+  for(uInt32 i = 0; i + 1 < size; ++i)
+  {
+    // Most bytes can't start a signature, and these can be skipped
+    // without waiting for the previous transition
+    if(row == 0 && myNext[myClass[image[i]]] == 0)
+      continue;
+
+    row = myNext[row + myClass[image[i]]];
+    if(!(row & MATCH_FLAG))
+      continue;
+
+    row &= ~MATCH_FLAG;
+    uInt32 state = row / myNumClasses;
+    for(uInt32 s = myMatchState[state]; s != 0; s = myMatchState[myFail[s]])
+    {
+      uInt32 sig = myMatch[s] - 1;
+      uInt32 start = i + 1 - mySizes[sig];
+      if(start >= resume[sig])
+      {
+        ++hits[sig];
+        resume[sig] = i + 2;
+      }
+    }
+  }
+
+  delete[] resume;
+}
@@ -0,0 +1,112 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef SIGNATURE_SEARCH_HXX
+#define SIGNATURE_SEARCH_HXX
+
+#include "bspf.hxx"
+
+/**
+  Searches an image for many byte signatures at once.  The signatures
+  are compiled into an Aho-Corasick automaton (a state machine with a
+  transition for every state and input byte), so a single pass over the
+  image counts the hits of all of them, whatever their number.
+
+  Hits are counted exactly as Cartridge::searchForBytes counts them: a
+  match must start before the last 'size' bytes of the image, and after
+  each counted match the search for that signature resumes one byte
+  past its end.
+
+  @author  Stella Team
+  @version $Id$
+*/
+class SignatureSearch
+{
+  public:
+    // A signature of up to 8 bytes
+    struct Signature {
+      uInt8 bytes[8];
+      uInt32 size;
+    };
+
+    /**
+      Create a search for the given signatures, which must all be
+      different from each other.
+
+      @param signatures  The signatures to search for
+      @param count       The number of signatures
+    */
+    SignatureSearch(const Signature* signatures, uInt32 count);
+
+    /**
+      Destructor
+    */
+    virtual ~SignatureSearch();
+
+  public:
+    /**
+      Count the hits of every signature in the image.
+
+      @param image  A pointer to the image
+      @param size   The size of the image
+      @param hits   Receives the number of hits for each signature, in
+                    the order they were given to the constructor
+    */
+    void search(const uInt8* image, uInt32 size, uInt32* hits) const;
+
+  private:
+    // The number of signatures
+    uInt32 myCount;
+
+    // The size of each signature
+    uInt32* mySizes;
+
+    // The number of states in the automaton
+    uInt32 myNumStates;
+
+    // The class of each input byte
+    uInt8 myClass[256];
+
+    // The number of byte classes
+    uInt32 myNumClasses;
+
+    // The transitions for each state and byte class, stored at
+    // state * myNumClasses + class; each one holds the row of the next
+    // state (state * myNumClasses), flagged when a signature ends there
+    uInt16* myNext;
+
+    // The state reached for the longest proper suffix of each state
+    uInt16* myFail;
+
+    // The signature ending in each state, plus one (0 if none)
+    uInt16* myMatch;
+
+    // The state itself or its longest suffix state where a signature
+    // ends (0 if none), so all matches are found by following myFail
+    uInt16* myMatchState;
+
+  private:
+    // Copy constructor isn't supported by this class so make it private
+    SignatureSearch(const SignatureSearch&);
+
+    // Assignment operator isn't supported by this class so make it private
+    SignatureSearch& operator = (const SignatureSearch&);
+};
+
+#endif
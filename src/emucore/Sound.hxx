@@ -127,6 +127,45 @@ class Sound : public Serializable
     */
     virtual void adjustVolume(Int8 direction) = 0;
 
+    /**
+      Sets the quality of the resampling from the TIA sound to the output
+      frequency, taking effect immediately.
+
+      @param quality  The quality, as in the 'resampling' setting
+    */
+    virtual void setResampling(const string& quality) = 0;
+
+    /**
+      Turns on or off adjusting the rate at which sound is generated to
+      keep the amount of queued sound steady, taking effect immediately.
+
+      @param enable  Either true or false, as in the 'ratecontrol' setting
+    */
+    virtual void setRateControl(bool enable) = 0;
+
+    /**
+      Answers the number of sound register writes dropped since the last
+      reset, because the sound device wasn't keeping up with them.
+
+      @return  The number of dropped register writes
+    */
+    virtual uInt32 droppedWrites() const = 0;
+
+    /**
+      Answers how the sound output is keeping up with the emulation.
+
+      @param latency    Receives the time (in ms) until a register write
+                        made now is heard
+      @param fill       Receives how full the queue of sound still to be
+                        played is, as a percentage of its target level
+      @param underruns  Receives the number of times the queue ran out
+                        since the last reset
+
+      @return  False if no sound is being output (and nothing is returned)
+    */
+    virtual bool queueStats(uInt32& latency, uInt32& fill,
+                            uInt32& underruns) const = 0;
+
   protected:
     // The OSystem for this sound object
     OSystem* myOSystem;
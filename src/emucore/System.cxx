@@ -18,6 +18,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
 #include "Device.hxx"
@@ -26,6 +27,10 @@
 #include "TIA.hxx"
 #include "System.hxx"
 
+#ifdef BENCHMARK_SUPPORT
+  #include "Bench.hxx"
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 System::System(uInt16 n, uInt16 m)
   : myAddressMask((1 << n) - 1),
@@ -38,6 +43,8 @@ System::System(uInt16 n, uInt16 m)
     myCycles(0),
     myDataBusState(0),
     myDataBusLocked(false),
+    myAccessTracking(false),
+    myInlinePeeks(true),
     mySystemInAutodetect(false)
 {
   // Make sure the arguments are reasonable
@@ -166,8 +173,42 @@ void System::setPageAccess(uInt16 page, const PageAccess& access)
 
   // Make sure the access methods make sense
   assert(access.device != 0);
+  assert(access.hotspots == 0 || myPageShift <= 6);
 
   myPageAccessTable[page] = access;
+
+  // Any instructions decoded for the page may no longer be there
+  if(myM6502 != 0)
+    myM6502->invalidateDecodedPage(page);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::setPageAccess(uInt16 page, uInt16 count, const PageAccess* access)
+{
+  // Make sure the pages are within range
+  assert(page + count <= myNumberOfPages);
+
+  memcpy(myPageAccessTable + page, access, count * sizeof(PageAccess));
+
+  // Any instructions decoded for the pages may no longer be there
+  if(myM6502 != 0)
+    for(uInt16 i = 0; i < count; ++i)
+      myM6502->invalidateDecodedPage(page + i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 System::hotspotMask(uInt16 address, uInt16 first, uInt16 last) const
+{
+  // The bitmap has room for one bit per byte of a 64-byte page
+  assert(myPageShift <= 6);
+
+  uInt64 hotspots = 0;
+  uInt16 start = address & ~myPageMask;
+  for(uInt32 i = 0; i <= myPageMask; ++i)
+    if(start + i >= first && start + i <= last)
+      hotspots |= (uInt64)1 << i;
+
+  return hotspots;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -212,24 +253,33 @@ void System::clearDirtyPages()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 System::peek(uInt16 addr, uInt8 flags)
+uInt8 System::devicePeek(const PageAccess& access, uInt16 addr, uInt8 flags)
 {
-  PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageShift];
-
 #ifdef DEBUGGER_SUPPORT
   // Set access type
-  if(access.codeAccessBase)
-    *(access.codeAccessBase + (addr & myPageMask)) |= flags;
-  else
-    access.device->setAccessFlags(addr, flags);
+  if(myAccessTracking)
+  {
+    if(access.codeAccessBase)
+      *(access.codeAccessBase + (addr & myPageMask)) |= flags;
+    else
+      access.device->setAccessFlags(addr, flags);
+  }
 #endif
 
-  // See if this page uses direct accessing or not 
+  // See if this page uses direct accessing or not (hotspots within
+  // the page are still handled by the device)
   uInt8 result;
-  if(access.directPeekBase)
+  if(access.directPeekBase &&
+     !(access.hotspots & ((uInt64)1 << (addr & myPageMask))))
     result = *(access.directPeekBase + (addr & myPageMask));
   else
+  {
+#ifdef BENCHMARK_SUPPORT
+    Bench::Timer timer(access.device == Bench::cartridge() ?
+                       Bench::Cart : Bench::NumSections);
+#endif
     result = access.device->peek(addr);
+  }
 
 #ifdef DEBUGGER_SUPPORT
   if(!myDataBusLocked)
@@ -251,9 +301,17 @@ void System::poke(uInt16 addr, uInt8 value)
     // Since we have direct access to this poke, we can dirty its page
     *(access.directPokeBase + (addr & myPageMask)) = value;
     myPageIsDirtyTable[page] = true;
+
+    // Instructions decoded from this memory are no longer valid
+    if(myM6502 != 0)
+      myM6502->invalidateDecodedMemory(access.directPokeBase);
   }
   else
   {
+#ifdef BENCHMARK_SUPPORT
+    Bench::Timer timer(access.device == Bench::cartridge() ?
+                       Bench::Cart : Bench::NumSections);
+#endif
     // The specific device informs us if the poke succeeded
     myPageIsDirtyTable[page] = access.device->poke(addr, value);
   }
@@ -268,6 +326,9 @@ void System::poke(uInt16 addr, uInt8 value)
 uInt8 System::getAccessFlags(uInt16 addr)
 {
 #ifdef DEBUGGER_SUPPORT
+  if(!myAccessTracking)
+    return 0;
+
   PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageShift];
 
   if(access.codeAccessBase)
@@ -283,6 +344,9 @@ uInt8 System::getAccessFlags(uInt16 addr)
 void System::setAccessFlags(uInt16 addr, uInt8 flags)
 {
 #ifdef DEBUGGER_SUPPORT
+  if(!myAccessTracking)
+    return;
+
   PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageShift];
 
   if(access.codeAccessBase)
@@ -296,12 +360,14 @@ void System::setAccessFlags(uInt16 addr, uInt8 flags)
 void System::lockDataBus()
 {
   myDataBusLocked = true;
+  myInlinePeeks = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void System::unlockDataBus()
 {
   myDataBusLocked = false;
+  myInlinePeeks = !myAccessTracking;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -207,6 +207,15 @@ class System : public Serializable
     */  
     uInt8 getDataBusState() const { return myDataBusState; }
 
+    /**
+      Set the current state of the data bus.  This is used by the processor
+      when it runs instructions from its decoded instruction cache, without
+      reading them through peek().
+
+      @param value  The data now on the bus
+    */
+    void setDataBusState(uInt8 value) { myDataBusState = value; }
+
     /**
       Get the current state of the data bus in the system, taking into
       account that certain bits are in Z-state (undriven).  In those
@@ -240,7 +249,19 @@ class System : public Serializable
 
       @return The byte at the specified address
     */
-    uInt8 peek(uInt16 address, uInt8 flags = 0);
+    uInt8 peek(uInt16 address, uInt8 flags = 0)
+    {
+      // Directly accessed memory is read right here, unless the debugger
+      // needs more done; everything else is left to devicePeek()
+      const PageAccess& access =
+          myPageAccessTable[(address & myAddressMask) >> myPageShift];
+      uInt16 offset = address & myPageMask;
+      if(access.directPeekBase && myInlinePeeks &&
+         !(access.hotspots & ((uInt64)1 << offset)))
+        return myDataBusState = *(access.directPeekBase + offset);
+
+      return devicePeek(access, address, flags);
+    }
 
     /**
       Change the byte at the specified address to the given value.
@@ -277,6 +298,20 @@ class System : public Serializable
     uInt8 getAccessFlags(uInt16 address);
     void setAccessFlags(uInt16 address, uInt8 flags);
 
+    /**
+      Enable/disable recording of the disassembly type flags.  Recording
+      is off by default, since only the debugger/disassembler makes use
+      of it; peek() and setAccessFlags() leave the flags untouched while
+      it's disabled, and getAccessFlags() returns no flags at all (devices
+      may not even have allocated storage for them yet).
+    */
+    void setAccessTracking(bool enable)
+    {
+      myAccessTracking = enable;
+      myInlinePeeks = !myAccessTracking && !myDataBusLocked;
+    }
+    bool accessTracking() const { return myAccessTracking; }
+
   public:
     /**
       Describes how a page can be accessed
@@ -329,13 +364,23 @@ class System : public Serializable
       */
       PageAccessType type;
 
+      /**
+        Bitmap of the addresses in this page (one bit per byte, starting
+        with the lowest address) whose reads must still be handled by the
+        device even though the page uses direct peeks.  This allows the
+        hotspots of a cartridge to share a page with directly accessed ROM;
+        see hotspotMask().
+      */
+      uInt64 hotspots;
+
       // Constructors
       PageAccess()
         : directPeekBase(0),
           directPokeBase(0),
           codeAccessBase(0),
           device(0),
-          type(System::PA_READ) { }
+          type(System::PA_READ),
+          hotspots(0) { }
 
       PageAccess(uInt8* peek, uInt8* poke, uInt8* code, Device* dev,
                  PageAccessType access)
@@ -343,7 +388,8 @@ class System : public Serializable
           directPokeBase(poke),
           codeAccessBase(code),
           device(dev),
-          type(access) { }
+          type(access),
+          hotspots(0) { }
     };
 
     /**
@@ -354,6 +400,29 @@ class System : public Serializable
     */
     void setPageAccess(uInt16 page, const PageAccess& access);
 
+    /**
+      Set the page accessing methods for a range of pages at once, by
+      copying them from the given table.  This is meant for bankswitching,
+      where the tables for each bank can be computed in advance.
+
+      @param page   The first page accessing methods should be set for
+      @param count  The number of consecutive pages to set
+      @param access The accessing methods to be used by each page
+    */
+    void setPageAccess(uInt16 page, uInt16 count, const PageAccess* access);
+
+    /**
+      Get the hotspot bitmap (see PageAccess::hotspots) for the page
+      containing the given address, where the hotspots are all addresses
+      in the range 'first' to 'last'.
+
+      @param address  An address in the page to get the bitmap for
+      @param first    The first hotspot address
+      @param last     The last hotspot address
+      @return  The bitmap of hotspots in the page (possibly zero)
+    */
+    uInt64 hotspotMask(uInt16 address, uInt16 first, uInt16 last) const;
+
     /**
       Get the page accessing method for the specified page.
 
@@ -414,6 +483,13 @@ class System : public Serializable
     */
     string name() const { return "System"; }
 
+  private:
+    /**
+      The part of peek() that isn't done inline: reads handled by the
+      device, and all reads while the access types are being recorded.
+    */
+    uInt8 devicePeek(const PageAccess& access, uInt16 address, uInt8 flags);
+
   private:
     // Mask to apply to an address before accessing memory
     const uInt16 myAddressMask;
@@ -466,6 +542,14 @@ class System : public Serializable
     // debugger is active.
     bool myDataBusLocked;
 
+    // Whether or not peek() records the disassembly type flags for
+    // each access.  This is only enabled once the debugger is used.
+    bool myAccessTracking;
+
+    // Whether or not peek() reads directly accessed memory inline, which
+    // is only possible when neither of the above is in effect
+    bool myInlinePeeks;
+
     // Whether autodetection is currently running (ie, the emulation
     // core is attempting to autodetect display settings, cart modes, etc)
     // Some parts of the codebase need to act differently in such a case
@@ -27,6 +27,10 @@
   #include "CartDebug.hxx"
 #endif
 
+#ifdef BENCHMARK_SUPPORT
+  #include "Bench.hxx"
+#endif
+
 #include "Console.hxx"
 #include "Control.hxx"
 #include "Device.hxx"
@@ -35,6 +39,7 @@
 #include "Sound.hxx"
 #include "System.hxx"
 #include "TIATables.hxx"
+#include "TIAKernel.hxx"
 
 #include "TIA.hxx"
 
@@ -63,6 +68,9 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
   // Allocate buffers for two frame buffers
   myCurrentFrameBuffer = new uInt8[160 * 320];
   myPreviousFrameBuffer = new uInt8[160 * 320];
+  myCurrentLineSources = new LineSource[320];
+  myPreviousLineSources = new LineSource[320];
+  forgetLineSources(0, 320);
 
   // Make sure all TIA bits are enabled
   enableBits(true);
@@ -78,6 +86,16 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
 
   // Should undriven pins be randomly pulled high or low?
   myTIAPinsDriven = mySettings.getBool("tiadriven");
+
+  // Draw scanlines by runs, or pixel by pixel (used for cross-checking)?
+  mySpanRenderer = mySettings.getBool("tiaspans");
+
+  // Use a vectorized kernel, when the CPU supports one?
+  myKernel = mySettings.getBool("tiasimd") ? TIAKernel::select() : 0;
+
+  // Copy full scanlines drawn from the same state as the one above them?
+  myRepeatEnabled = mySettings.getBool("tiarepeat");
+  myRepeatLine = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -85,6 +103,8 @@ TIA::~TIA()
 {
   delete[] myCurrentFrameBuffer;
   delete[] myPreviousFrameBuffer;
+  delete[] myCurrentLineSources;
+  delete[] myPreviousLineSources;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -549,6 +569,9 @@ inline void TIA::startFrame()
   uInt8* tmp = myCurrentFrameBuffer;
   myCurrentFrameBuffer = myPreviousFrameBuffer;
   myPreviousFrameBuffer = tmp;
+  LineSource* sources = myCurrentLineSources;
+  myCurrentLineSources = myPreviousLineSources;
+  myPreviousLineSources = sources;
 
   // Remember the number of clocks which have passed on the current scanline
   // so that we can adjust the frame's starting clock by this amount.  This
@@ -570,6 +593,9 @@ inline void TIA::startFrame()
   myFramePointer = myCurrentFrameBuffer;
   myFramePointerClocks = 0;
 
+  // The scanline above the first one isn't part of this frame
+  myRepeatLine = 0;
+
   // If color loss is enabled then update the color registers based on
   // the number of scanlines in the last frame that was generated
   if(myColorLossEnabled)
@@ -643,6 +669,7 @@ inline void TIA::endFrame()
     {
       memset(myCurrentFrameBuffer, 0, 160 * 320);
       memset(myPreviousFrameBuffer, 1, 160 * 320);
+      forgetLineSources(0, 320);
     }
   }
   // Did the number of scanlines decrease?
@@ -654,6 +681,8 @@ inline void TIA::endFrame()
            stride = (previousCount - myScanlineCountForLastFrame) * 160;
     memset(myCurrentFrameBuffer + offset, 0, stride);
     memset(myPreviousFrameBuffer + offset, 1, stride);
+    forgetLineSources(myScanlineCountForLastFrame,
+                      previousCount - myScanlineCountForLastFrame);
   }
 
   // Recalculate framerate. attempting to auto-correct for scanline 'jumps'
@@ -672,6 +701,24 @@ inline void TIA::endFrame()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::scanlineChanged(uInt32 line) const
+{
+  line += myFramePointerOffset / 160;
+  if(line >= 320)
+    return false;
+
+  const LineSource& current  = myCurrentLineSources[line];
+  const LineSource& previous = myPreviousLineSources[line];
+  if(current.known && previous.known &&
+     memcmp(&current.state, &previous.state, sizeof(LineState)) == 0)
+    return false;
+
+  uInt32 offset = line * 160;
+  return memcmp(myCurrentFrameBuffer + offset,
+                myPreviousFrameBuffer + offset, 160) != 0;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::scanlinePos(uInt16& x, uInt16& y) const
 {
@@ -942,6 +989,10 @@ void TIA::updateFrame(Int32 clock)
      (myClockAtLastUpdate >= clock))
     return;
 
+#ifdef BENCHMARK_SUPPORT
+  Bench::Timer timer(Bench::TIA);
+#endif
+
   // Truncate the number of cycles to update to the stop display point
   if(clock > myClockStopDisplay)
     clock = myClockStopDisplay;
@@ -1038,6 +1089,12 @@ void TIA::updateFrame(Int32 clock)
     // Remember frame pointer in case HMOVE blanks need to be handled
     uInt8* oldFramePointer = myFramePointer;
 
+    // Pixels drawn other than by renderScanline() (which remembers the
+    // state it drew the whole scanline from) can't be told apart from
+    // those of the previous frame without comparing them
+    uInt32 row = (oldFramePointer - myCurrentFrameBuffer) / 160;
+    bool wholeLine = false;
+
     // Update as much of the scanline as we can
     if(clocksToUpdate != 0)
     {
@@ -1117,32 +1174,20 @@ void TIA::updateFrame(Int32 clock)
 
         uInt8 enabledObjects = myEnabledObjects & myDisabledObjects;
         uInt32 hpos = clocksFromStartOfScanLine - HBLANK;
-        for(; myFramePointer < ending; ++myFramePointer, ++hpos)
-        {
-          uInt8 enabled = ((enabledObjects & PFBit) &&
-                           (myPF & myPFMask[hpos])) ? PFBit : 0;
 
-          if((enabledObjects & BLBit) && myBLMask[hpos])
-            enabled |= BLBit;
-
-          if((enabledObjects & P1Bit) && (myCurrentGRP1 & myP1Mask[hpos]))
-            enabled |= P1Bit;
-
-          if((enabledObjects & M1Bit) && myM1Mask[hpos])
-            enabled |= M1Bit;
-
-          if((enabledObjects & P0Bit) && (myCurrentGRP0 & myP0Mask[hpos]))
-            enabled |= P0Bit;
-
-          if((enabledObjects & M0Bit) && myM0Mask[hpos])
-            enabled |= M0Bit;
-
-          myCollision |= TIATables::CollisionMask[enabled];
-          *myFramePointer = myColorPtr[myPriorityEncoder[hpos < 80 ? 0 : 1]
-              [enabled | myPlayfieldPriorityAndScore]];
+        // Full scanlines may be copies of the one above them
+        if(myRepeatEnabled && clocksToUpdate == 160)
+        {
+          renderScanline(enabledObjects);
+          wholeLine = true;
         }
+        else
+          render(enabledObjects, hpos, hpos + clocksToUpdate);
       }
       myFramePointer = ending;
+
+      if(!wholeLine && row < 320)
+        myCurrentLineSources[row].known = false;
     }
 
     // Handle HMOVE blanks if they are enabled
@@ -1151,6 +1196,8 @@ void TIA::updateFrame(Int32 clock)
     {
       Int32 blanks = (HBLANK + 8) - clocksFromStartOfScanLine;
       memset(oldFramePointer, myColorPtr[HBLANKColor], blanks);
+      if(!wholeLine && row < 320)
+        myCurrentLineSources[row].known = false;
 
       if((clocksToUpdate + clocksFromStartOfScanLine) >= (HBLANK + 8))
         myHMOVEBlankEnabled = false;
@@ -1170,6 +1217,236 @@ void TIA::updateFrame(Int32 clock)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::render(uInt8 enabledObjects, uInt32 hpos, uInt32 end)
+{
+  if(myKernel && end - hpos >= TIAKernel::minPixels)
+    renderKernel(enabledObjects, hpos, end);
+  else if(mySpanRenderer)
+    renderSpans(enabledObjects, hpos, end);
+  else
+  {
+    for(uInt8* framePointer = myFramePointer; hpos < end; ++framePointer, ++hpos)
+    {
+      uInt8 enabled = ((enabledObjects & PFBit) &&
+                       (myPF & myPFMask[hpos])) ? PFBit : 0;
+
+      if((enabledObjects & BLBit) && myBLMask[hpos])
+        enabled |= BLBit;
+
+      if((enabledObjects & P1Bit) && (myCurrentGRP1 & myP1Mask[hpos]))
+        enabled |= P1Bit;
+
+      if((enabledObjects & M1Bit) && myM1Mask[hpos])
+        enabled |= M1Bit;
+
+      if((enabledObjects & P0Bit) && (myCurrentGRP0 & myP0Mask[hpos]))
+        enabled |= P0Bit;
+
+      if((enabledObjects & M0Bit) && myM0Mask[hpos])
+        enabled |= M0Bit;
+
+      myCollision |= TIATables::CollisionMask[enabled];
+      *framePointer = myColorPtr[myPriorityEncoder[hpos < 80 ? 0 : 1]
+          [enabled | myPlayfieldPriorityAndScore]];
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::renderScanline(uInt8 enabledObjects)
+{
+  // Everything which determines the pixels of the scanline; this is
+  // cleared first, so the padding in the structure compares equal too
+  LineState state;
+  memset(&state, 0, sizeof(state));
+  state.p0Mask = myP0Mask;
+  state.p1Mask = myP1Mask;
+  state.m0Mask = myM0Mask;
+  state.m1Mask = myM1Mask;
+  state.blMask = myBLMask;
+  state.pfMask = myPFMask;
+  state.colorPtr = myColorPtr;
+  state.pf = myPF;
+  memcpy(state.color, myColorPtr, 8);
+  state.grp0 = myCurrentGRP0;
+  state.grp1 = myCurrentGRP1;
+  state.enabledObjects = enabledObjects;
+  state.playfieldPriorityAndScore = myPlayfieldPriorityAndScore;
+  state.hmoveBlank = myHMOVEBlankEnabled;
+
+  bool repeated = myRepeatLine && myRepeatLine + 160 == myFramePointer &&
+                  memcmp(&state, &myRepeatState, sizeof(state)) == 0;
+#ifdef BENCHMARK_SUPPORT
+  Bench::tiaScanline(repeated);
+#endif
+
+  if(repeated)
+  {
+    memcpy(myFramePointer, myRepeatLine, 160);
+    myCollision |= myRepeatCollision;
+  }
+  else
+  {
+    // Draw the scanline, keeping track of its own collisions
+    uInt16 collision = myCollision;
+    myCollision = 0;
+    render(enabledObjects, 0, 160);
+    myRepeatCollision = myCollision;
+    myCollision |= collision;
+
+    memcpy(&myRepeatState, &state, sizeof(state));
+  }
+  myRepeatLine = myFramePointer;
+
+  // Remember what the scanline was drawn from, for scanlineChanged()
+  uInt32 line = (myFramePointer - myCurrentFrameBuffer) / 160;
+  if(line < 320)
+  {
+    memcpy(&myCurrentLineSources[line].state, &state, sizeof(state));
+    myCurrentLineSources[line].known = true;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::renderSpans(uInt8 enabledObjects, uInt32 hpos, uInt32 end)
+{
+  // Objects which can't be drawn anywhere on this part of the line have
+  // no edges, so they don't need to be considered at all
+  if(myCurrentGRP0 == 0)  enabledObjects &= ~P0Bit;
+  if(myCurrentGRP1 == 0)  enabledObjects &= ~P1Bit;
+  if(myPF == 0)           enabledObjects &= ~PFBit;
+
+  // Position of the next edge of each object; the output of an object is
+  // only recomputed once the current run reaches its edge
+  uInt32 pfEdge = (enabledObjects & PFBit) ? hpos : end;
+  uInt32 blEdge = (enabledObjects & BLBit) ? hpos : end;
+  uInt32 p1Edge = (enabledObjects & P1Bit) ? hpos : end;
+  uInt32 m1Edge = (enabledObjects & M1Bit) ? hpos : end;
+  uInt32 p0Edge = (enabledObjects & P0Bit) ? hpos : end;
+  uInt32 m0Edge = (enabledObjects & M0Bit) ? hpos : end;
+
+  const uInt8* p0Run = (enabledObjects & P0Bit) ? TIATables::maskRun(myP0Mask) : 0;
+  const uInt8* p1Run = (enabledObjects & P1Bit) ? TIATables::maskRun(myP1Mask) : 0;
+  const uInt8* m0Run = (enabledObjects & M0Bit) ? TIATables::maskRun(myM0Mask) : 0;
+  const uInt8* m1Run = (enabledObjects & M1Bit) ? TIATables::maskRun(myM1Mask) : 0;
+  const uInt8* blRun = (enabledObjects & BLBit) ? TIATables::maskRun(myBLMask) : 0;
+
+  uInt8* framePointer = myFramePointer;
+  uInt32 half = BSPF_min(end, 80u);
+  uInt8 enabled = 0;
+  while(hpos < end)
+  {
+    // Each playfield bit covers 4 pixels, and the edge is moved along for
+    // as long as the following bits have the same value
+    if(pfEdge == hpos)
+    {
+      bool on = myPF & myPFMask[hpos];
+      for(pfEdge = (hpos | 0x03) + 1;
+          pfEdge < end && bool(myPF & myPFMask[pfEdge]) == on; pfEdge += 4)
+        ;
+      enabled = on ? (enabled | PFBit) : (enabled & ~PFBit);
+    }
+
+    // The ball and missles have a constant output over a run of their mask
+    if(blEdge == hpos)
+    {
+      blEdge = hpos + blRun[hpos];
+      enabled = myBLMask[hpos] ? (enabled | BLBit) : (enabled & ~BLBit);
+    }
+
+    // Player output also depends on their graphics, so runs of the mask
+    // are joined for as long as the output stays the same
+    if(p1Edge == hpos)
+    {
+      bool on = myCurrentGRP1 & myP1Mask[hpos];
+      for(p1Edge = hpos + p1Run[hpos];
+          p1Edge < end && bool(myCurrentGRP1 & myP1Mask[p1Edge]) == on;
+          p1Edge += p1Run[p1Edge])
+        ;
+      enabled = on ? (enabled | P1Bit) : (enabled & ~P1Bit);
+    }
+
+    if(m1Edge == hpos)
+    {
+      m1Edge = hpos + m1Run[hpos];
+      enabled = myM1Mask[hpos] ? (enabled | M1Bit) : (enabled & ~M1Bit);
+    }
+
+    if(p0Edge == hpos)
+    {
+      bool on = myCurrentGRP0 & myP0Mask[hpos];
+      for(p0Edge = hpos + p0Run[hpos];
+          p0Edge < end && bool(myCurrentGRP0 & myP0Mask[p0Edge]) == on;
+          p0Edge += p0Run[p0Edge])
+        ;
+      enabled = on ? (enabled | P0Bit) : (enabled & ~P0Bit);
+    }
+
+    if(m0Edge == hpos)
+    {
+      m0Edge = hpos + m0Run[hpos];
+      enabled = myM0Mask[hpos] ? (enabled | M0Bit) : (enabled & ~M0Bit);
+    }
+
+    // The run ends at the nearest edge, or where the priority encoder
+    // changes at the middle of the line
+    uInt32 stop = hpos < 80 ? half : end;
+    stop = BSPF_min(stop, BSPF_min(pfEdge, blEdge));
+    stop = BSPF_min(stop, BSPF_min(p1Edge, m1Edge));
+    stop = BSPF_min(stop, BSPF_min(p0Edge, m0Edge));
+
+    // The whole run has the same objects, and hence collisions and color
+    myCollision |= TIATables::CollisionMask[enabled];
+    uInt8 color = myColorPtr[myPriorityEncoder[hpos < 80 ? 0 : 1]
+        [enabled | myPlayfieldPriorityAndScore]];
+
+    // Most runs inside objects are only a few pixels long, where calling
+    // memset costs more than it saves
+    if(stop - hpos < 16)
+      for(; hpos < stop; ++hpos)
+        *framePointer++ = color;
+    else
+    {
+      memset(framePointer, color, stop - hpos);
+      framePointer += stop - hpos;
+      hpos = stop;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::renderKernel(uInt8 enabledObjects, uInt32 hpos, uInt32 end)
+{
+  TIAKernel::Line line;
+  line.p0Mask = myP0Mask;
+  line.p1Mask = myP1Mask;
+  line.m0Mask = myM0Mask;
+  line.m1Mask = myM1Mask;
+  line.blMask = myBLMask;
+  line.pfMask = myPFMask;
+  line.grp0 = myCurrentGRP0;
+  line.grp1 = myCurrentGRP1;
+  line.pf = myPF;
+
+  // Players and playfield without any graphics can't be drawn
+  if(myCurrentGRP0 == 0)  enabledObjects &= ~P0Bit;
+  if(myCurrentGRP1 == 0)  enabledObjects &= ~P1Bit;
+  if(myPF == 0)           enabledObjects &= ~PFBit;
+  line.enabledObjects = enabledObjects;
+
+  // This is the same as what the priority encoder does for each pixel
+  // (see toggleFixedColors); score mode isn't used with debug colors
+  line.pfPriority = myPlayfieldPriorityAndScore & PriorityBit;
+  bool score = !line.pfPriority && (myPlayfieldPriorityAndScore & ScoreBit) &&
+               myColorPtr == myColor;
+  memcpy(line.color, myColorPtr, 8);
+  line.pfColor[0] = myColorPtr[score ? P0Color : PFColor];
+  line.pfColor[1] = myColorPtr[score ? P1Color : PFColor];
+
+  myCollision |= myKernel(line, myFramePointer, hpos, end);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::waitHorizontalSync()
 {
@@ -1241,6 +1518,17 @@ void TIA::clearBuffers()
 {
   memset(myCurrentFrameBuffer, 0, 160 * 320);
   memset(myPreviousFrameBuffer, 0, 160 * 320);
+  forgetLineSources(0, 320);
+
+  // There's no scanline left to copy
+  myRepeatLine = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::forgetLineSources(uInt32 line, uInt32 count)
+{
+  for(uInt32 end = BSPF_min(line + count, 320u); line < end; ++line)
+    myCurrentLineSources[line].known = myPreviousLineSources[line].known = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1371,6 +1659,10 @@ uInt8 TIA::peek(uInt16 addr)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::poke(uInt16 addr, uInt8 value)
 {
+#ifdef BENCHMARK_SUPPORT
+  Bench::tiaWrite();
+#endif
+
   addr = addr & 0x003f;
 
   Int32 clock = mySystem->cycles() * 3;
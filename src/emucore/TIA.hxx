@@ -28,6 +28,7 @@ class Sound;
 #include "Device.hxx"
 #include "System.hxx"
 #include "TIATables.hxx"
+#include "TIAKernel.hxx"
 
 /**
   This class is a device that emulates the Television Interface Adaptor 
@@ -185,6 +186,17 @@ class TIA : public Device
     uInt8* previousFrameBuffer() const
       { return myPreviousFrameBuffer + myFramePointerOffset; }
 
+    /**
+      Answers whether a scanline of the current frame buffer differs from
+      the same scanline of the previous one.  Scanlines drawn as a whole
+      from the same TIA state in both frames are known to be the same
+      without comparing their pixels.
+
+      @param line  The scanline, counting from the top of currentFrameBuffer()
+      @return  True if any pixel of the scanline changed
+    */
+    bool scanlineChanged(uInt32 line) const;
+
     /**
       Answers the width and height of the frame buffer
     */
@@ -363,6 +375,22 @@ class TIA : public Device
     // Update the current frame buffer to the specified color clock
     void updateFrame(Int32 clock);
 
+    // Draw the pixels from 'hpos' up to (but not including) 'end' on the
+    // current scanline, with the renderer selected in the settings
+    void render(uInt8 enabledObjects, uInt32 hpos, uInt32 end);
+
+    // Draw a full (visible) scanline, copying the one above it when it
+    // was drawn from the same state
+    void renderScanline(uInt8 enabledObjects);
+
+    // Draw the pixels from 'hpos' up to (but not including) 'end' on the
+    // current scanline, one run of constant object output at a time
+    void renderSpans(uInt8 enabledObjects, uInt32 hpos, uInt32 end);
+
+    // Draw the pixels from 'hpos' up to (but not including) 'end' on the
+    // current scanline with the vectorized kernel
+    void renderKernel(uInt8 enabledObjects, uInt32 hpos, uInt32 end);
+
     // Waste cycles until the current scanline is finished
     void waitHorizontalSync();
 
@@ -372,6 +400,10 @@ class TIA : public Device
     // Clear both internal TIA buffers to black (palette color 0)
     void clearBuffers();
 
+    // Forget the states the given scanlines of both frame buffers were
+    // drawn from, since their pixels were changed some other way
+    void forgetLineSources(uInt32 line, uInt32 count);
+
     // Set up bookkeeping for the next frame
     void startFrame();
 
@@ -592,6 +624,53 @@ class TIA : public Device
     // Otherwise, they take on the value previously on the databus
     bool myTIAPinsDriven;
 
+    // Indicates if scanlines are drawn as runs of constant color by
+    // renderSpans(), rather than pixel by pixel
+    bool mySpanRenderer;
+
+    // The vectorized kernel used to draw scanlines, if any (see TIAKernel)
+    TIAKernel::Render myKernel;
+
+    // The state of the TIA which determines the pixels of a full scanline
+    struct LineState
+    {
+      const uInt8* p0Mask;
+      const uInt8* p1Mask;
+      const uInt8* m0Mask;
+      const uInt8* m1Mask;
+      const uInt8* blMask;
+      const uInt32* pfMask;
+      const uInt8* colorPtr;
+      uInt32 pf;
+      uInt8 color[8];
+      uInt8 grp0;
+      uInt8 grp1;
+      uInt8 enabledObjects;
+      uInt8 playfieldPriorityAndScore;
+      bool hmoveBlank;
+    };
+
+    // Indicates if full scanlines drawn from the same state as the one
+    // above them are copied from it
+    bool myRepeatEnabled;
+
+    // The last full scanline drawn (0 if it can't be copied), the state
+    // it was drawn from and the collisions that occurred on it
+    uInt8* myRepeatLine;
+    LineState myRepeatState;
+    uInt16 myRepeatCollision;
+
+    // The state each scanline of a frame buffer was drawn from, if it was
+    // drawn as a whole from one state; these are swapped along with the
+    // frame buffers themselves
+    struct LineSource
+    {
+      LineState state;
+      bool known;
+    };
+    LineSource* myCurrentLineSources;
+    LineSource* myPreviousLineSources;
+
     // Bitmap of the objects that should be considered while drawing
     uInt8 myEnabledObjects;
 
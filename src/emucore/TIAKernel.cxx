@@ -0,0 +1,355 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include "TIATables.hxx"
+#include "TIAKernel.hxx"
+
+// The SSE2 and AVX2 kernels are compiled with function attributes, so
+// they don't depend on the compiler flags used for the rest of the code
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && \
+    (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+  #define TIA_KERNEL_SSE2
+  #define TIA_KERNEL_AVX2
+  #include <immintrin.h>
+#endif
+
+#ifdef TIA_KERNEL_SSE2
+#define SSE2 __attribute__((target("sse2")))
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// 0xFF for each of the 16 pixels where the given bytes are non-zero
+static inline SSE2 __m128i present(__m128i bytes)
+{
+  return _mm_xor_si128(_mm_cmpeq_epi8(bytes, _mm_setzero_si128()),
+                       _mm_set1_epi8(-1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// 0xFF for each of the 16 pixels where the playfield is present
+static inline SSE2 __m128i playfield(const uInt32* mask, __m128i pf)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i a = _mm_cmpeq_epi32(_mm_and_si128(
+      _mm_loadu_si128((const __m128i*)mask), pf), zero);
+  __m128i b = _mm_cmpeq_epi32(_mm_and_si128(
+      _mm_loadu_si128((const __m128i*)(mask + 4)), pf), zero);
+  __m128i c = _mm_cmpeq_epi32(_mm_and_si128(
+      _mm_loadu_si128((const __m128i*)(mask + 8)), pf), zero);
+  __m128i d = _mm_cmpeq_epi32(_mm_and_si128(
+      _mm_loadu_si128((const __m128i*)(mask + 12)), pf), zero);
+
+  // Saturating packs keep each 0/-1 result as it is
+  __m128i absent = _mm_packs_epi16(_mm_packs_epi32(a, b),
+                                   _mm_packs_epi32(c, d));
+  return _mm_xor_si128(absent, _mm_set1_epi8(-1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Take 'color' for the pixels set in 'where', and keep 'pixels' otherwise
+static inline SSE2 __m128i paint(__m128i pixels, __m128i color, __m128i where)
+{
+  return _mm_or_si128(_mm_and_si128(where, color),
+                      _mm_andnot_si128(where, pixels));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static SSE2 uInt16 renderSSE2(const TIAKernel::Line& line,
+                              uInt8* framePointer, uInt32 hpos, uInt32 end)
+{
+  const uInt8 objects = line.enabledObjects;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i grp0 = _mm_set1_epi8(line.grp0);
+  const __m128i grp1 = _mm_set1_epi8(line.grp1);
+  const __m128i pfBits = _mm_set1_epi32(line.pf);
+  const __m128i iota = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                     8, 9, 10, 11, 12, 13, 14, 15);
+
+  const __m128i bkColor = _mm_set1_epi8(line.color[BKColor]);
+  const __m128i p0Color = _mm_set1_epi8(line.color[P0Color]);
+  const __m128i p1Color = _mm_set1_epi8(line.color[P1Color]);
+  const __m128i m0Color = _mm_set1_epi8(line.color[M0Color]);
+  const __m128i m1Color = _mm_set1_epi8(line.color[M1Color]);
+  const __m128i blColor = _mm_set1_epi8(line.color[BLColor]);
+  const __m128i pfLeft  = _mm_set1_epi8(line.pfColor[0]);
+  const __m128i pfRight = _mm_set1_epi8(line.pfColor[1]);
+
+  // Collisions are only possible with at least two objects
+  const bool collide = ((objects & 0x3F) & ((objects & 0x3F) - 1)) != 0;
+  uInt16 collisions = 0;
+
+  // The last 16 pixels may overlap the ones before them; drawing those
+  // again gives the same pixels and collisions
+  for(uInt32 x = hpos; ; )
+  {
+    __m128i p0 = zero, p1 = zero, m0 = zero, m1 = zero, bl = zero, pf = zero;
+    if(objects & P0Bit)
+      p0 = present(_mm_and_si128(
+          _mm_loadu_si128((const __m128i*)(line.p0Mask + x)), grp0));
+    if(objects & P1Bit)
+      p1 = present(_mm_and_si128(
+          _mm_loadu_si128((const __m128i*)(line.p1Mask + x)), grp1));
+    if(objects & M0Bit)
+      m0 = present(_mm_loadu_si128((const __m128i*)(line.m0Mask + x)));
+    if(objects & M1Bit)
+      m1 = present(_mm_loadu_si128((const __m128i*)(line.m1Mask + x)));
+    if(objects & BLBit)
+      bl = present(_mm_loadu_si128((const __m128i*)(line.blMask + x)));
+    if(objects & PFBit)
+      pf = playfield(line.pfMask + x, pfBits);
+
+    // The playfield color changes at the middle of the line in score mode
+    __m128i pfColor;
+    if(x + 16 <= 80)
+      pfColor = pfLeft;
+    else if(x >= 80)
+      pfColor = pfRight;
+    else
+      pfColor = paint(pfLeft, pfRight, _mm_cmpgt_epi8(
+          _mm_add_epi8(_mm_set1_epi8(x - 80), iota), _mm_set1_epi8(-1)));
+
+    // Paint the objects from lowest to highest priority
+    __m128i pixels = bkColor;
+    if(line.pfPriority)
+    {
+      pixels = paint(pixels, m1Color, m1);
+      pixels = paint(pixels, p1Color, p1);
+      pixels = paint(pixels, m0Color, m0);
+      pixels = paint(pixels, p0Color, p0);
+      pixels = paint(pixels, blColor, bl);
+      pixels = paint(pixels, pfColor, pf);
+    }
+    else
+    {
+      pixels = paint(pixels, blColor, bl);
+      pixels = paint(pixels, pfColor, pf);
+      pixels = paint(pixels, m1Color, m1);
+      pixels = paint(pixels, p1Color, p1);
+      pixels = paint(pixels, m0Color, m0);
+      pixels = paint(pixels, p0Color, p0);
+    }
+    _mm_storeu_si128((__m128i*)(framePointer + (x - hpos)), pixels);
+
+    if(collide)
+    {
+      uInt32 P0 = _mm_movemask_epi8(p0), P1 = _mm_movemask_epi8(p1),
+             M0 = _mm_movemask_epi8(m0), M1 = _mm_movemask_epi8(m1),
+             BL = _mm_movemask_epi8(bl), PF = _mm_movemask_epi8(pf);
+
+      if(M0 & P1)  collisions |= Cx_M0P1;
+      if(M0 & P0)  collisions |= Cx_M0P0;
+      if(M1 & P0)  collisions |= Cx_M1P0;
+      if(M1 & P1)  collisions |= Cx_M1P1;
+      if(P0 & PF)  collisions |= Cx_P0PF;
+      if(P0 & BL)  collisions |= Cx_P0BL;
+      if(P1 & PF)  collisions |= Cx_P1PF;
+      if(P1 & BL)  collisions |= Cx_P1BL;
+      if(M0 & PF)  collisions |= Cx_M0PF;
+      if(M0 & BL)  collisions |= Cx_M0BL;
+      if(M1 & PF)  collisions |= Cx_M1PF;
+      if(M1 & BL)  collisions |= Cx_M1BL;
+      if(BL & PF)  collisions |= Cx_BLPF;
+      if(P0 & P1)  collisions |= Cx_P0P1;
+      if(M0 & M1)  collisions |= Cx_M0M1;
+    }
+
+    if(x + 16 == end)
+      break;
+    x = BSPF_min(x + 16, end - 16);
+  }
+  return collisions;
+}
+
+#undef SSE2
+#endif  // TIA_KERNEL_SSE2
+
+#ifdef TIA_KERNEL_AVX2
+#define AVX2 __attribute__((target("avx2")))
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// 0xFF for each of the 32 pixels where the given bytes are non-zero
+static inline AVX2 __m256i present32(__m256i bytes)
+{
+  return _mm256_xor_si256(_mm256_cmpeq_epi8(bytes, _mm256_setzero_si256()),
+                          _mm256_set1_epi8(-1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// 0xFF for each of the 32 pixels where the playfield is present
+static inline AVX2 __m256i playfield32(const uInt32* mask, __m256i pf)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i a = _mm256_cmpeq_epi32(_mm256_and_si256(
+      _mm256_loadu_si256((const __m256i*)mask), pf), zero);
+  __m256i b = _mm256_cmpeq_epi32(_mm256_and_si256(
+      _mm256_loadu_si256((const __m256i*)(mask + 8)), pf), zero);
+  __m256i c = _mm256_cmpeq_epi32(_mm256_and_si256(
+      _mm256_loadu_si256((const __m256i*)(mask + 16)), pf), zero);
+  __m256i d = _mm256_cmpeq_epi32(_mm256_and_si256(
+      _mm256_loadu_si256((const __m256i*)(mask + 24)), pf), zero);
+
+  // The packs work within each 128 bit half, which leaves the groups of
+  // four pixels interleaved; the permute puts them back in order
+  __m256i absent = _mm256_packs_epi16(_mm256_packs_epi32(a, b),
+                                      _mm256_packs_epi32(c, d));
+  absent = _mm256_permutevar8x32_epi32(absent,
+      _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+  return _mm256_xor_si256(absent, _mm256_set1_epi8(-1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Take 'color' for the pixels set in 'where', and keep 'pixels' otherwise
+static inline AVX2 __m256i paint32(__m256i pixels, __m256i color, __m256i where)
+{
+  return _mm256_blendv_epi8(pixels, color, where);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// The same as renderSSE2, 32 pixels at a time; parts of a line shorter
+// than that are left to the SSE2 kernel
+static AVX2 uInt16 renderAVX2(const TIAKernel::Line& line,
+                              uInt8* framePointer, uInt32 hpos, uInt32 end)
+{
+  if(end - hpos < 32)
+    return renderSSE2(line, framePointer, hpos, end);
+
+  const uInt8 objects = line.enabledObjects;
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i grp0 = _mm256_set1_epi8(line.grp0);
+  const __m256i grp1 = _mm256_set1_epi8(line.grp1);
+  const __m256i pfBits = _mm256_set1_epi32(line.pf);
+  const __m256i iota = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+      8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+      24, 25, 26, 27, 28, 29, 30, 31);
+
+  const __m256i bkColor = _mm256_set1_epi8(line.color[BKColor]);
+  const __m256i p0Color = _mm256_set1_epi8(line.color[P0Color]);
+  const __m256i p1Color = _mm256_set1_epi8(line.color[P1Color]);
+  const __m256i m0Color = _mm256_set1_epi8(line.color[M0Color]);
+  const __m256i m1Color = _mm256_set1_epi8(line.color[M1Color]);
+  const __m256i blColor = _mm256_set1_epi8(line.color[BLColor]);
+  const __m256i pfLeft  = _mm256_set1_epi8(line.pfColor[0]);
+  const __m256i pfRight = _mm256_set1_epi8(line.pfColor[1]);
+
+  // Collisions are only possible with at least two objects
+  const bool collide = ((objects & 0x3F) & ((objects & 0x3F) - 1)) != 0;
+  uInt16 collisions = 0;
+
+  // The last 32 pixels may overlap the ones before them; drawing those
+  // again gives the same pixels and collisions
+  for(uInt32 x = hpos; ; )
+  {
+    __m256i p0 = zero, p1 = zero, m0 = zero, m1 = zero, bl = zero, pf = zero;
+    if(objects & P0Bit)
+      p0 = present32(_mm256_and_si256(
+          _mm256_loadu_si256((const __m256i*)(line.p0Mask + x)), grp0));
+    if(objects & P1Bit)
+      p1 = present32(_mm256_and_si256(
+          _mm256_loadu_si256((const __m256i*)(line.p1Mask + x)), grp1));
+    if(objects & M0Bit)
+      m0 = present32(_mm256_loadu_si256((const __m256i*)(line.m0Mask + x)));
+    if(objects & M1Bit)
+      m1 = present32(_mm256_loadu_si256((const __m256i*)(line.m1Mask + x)));
+    if(objects & BLBit)
+      bl = present32(_mm256_loadu_si256((const __m256i*)(line.blMask + x)));
+    if(objects & PFBit)
+      pf = playfield32(line.pfMask + x, pfBits);
+
+    // The playfield color changes at the middle of the line in score mode
+    __m256i pfColor;
+    if(x + 32 <= 80)
+      pfColor = pfLeft;
+    else if(x >= 80)
+      pfColor = pfRight;
+    else
+      pfColor = paint32(pfLeft, pfRight, _mm256_cmpgt_epi8(
+          _mm256_add_epi8(_mm256_set1_epi8(x - 80), iota),
+          _mm256_set1_epi8(-1)));
+
+    // Paint the objects from lowest to highest priority
+    __m256i pixels = bkColor;
+    if(line.pfPriority)
+    {
+      pixels = paint32(pixels, m1Color, m1);
+      pixels = paint32(pixels, p1Color, p1);
+      pixels = paint32(pixels, m0Color, m0);
+      pixels = paint32(pixels, p0Color, p0);
+      pixels = paint32(pixels, blColor, bl);
+      pixels = paint32(pixels, pfColor, pf);
+    }
+    else
+    {
+      pixels = paint32(pixels, blColor, bl);
+      pixels = paint32(pixels, pfColor, pf);
+      pixels = paint32(pixels, m1Color, m1);
+      pixels = paint32(pixels, p1Color, p1);
+      pixels = paint32(pixels, m0Color, m0);
+      pixels = paint32(pixels, p0Color, p0);
+    }
+    _mm256_storeu_si256((__m256i*)(framePointer + (x - hpos)), pixels);
+
+    if(collide)
+    {
+      uInt32 P0 = _mm256_movemask_epi8(p0), P1 = _mm256_movemask_epi8(p1),
+             M0 = _mm256_movemask_epi8(m0), M1 = _mm256_movemask_epi8(m1),
+             BL = _mm256_movemask_epi8(bl), PF = _mm256_movemask_epi8(pf);
+
+      if(M0 & P1)  collisions |= Cx_M0P1;
+      if(M0 & P0)  collisions |= Cx_M0P0;
+      if(M1 & P0)  collisions |= Cx_M1P0;
+      if(M1 & P1)  collisions |= Cx_M1P1;
+      if(P0 & PF)  collisions |= Cx_P0PF;
+      if(P0 & BL)  collisions |= Cx_P0BL;
+      if(P1 & PF)  collisions |= Cx_P1PF;
+      if(P1 & BL)  collisions |= Cx_P1BL;
+      if(M0 & PF)  collisions |= Cx_M0PF;
+      if(M0 & BL)  collisions |= Cx_M0BL;
+      if(M1 & PF)  collisions |= Cx_M1PF;
+      if(M1 & BL)  collisions |= Cx_M1BL;
+      if(BL & PF)  collisions |= Cx_BLPF;
+      if(P0 & P1)  collisions |= Cx_P0P1;
+      if(M0 & M1)  collisions |= Cx_M0M1;
+    }
+
+    if(x + 32 == end)
+      break;
+    x = BSPF_min(x + 32, end - 32);
+  }
+  return collisions;
+}
+
+#undef AVX2
+#endif  // TIA_KERNEL_AVX2
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TIAKernel::Render TIAKernel::select()
+{
+#if defined(TIA_KERNEL_SSE2) || defined(TIA_KERNEL_AVX2)
+  __builtin_cpu_init();
+#endif
+#ifdef TIA_KERNEL_AVX2
+  if(__builtin_cpu_supports("avx2"))
+    return renderAVX2;
+#endif
+#ifdef TIA_KERNEL_SSE2
+  if(__builtin_cpu_supports("sse2"))
+    return renderSSE2;
+#endif
+
+  return 0;
+}
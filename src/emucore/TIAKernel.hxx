@@ -0,0 +1,92 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef TIA_KERNEL_HXX
+#define TIA_KERNEL_HXX
+
+#include "bspf.hxx"
+
+/**
+  Vectorized kernels for drawing the visible part of a TIA scanline, used
+  as an alternative to the scalar loops in TIA::updateFrame.  A kernel
+  works on 16 (SSE2) or 32 (AVX2) pixels at a time: it loads the rows of
+  the TIA mask tables to find which objects are present at each pixel,
+  resolves the colors of the objects in priority order, and finds the
+  collisions between them with vector ANDs.
+
+  Kernels are only compiled in for the CPU architectures that have them,
+  and the fastest one supported by the CPU is picked at runtime.  When
+  none is available, the TIA uses its scalar code instead.
+
+  @author  Stella Team
+  @version $Id$
+*/
+class TIAKernel
+{
+  public:
+    /**
+      The TIA state which determines the pixels of (part of) a scanline.
+      The masks are indexed by horizontal position, as in the TIA, and
+      objects not set in 'enabledObjects' are never drawn.
+    */
+    struct Line
+    {
+      const uInt8* p0Mask;
+      const uInt8* p1Mask;
+      const uInt8* m0Mask;
+      const uInt8* m1Mask;
+      const uInt8* blMask;
+      const uInt32* pfMask;
+
+      uInt8 grp0;
+      uInt8 grp1;
+      uInt32 pf;
+      uInt8 enabledObjects;
+
+      // Indicates if the playfield and ball have priority over the
+      // players and missles
+      bool pfPriority;
+
+      // Final colors of the objects, indexed by TIAColor; the color of
+      // the playfield is given separately for each half of the scanline,
+      // since it differs between them in score mode
+      uInt8 color[8];
+      uInt8 pfColor[2];
+    };
+
+    /**
+      A kernel draws the pixels from 'hpos' up to (but not including)
+      'end', which must be at least minPixels apart, and answers the
+      collision bits between the objects drawn (as in
+      TIATables::CollisionMask).
+    */
+    typedef uInt16 (*Render)(const Line& line, uInt8* framePointer,
+                             uInt32 hpos, uInt32 end);
+
+    // Fewest pixels a kernel can draw
+    enum { minPixels = 16 };
+
+    /**
+      Answer the fastest kernel supported by this CPU, or 0 if there
+      is none.
+    */
+    static Render select();
+};
+
+#endif
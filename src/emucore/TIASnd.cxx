@@ -17,16 +17,110 @@
 // $Id$
 //============================================================================
 
+#include <cmath>
+
 #include "System.hxx"
 #include "TIASnd.hxx"
 
+// The SSE2 code is compiled with a function attribute, so it doesn't
+// depend on the compiler flags used for the rest of the code (i386)
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && \
+    (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+  #define TIASND_SSE2
+  #include <emmintrin.h>
+#endif
+
+#ifdef TIASND_SSE2
+#define SSE2 __attribute__((target("sse2")))
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Add 'delta' times the values of a step to the buffer, four at a time
+// All step values and deltas fit in 16 bits, so each product is made by a
+// single madd (the upper half of each delta lane is zero)
+static SSE2 void addStepSSE2(Int32* buffer, const Int32* step, Int32 delta,
+                             uInt32 taps)
+{
+  const __m128i d = _mm_set1_epi32(delta & 0xffff);
+  for(uInt32 i = 0; i < taps; i += 4)
+  {
+    __m128i b = _mm_loadu_si128((const __m128i*)(buffer + i));
+    __m128i s = _mm_loadu_si128((const __m128i*)(step + i));
+    _mm_storeu_si128((__m128i*)(buffer + i), _mm_add_epi32(b, _mm_madd_epi16(s, d)));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// The running sums of the next four changes in the buffer (which are
+// cleared), as rounded samples; 'sum' holds the previous sum in all lanes
+static inline SSE2 __m128i sumSteps(Int32* buffer, __m128i& sum, int bits)
+{
+  __m128i x = _mm_loadu_si128((const __m128i*)buffer);
+  _mm_storeu_si128((__m128i*)buffer, _mm_setzero_si128());
+  x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+  x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+  x = _mm_add_epi32(x, sum);
+  sum = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+
+  return _mm_srai_epi32(_mm_add_epi32(x, _mm_set1_epi32(1 << (bits - 1))), bits);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Create samples from the changes in the buffers, four at a time, in the
+// same way as TIASound::outputSteps() (saturation does the clipping)
+// Answers the number of samples created, which is a multiple of four
+static SSE2 uInt32 outputStepsSSE2(Int32* b0, Int32* b1, Int32& sum0, Int32& sum1,
+                                   Int16*& buffer, uInt32 count, int bits,
+                                   bool stereo, bool duplicate)
+{
+  __m128i s0 = _mm_set1_epi32(sum0), s1 = _mm_set1_epi32(sum1);
+  uInt32 i = 0;
+  for(; i + 4 <= count; i += 4)
+  {
+    __m128i l = sumSteps(b0 + i, s0, bits);
+    if(stereo)
+    {
+      __m128i r = sumSteps(b1 + i, s1, bits);
+      _mm_storeu_si128((__m128i*)buffer,
+        _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r)));
+      buffer += 8;
+    }
+    else if(duplicate)
+    {
+      _mm_storeu_si128((__m128i*)buffer,
+        _mm_packs_epi32(_mm_unpacklo_epi32(l, l), _mm_unpackhi_epi32(l, l)));
+      buffer += 8;
+    }
+    else
+    {
+      _mm_storel_epi64((__m128i*)buffer, _mm_packs_epi32(l, l));
+      buffer += 4;
+    }
+  }
+  sum0 = _mm_cvtsi128_si32(s0);
+  sum1 = _mm_cvtsi128_si32(s1);
+  return i;
+}
+
+#undef SSE2
+#endif  // TIASND_SSE2
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIASound::TIASound(Int32 outputFrequency)
   : myChannelMode(Hardware2Stereo),
+    myNominalFrequency(outputFrequency),
     myOutputFrequency(outputFrequency),
     myOutputCounter(0),
-    myVolumePercentage(100)
+    myVolumePercentage(100),
+    myResampling(ResampleMedium),
+    myBandLimited(false),
+    myAveraged(false),
+    myUseSSE2(false)
 {
+#ifdef TIASND_SSE2
+  __builtin_cpu_init();
+  myUseSSE2 = __builtin_cpu_supports("sse2");
+#endif
+
   reset();
 }
 
@@ -58,15 +152,33 @@ void TIASound::reset()
     myP9[chan] = 0;
   }
 
+  myOutputFrequency = myNominalFrequency;
   myOutputCounter = 0;
+  initResampling();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASound::outputFrequency(Int32 freq)
 {
+  myNominalFrequency = myOutputFrequency = freq;
+  initResampling();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::adjustOutputFrequency(Int32 freq)
+{
+  // Only the ratio to the TIA's rate changes; the steps already being
+  // output stay valid, since they're positioned in output samples
   myOutputFrequency = freq;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::resampling(Resampling quality)
+{
+  myResampling = quality;
+  initResampling();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string TIASound::channels(uInt32 hardware, bool stereo)
 {
@@ -74,6 +186,7 @@ string TIASound::channels(uInt32 hardware, bool stereo)
     myChannelMode = Hardware1;
   else
     myChannelMode = stereo ? Hardware2Stereo : Hardware2Mono;
+  initResampling();
 
   switch(myChannelMode)
   {
@@ -180,209 +293,449 @@ void TIASound::volume(uInt32 percent)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASound::process(Int16* buffer, uInt32 samples)
 {
-  // Make temporary local copy
-  uInt8 audc0 = myAUDC[0], audc1 = myAUDC[1];
-  uInt8 p5_0 = myP5[0], p5_1 = myP5[1];
-  uInt8 div_n_cnt0 = myDivNCnt[0], div_n_cnt1 = myDivNCnt[1];
-  Int16 v0 = myVolume[0], v1 = myVolume[1];
-
   // Take external volume into account
   Int16 audv0 = (myAUDV[0] * myVolumePercentage) / 100,
         audv1 = (myAUDV[1] * myVolumePercentage) / 100;
 
+  // The volumes may have been changed directly by a register write, which
+  // happened after the samples already due
+  if(myAveraged)
+  {
+    if(myVolume[0] != myStepVolume[0] || myVolume[1] != myStepVolume[1])
+    {
+      uInt32 count = BSPF_min(samples, (uInt32)myOutputCounter / 31400);
+      myOutputCounter -= count * 31400;
+      samples -= count;
+      output(buffer, count);
+      if(samples > 0)
+        addAverageErrors();
+    }
+  }
+  else if(myBandLimited)
+    addSteps();
+
   // Loop until the sample buffer is full
   while(samples > 0)
   {
-    // Process channel 0
-    if (div_n_cnt0 > 1)
+    // Between the ticks on which their divide by n counters run out, both
+    // channels hold their output, so all samples up to the next such tick
+    // can be created at once (a counter of zero never runs out)
+    uInt32 ticks = 0xffffffff;
+    if(myDivNCnt[0] > 0) ticks = myDivNCnt[0];
+    if(myDivNCnt[1] > 0 && myDivNCnt[1] < ticks) ticks = myDivNCnt[1];
+
+    if(ticks > 1)
     {
-      div_n_cnt0--;
+      uInt32 held = hold(buffer, samples, ticks - 1);
+      if(myDivNCnt[0] > 1) myDivNCnt[0] -= held;
+      if(myDivNCnt[1] > 1) myDivNCnt[1] -= held;
+      if(samples == 0)
+        break;
     }
-    else if (div_n_cnt0 == 1)
-    {
-      int prev_bit5 = Bit5[p5_0];
-      div_n_cnt0 = myDivNMax[0];
-
-      // The P5 counter has multiple uses, so we increment it here
-      p5_0++;
-      if (p5_0 == POLY5_SIZE)
-        p5_0 = 0;
-
-      // Check clock modifier for clock tick
-      if ((audc0 & 0x02) == 0 ||
-         ((audc0 & 0x01) == 0 && Div31[p5_0]) ||
-         ((audc0 & 0x01) == 1 && Bit5[p5_0]) ||
-         ((audc0 & 0x0f) == POLY5_DIV3 && Bit5[p5_0] != prev_bit5))
-      {
-        if (audc0 & 0x04)       // Pure modified clock selected
-        {
-          if ((audc0 & 0x0f) == POLY5_DIV3) // POLY5 -> DIV3 mode
-          {
-            if ( Bit5[p5_0] != prev_bit5 )
-            {
-              myDiv3Cnt[0]--;
-              if ( !myDiv3Cnt[0] )
-              {
-                myDiv3Cnt[0] = 3;
-                v0 = v0 ? 0 : audv0;
-              }
-            }
-          }
-          else
-          {
-            // If the output was set turn it off, else turn it on
-            v0 = v0 ? 0 : audv0;
-          }
-        }
-        else if (audc0 & 0x08)  // Check for p5/p9
-        {
-          if (audc0 == POLY9)   // Check for poly9
-          {
-            // Increase the poly9 counter
-            myP9[0]++;
-            if (myP9[0] == POLY9_SIZE)
-              myP9[0] = 0;
 
-            v0 = Bit9[myP9[0]] ? audv0 : 0;
-          }
-          else if ( audc0 & 0x02 )
-          {
-            v0 = (v0 || audc0 & 0x01) ? 0 : audv0;
-          }
-          else  // Must be poly5
-          {
-            v0 = Bit5[p5_0] ? audv0 : 0;
-          }
-        }
-        else  // Poly4 is the only remaining option
-        {
-          // Increase the poly4 counter
-          myP4[0]++;
-          if (myP4[0] == POLY4_SIZE)
-            myP4[0] = 0;
+    // Process the tick on which (at least) one of the channels is clocked
+    if(myDivNCnt[0] > 1)       myDivNCnt[0]--;
+    else if(myDivNCnt[0] == 1) clockChannel(0, audv0);
 
-          v0 = Bit4[myP4[0]] ? audv0 : 0;
-        }
-      }
-    }
+    if(myDivNCnt[1] > 1)       myDivNCnt[1]--;
+    else if(myDivNCnt[1] == 1) clockChannel(1, audv1);
 
-    // Process channel 1
-    if (div_n_cnt1 > 1)
+    if(myAveraged)
+      addAverageErrors();
+    else if(myBandLimited)
+      addSteps();
+
+    // Channels are often clocked every few ticks, so the samples for a
+    // single tick are counted here, the same way hold() does it
+    uInt32 count = 0;
+    myOutputCounter += myOutputFrequency;
+    while(count < samples && myOutputCounter >= 31400)
     {
-      div_n_cnt1--;
+      myOutputCounter -= 31400;
+      ++count;
     }
-    else if (div_n_cnt1 == 1)
+    if(count > 0)
     {
-      int prev_bit5 = Bit5[p5_1];
+      output(buffer, count);
+      samples -= count;
+    }
+  }
+
+  if(myPendingSamples > 0)
+    outputSteps(buffer);
+}
 
-      div_n_cnt1 = myDivNMax[1];
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TIASound::hold(Int16*& buffer, uInt32& samples, uInt32 ticks)
+{
+  if(ticks == 0)
+    return 0;
 
-      // The P5 counter has multiple uses, so we increment it here
-      p5_1++;
-      if (p5_1 == POLY5_SIZE)
-        p5_1 = 0;
+  // Every tick adds the output frequency to the output counter, after
+  // which a sample is created for each 31400 it holds
+  // Runs are mostly short, and then 32 bits are plenty to work this out
+  if(ticks < 0x4000 && myOutputFrequency < 0x40000)
+  {
+    uInt32 frequency = myOutputFrequency,
+           total = (uInt32)myOutputCounter + ticks * frequency,
+           count = total / 31400;
+    if(count >= samples)
+    {
+      // The buffer fills up first, on the earliest tick giving enough samples
+      // (which ends every call to process(), so it's worth being quick too)
+      uInt32 counter = myOutputCounter, wanted = samples * 31400,
+             needed = wanted > counter ? wanted - counter : 0;
+      ticks = BSPF_max((needed + frequency - 1) / frequency, 1u);
+      total = counter + ticks * frequency;
+      count = samples;
+    }
+    myOutputCounter = (Int32)(total - count * 31400);
+    samples -= count;
+    output(buffer, count);
+    return ticks;
+  }
 
-      // Check clock modifier for clock tick
-      if ((audc1 & 0x02) == 0 ||
-         ((audc1 & 0x01) == 0 && Div31[p5_1]) ||
-         ((audc1 & 0x01) == 1 && Bit5[p5_1]) ||
-         ((audc1 & 0x0f) == POLY5_DIV3 && Bit5[p5_1] != prev_bit5))
+  Int64 counter = myOutputCounter;
+  Int64 available = (counter + (Int64)ticks * myOutputFrequency) / 31400;
+  uInt32 count = samples;
+  if(available >= count)
+  {
+    // The buffer fills up first, on the earliest tick giving enough samples
+    Int64 needed = (Int64)count * 31400 - counter;
+    Int64 t = (needed + myOutputFrequency - 1) / myOutputFrequency;
+    ticks = t > 1 ? (uInt32)t : 1;
+  }
+  else
+    count = (uInt32)available;
+
+  myOutputCounter =
+    (Int32)(counter + (Int64)ticks * myOutputFrequency - (Int64)count * 31400);
+  samples -= count;
+
+  output(buffer, count);
+  return ticks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::output(Int16*& buffer, uInt32 count)
+{
+  if(myBandLimited)
+  {
+    // The samples are only created from the steps once there are plenty
+    // of them (or at the end of process()), so that it's done in long runs
+    myPendingSamples += count;
+    if(myStepPos + myPendingSamples >= STEP_SIZE)
+      outputSteps(buffer);
+    return;
+  }
+
+  Int16 v0 = myVolume[0], v1 = myVolume[1];
+  if(myAveraged && count > 0)
+  {
+    // The output can only have changed during the first sample, so only
+    // it differs from the current output
+    Int32 e0 = myAverageError[0], e1 = myAverageError[1];
+    myAverageError[0] = myAverageError[1] = 0;
+    switch(myChannelMode)
+    {
+      case Hardware2Mono:  // mono sampling with 2 hardware channels
       {
-        if (audc1 & 0x04)       // Pure modified clock selected
-        {
-          if ((audc1 & 0x0f) == POLY5_DIV3)   // POLY5 -> DIV3 mode
-          {
-            if ( Bit5[p5_1] != prev_bit5 )
-            {
-              myDiv3Cnt[1]--;
-              if ( ! myDiv3Cnt[1] )
-              {
-                myDiv3Cnt[1] = 3;
-                v1 = v1 ? 0 : audv1;
-              }
-            }
-          }
-          else
-          {
-            // If the output was set turn it off, else turn it on
-            v1 = v1 ? 0 : audv1;
-          }
-        }
-        else if (audc1 & 0x08)  // Check for p5/p9
-        {
-          if (audc1 == POLY9)   // Check for poly9
-          {
-            // Increase the poly9 counter
-            myP9[1]++;
-            if (myP9[1] == POLY9_SIZE)
-              myP9[1] = 0;
+        Int16 byte = averageOutput(v0 + v1, e0 + e1);
+        *(buffer++) = byte;
+        *(buffer++) = byte;
+        break;
+      }
 
-            v1 = Bit9[myP9[1]] ? audv1 : 0;
-          }
-          else if ( audc1 & 0x02 )
-          {
-            v1 = (v1 || audc1 & 0x01) ? 0 : audv1;
-          }
-          else  // Must be poly5
-          {
-            v1 = Bit5[p5_1] ? audv1 : 0;
-          }
-        }
-        else  // Poly4 is the only remaining option
-        {
-          // Increase the poly4 counter
-          myP4[1]++;
-          if (myP4[1] == POLY4_SIZE)
-            myP4[1] = 0;
+      case Hardware2Stereo:  // stereo sampling with 2 hardware channels
+        *(buffer++) = averageOutput(v0, e0);
+        *(buffer++) = averageOutput(v1, e1);
+        break;
 
-          v1 = Bit4[myP4[1]] ? audv1 : 0;
-        }
+      case Hardware1:  // mono/stereo sampling with only 1 hardware channel
+        *(buffer++) = averageOutput(v0 + v1, e0 + e1);
+        break;
+    }
+    --count;
+  }
+
+  switch(myChannelMode)
+  {
+    case Hardware2Mono:  // mono sampling with 2 hardware channels
+    {
+      Int16 byte = v0 + v1;
+      for(uInt32 i = 0; i < count; ++i)
+      {
+        *(buffer++) = byte;
+        *(buffer++) = byte;
       }
+      break;
     }
 
-    myOutputCounter += myOutputFrequency;
+    case Hardware2Stereo:  // stereo sampling with 2 hardware channels
+      for(uInt32 i = 0; i < count; ++i)
+      {
+        *(buffer++) = v0;
+        *(buffer++) = v1;
+      }
+      break;
+
+    case Hardware1:  // mono/stereo sampling with only 1 hardware channel
+    {
+      Int16 byte = v0 + v1;
+      for(uInt32 i = 0; i < count; ++i)
+        *(buffer++) = byte;
+      break;
+    }
+  }
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::outputSteps(Int16*& buffer)
+{
+  // The output is the sum of all steps so far; the samples are created
+  // in parts which end where the step buffer must be moved
+  Int32 sum0 = myStepSum[0], sum1 = myStepSum[1];
+  for(uInt32 left = myPendingSamples; left > 0; )
+  {
+    uInt32 part = BSPF_min(left, (uInt32)STEP_SIZE - myStepPos);
+    Int32 *b0 = myStepBuffer[0] + myStepPos, *b1 = myStepBuffer[1] + myStepPos;
+    uInt32 i = 0;
+#ifdef TIASND_SSE2
+    if(myUseSSE2)
+      i = outputStepsSSE2(b0, b1, sum0, sum1, buffer, part, STEP_BITS,
+                          myChannelMode == Hardware2Stereo,
+                          myChannelMode == Hardware2Mono);
+#endif
     switch(myChannelMode)
     {
       case Hardware2Mono:  // mono sampling with 2 hardware channels
-        while((samples > 0) && (myOutputCounter >= 31400))
+        for(; i < part; ++i)
         {
-          Int16 byte = v0 + v1;
+          sum0 += b0[i];  b0[i] = 0;
+          Int16 byte = stepOutput(sum0);
           *(buffer++) = byte;
           *(buffer++) = byte;
-          myOutputCounter -= 31400;
-          samples--;
         }
         break;
 
       case Hardware2Stereo:  // stereo sampling with 2 hardware channels
-        while((samples > 0) && (myOutputCounter >= 31400))
+        for(; i < part; ++i)
         {
-          *(buffer++) = v0;
-          *(buffer++) = v1;
-          myOutputCounter -= 31400;
-          samples--;
+          sum0 += b0[i];  b0[i] = 0;
+          sum1 += b1[i];  b1[i] = 0;
+          *(buffer++) = stepOutput(sum0);
+          *(buffer++) = stepOutput(sum1);
         }
         break;
 
       case Hardware1:  // mono/stereo sampling with only 1 hardware channel
-        while((samples > 0) && (myOutputCounter >= 31400))
+        for(; i < part; ++i)
         {
-          *(buffer++) = v0 + v1;
-          myOutputCounter -= 31400;
-          samples--;
+          sum0 += b0[i];  b0[i] = 0;
+          *(buffer++) = stepOutput(sum0);
         }
         break;
     }
+    myStepPos += part;
+    left -= part;
+
+    if(myStepPos == STEP_SIZE)
+    {
+      for(int chan = 0; chan <= 1; ++chan)
+      {
+        Int32* b = myStepBuffer[chan];
+        memmove(b, b + STEP_SIZE, (STEP_TAPS + 4) * sizeof(Int32));
+        memset(b + STEP_TAPS + 4, 0, STEP_SIZE * sizeof(Int32));
+      }
+      myStepPos = 0;
+    }
+  }
+  myStepSum[0] = sum0;
+  myStepSum[1] = sum1;
+  myPendingSamples = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::clockChannel(uInt8 chan, Int16 audv)
+{
+  uInt8 audc = myAUDC[chan];
+  Int16& v = myVolume[chan];
+  uInt8& p5 = myP5[chan];
+  int prev_bit5 = Bit5[p5];
+
+  myDivNCnt[chan] = myDivNMax[chan];
+
+  // The P5 counter has multiple uses, so we increment it here
+  p5++;
+  if (p5 == POLY5_SIZE)
+    p5 = 0;
+
+  // Check clock modifier for clock tick
+  if ((audc & 0x02) == 0 ||
+     ((audc & 0x01) == 0 && Div31[p5]) ||
+     ((audc & 0x01) == 1 && Bit5[p5]) ||
+     ((audc & 0x0f) == POLY5_DIV3 && Bit5[p5] != prev_bit5))
+  {
+    if (audc & 0x04)       // Pure modified clock selected
+    {
+      if ((audc & 0x0f) == POLY5_DIV3) // POLY5 -> DIV3 mode
+      {
+        if ( Bit5[p5] != prev_bit5 )
+        {
+          myDiv3Cnt[chan]--;
+          if ( !myDiv3Cnt[chan] )
+          {
+            myDiv3Cnt[chan] = 3;
+            v = v ? 0 : audv;
+          }
+        }
+      }
+      else
+      {
+        // If the output was set turn it off, else turn it on
+        v = v ? 0 : audv;
+      }
+    }
+    else if (audc & 0x08)  // Check for p5/p9
+    {
+      if (audc == POLY9)   // Check for poly9
+      {
+        // Increase the poly9 counter
+        myP9[chan]++;
+        if (myP9[chan] == POLY9_SIZE)
+          myP9[chan] = 0;
+
+        v = Bit9[myP9[chan]] ? audv : 0;
+      }
+      else if ( audc & 0x02 )
+      {
+        v = (v || audc & 0x01) ? 0 : audv;
+      }
+      else  // Must be poly5
+      {
+        v = Bit5[p5] ? audv : 0;
+      }
+    }
+    else  // Poly4 is the only remaining option
+    {
+      // Increase the poly4 counter
+      myP4[chan]++;
+      if (myP4[chan] == POLY4_SIZE)
+        myP4[chan] = 0;
+
+      v = Bit4[myP4[chan]] ? audv : 0;
+    }
   }
+}
 
-  // Save for next round
-  myP5[0] = p5_0;
-  myP5[1] = p5_1;
-  myVolume[0] = v0;
-  myVolume[1] = v1;
-  myDivNCnt[0] = div_n_cnt0;
-  myDivNCnt[1] = div_n_cnt1;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::initResampling()
+{
+  // Samples at the TIA's own rate are exact, so need no resampling
+  bool resampled = myResampling != ResampleLow && myNominalFrequency != 31400;
+  myBandLimited = resampled && myResampling == ResampleHigh;
+  myAveraged = resampled && myResampling == ResampleMedium;
+
+  memset(myStepBuffer, 0, sizeof(myStepBuffer));
+  myStepSum[0] = myStepSum[1] = 0;
+  myStepVolume[0] = myStepVolume[1] = 0;
+  myStepPos = myPendingSamples = 0;
+  myAverageError[0] = myAverageError[1] = 0;
+  if(!myBandLimited)
+    return;
+
+  // A step is the integral of a Blackman windowed sinc, which passes
+  // frequencies up to 95% of the output Nyquist frequency
+  const double PI = 3.14159265358979323846;
+  const double cutoff = 0.95, length = STEP_TAPS - 1;
+
+  for(int phase = 0; phase < STEP_PHASES; ++phase)
+  {
+    // Each value is the area of the windowed sinc over one sample period,
+    // for a step the given fraction of a sample before the first one
+    double frac = (phase + 0.5) / STEP_PHASES, area[STEP_TAPS], total = 0;
+    for(uInt32 tap = 0; tap < STEP_TAPS; ++tap)
+    {
+      area[tap] = 0;
+      for(int i = 0; i < 8; ++i)
+      {
+        double x = tap - frac + (i + 0.5) / 8;
+        if(x <= 0 || x >= length)
+          continue;
+
+        double u = x / length, y = cutoff * PI * (x - length / 2);
+        area[tap] += (0.42 - 0.5 * cos(2 * PI * u) + 0.08 * cos(4 * PI * u)) *
+                     (y != 0 ? sin(y) / y : 1.0);
+      }
+      total += area[tap];
+    }
+
+    // Any rounding error goes into the largest value, so that a step
+    // always adds up to exactly the change in volume
+    Int32 sum = 0;
+    uInt32 largest = 0;
+    for(uInt32 tap = 0; tap < STEP_TAPS; ++tap)
+    {
+      myStepTable[phase][tap] =
+        (Int32)floor(area[tap] / total * (1 << STEP_BITS) + 0.5);
+      sum += myStepTable[phase][tap];
+      if(myStepTable[phase][tap] > myStepTable[phase][largest])
+        largest = tap;
+    }
+    myStepTable[phase][largest] += (1 << STEP_BITS) - sum;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::addSteps()
+{
+  Int32 delta0 = myVolume[0] - myStepVolume[0],
+        delta1 = myVolume[1] - myStepVolume[1];
+  myStepVolume[0] = myVolume[0];
+  myStepVolume[1] = myVolume[1];
+
+  // Both channels share a buffer unless they're output separately
+  if(myChannelMode == Hardware2Stereo)
+  {
+    if(delta0 != 0) addStep(myStepBuffer[0], delta0);
+    if(delta1 != 0) addStep(myStepBuffer[1], delta1);
+  }
+  else if(delta0 + delta1 != 0)
+    addStep(myStepBuffer[0], delta0 + delta1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::addStep(Int32* buffer, Int32 delta)
+{
+  // The current tick starts myOutputCounter / 31400 samples before the
+  // one after the next sample still to be created
+  uInt32 counter = myOutputCounter,
+         phase = (counter % 31400) * STEP_PHASES / 31400;
+  const Int32* step = myStepTable[phase];
+  buffer += myStepPos + myPendingSamples + counter / 31400;
+
+#ifdef TIASND_SSE2
+  if(myUseSSE2)
+  {
+    addStepSSE2(buffer, step, delta, STEP_TAPS);
+    return;
+  }
+#endif
+
+  // Steps are a multiple of four samples long, and each group of four is
+  // read before any of it is written, so the compiler can turn a group
+  // into a single vector operation
+  for(uInt32 i = 0; i < STEP_TAPS; i += 4)
+  {
+    Int32 b0 = buffer[i]   + delta * step[i],
+          b1 = buffer[i+1] + delta * step[i+1],
+          b2 = buffer[i+2] + delta * step[i+2],
+          b3 = buffer[i+3] + delta * step[i+3];
+    buffer[i]   = b0;
+    buffer[i+1] = b1;
+    buffer[i+2] = b2;
+    buffer[i+3] = b3;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -28,12 +28,26 @@
 
   Currently, the sound generation routines work at 31400Hz only.
   Resampling can be done by passing in a different output frequency.
+  Since the TIA output only ever steps between volume levels, this is
+  done by adding a band-limited step (a windowed sinc, integrated) to the
+  output for every change of level, at its exact position between two
+  output samples, instead of taking the nearest 31400Hz sample.  A cheaper
+  way is to average the output over each sample, which only needs the
+  position of the changes within the sample they fall into.
 
   @author  Bradford W. Mott, Stephen Anthony, z26 and MESS teams
   @version $Id$
 */
 class TIASound
 {
+  public:
+    // The quality levels for resampling to the output frequency
+    enum Resampling {
+      ResampleLow,     // nearest 31400Hz sample
+      ResampleMedium,  // average over each sample
+      ResampleHigh     // band-limited steps
+    };
+
   public:
     /**
       Create a new TIA Sound object using the specified output frequency
@@ -52,10 +66,27 @@ class TIASound
     void reset();
 
     /**
-      Set the frequency output samples should be generated at
+      Set the frequency output samples should be generated at.  This also
+      decides whether they're resampled, and forgets any steps still being
+      output, so it's meant for setting up the sound device only.
     */
     void outputFrequency(Int32 freq);
 
+    /**
+      Generate samples at a rate slightly off the output frequency, which
+      is cheap enough to do for every fragment.  Whether the samples are
+      resampled is still decided by the output frequency alone.
+    */
+    void adjustOutputFrequency(Int32 freq);
+
+    /**
+      Set the quality of the resampling to the output frequency.  Nothing
+      is resampled when the output frequency is 31400Hz.
+
+      @param quality  The quality level to use
+    */
+    void resampling(Resampling quality);
+
     /**
       Selects the number of audio channels per sample.  There are two factors
       to consider: hardware capability and desired mixing.
@@ -102,6 +133,98 @@ class TIASound
   private:
     void polyInit(uInt8* poly, int size, int f0, int f1);
 
+    /**
+      Create samples for up to the given number of 31400Hz ticks, during
+      which neither channel changes its output, stopping early if the
+      buffer fills up.
+
+      @param buffer   The location to store samples; it's advanced past them
+      @param samples  The number of samples still to create; it's reduced
+                      by the number created
+      @param ticks    The number of ticks the output is held for
+      @return  The number of ticks actually processed
+    */
+    uInt32 hold(Int16*& buffer, uInt32& samples, uInt32 ticks);
+
+    /**
+      Store the given number of samples of the current output, the first
+      one averaged over any changes since the last sample.  When
+      band-limiting, the samples are only counted as pending, and are
+      created by outputSteps() later on.
+
+      @param buffer  The location to store samples; it's advanced past them
+      @param count   The number of samples to store
+    */
+    void output(Int16*& buffer, uInt32 count);
+
+    /**
+      Create all pending samples from the band-limited steps.
+
+      @param buffer  The location to store samples; it's advanced past them
+    */
+    void outputSteps(Int16*& buffer);
+
+    /**
+      Clock the given channel once its divide by n counter has run out,
+      updating its polynomial counters and its output.
+
+      @param chan  The channel to clock
+      @param audv  The volume of the channel, when its output is set
+    */
+    void clockChannel(uInt8 chan, Int16 audv);
+
+    /**
+      Create the band-limited steps for the current resampling quality,
+      and forget about any steps still being output.
+    */
+    void initResampling();
+
+    /**
+      Add band-limited steps to the output for the channels whose volume
+      has changed since the last steps, at the start of the current tick.
+    */
+    void addSteps();
+
+    /**
+      Add a band-limited step of the given size to the given buffer, at
+      the start of the current tick.
+    */
+    void addStep(Int32* buffer, Int32 delta);
+
+    /**
+      When averaging, add the changes in volume since the last call, at
+      the start of the current tick, to the error of the next sample.  The
+      next sample must still be to come, which it is during process(), as
+      long as there's room for it.
+    */
+    inline void addAverageErrors()
+    {
+      Int32 phase = (uInt32)myOutputCounter * STEP_PHASES / 31400;
+      myAverageError[0] += (myVolume[0] - myStepVolume[0]) * phase;
+      myAverageError[1] += (myVolume[1] - myStepVolume[1]) * phase;
+      myStepVolume[0] = myVolume[0];
+      myStepVolume[1] = myVolume[1];
+    }
+
+    /**
+      Convert a volume, and the error of a sample averaged over a change
+      to it, to the sample (an average volume is never negative).
+    */
+    static inline Int16 averageOutput(Int32 volume, Int32 error)
+    {
+      return (uInt32)(volume * STEP_PHASES - error + STEP_PHASES / 2) / STEP_PHASES;
+    }
+
+    /**
+      Convert a sum of steps to a sample, rounding and clipping it (the
+      steps overshoot a little at the edges).
+    */
+    static inline Int16 stepOutput(Int32 sum)
+    {
+      sum = (sum + (1 << (STEP_BITS - 1))) >> STEP_BITS;
+      return sum < -32768 ? -32768 : sum > 32767 ? 32767 : sum;
+    }
+
   private:
     // Definitions for AUDCx (15, 16)
     enum AUDCxRegister
@@ -129,8 +252,12 @@ class TIASound
       POLY5_SIZE = 0x001f,
       POLY9_SIZE = 0x01ff,
       DIV3_MASK  = 0x0c,
-      AUDV_SHIFT = 10     // shift 2 positions for AUDV,
+      AUDV_SHIFT = 10,    // shift 2 positions for AUDV,
                           // then another 8 for 16-bit sound
+      STEP_PHASES = 64,   // positions of a step between two samples
+      STEP_TAPS   = 32,   // length of a step (in samples)
+      STEP_BITS   = 15,   // fixed point bits of step values
+      STEP_SIZE   = 256   // samples output between moving the step buffer
     };
 
     enum ChannelMode {
@@ -156,10 +283,40 @@ class TIASound
     uInt8 myDiv3Cnt[2]; // Div 3 counter, used for POLY5_DIV3 mode
 
     ChannelMode myChannelMode;
-    Int32  myOutputFrequency;
+    Int32  myNominalFrequency;  // as set by outputFrequency()
+    Int32  myOutputFrequency;   // as adjusted by adjustOutputFrequency()
     Int32  myOutputCounter;
     uInt32 myVolumePercentage;
 
+    // Band-limited steps, for each position between two samples; the
+    // values of each step add up to exactly 1 << STEP_BITS, and each of
+    // them (like the change in volume it's multiplied by) fits in 16 bits
+    Resampling myResampling;
+    bool   myBandLimited;
+    bool   myAveraged;
+    Int32  myStepTable[STEP_PHASES][STEP_TAPS];
+
+    // The changes in output still to come for the next samples (one
+    // buffer for each hardware channel, starting at myStepPos), the sum of
+    // all previous changes, and the volume of each sound channel the
+    // steps so far add up to.  Steps never wrap around the buffers; the
+    // changes still to come are moved to the start every STEP_SIZE samples.
+    // The samples from myStepPos on that the output has already moved
+    // past, but which are yet to be created, are counted separately.
+    Int32  myStepBuffer[2][STEP_SIZE + STEP_TAPS + 4];
+    Int32  myStepSum[2];
+    uInt32 myStepPos;
+    uInt32 myPendingSamples;
+    Int16  myStepVolume[2];
+
+    // When averaging, how much the next sample is below the current
+    // output, for each sound channel (in 1 / STEP_PHASES of a volume); the
+    // volumes these are up to date with are kept in myStepVolume
+    Int32  myAverageError[2];
+
+    // Whether the CPU supports the SSE2 code for the steps
+    bool myUseSSE2;
+
     /*
       Initialize the bit patterns for the polynomials (at runtime).
 
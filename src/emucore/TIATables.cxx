@@ -31,6 +31,7 @@ void TIATables::computeAllTables()
   buildMxMaskTable();
   buildBLMaskTable();
   buildPFMaskTable();
+  buildMaskRunTables();
   buildGRPReflectTable();
   buildPxPosResetWhenTable();
 }
@@ -401,6 +402,52 @@ void TIATables::buildPFMaskTable()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIATables::buildMaskRunTable(const uInt8* mask, uInt8* run, uInt32 size)
+{
+  // Work backwards from the end of the row, so each run is one longer
+  // than the one following it (unless the mask value changes)
+  run[size - 1] = 1;
+  for(Int32 x = size - 2; x >= 0; --x)
+    run[x] = (mask[x] == mask[x + 1] && run[x + 1] < 255) ? run[x + 1] + 1 : 1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIATables::buildMaskRunTables()
+{
+  for(Int32 suppress = 0; suppress < 2; ++suppress)
+    for(Int32 nusiz = 0; nusiz < 8; ++nusiz)
+      buildMaskRunTable(PxMask[suppress][nusiz], PxMaskRun[suppress][nusiz], 320);
+
+  for(Int32 number = 0; number < 8; ++number)
+    for(Int32 size = 0; size < 5; ++size)
+      buildMaskRunTable(MxMask[number][size], MxMaskRun[number][size], 320);
+
+  for(Int32 size = 0; size < 4; ++size)
+    buildMaskRunTable(BLMask[size], BLMaskRun[size], 320);
+
+  buildMaskRunTable(DisabledMask, DisabledMaskRun, 640);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8* TIATables::maskRun(const uInt8* mask)
+{
+  const uInt8* px = &PxMask[0][0][0];
+  if(mask >= px && mask < px + sizeof(PxMask))
+    return &PxMaskRun[0][0][0] + (mask - px);
+
+  const uInt8* mx = &MxMask[0][0][0];
+  if(mask >= mx && mask < mx + sizeof(MxMask))
+    return &MxMaskRun[0][0][0] + (mask - mx);
+
+  const uInt8* bl = &BLMask[0][0];
+  if(mask >= bl && mask < bl + sizeof(BLMask))
+    return &BLMaskRun[0][0] + (mask - bl);
+
+  assert(mask >= DisabledMask && mask < DisabledMask + sizeof(DisabledMask));
+  return DisabledMaskRun + (mask - DisabledMask);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIATables::buildGRPReflectTable()
 {
@@ -722,5 +769,17 @@ uInt16 TIATables::CollisionMask[64];
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIATables::DisabledMask[640];
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 TIATables::PxMaskRun[2][8][320];
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 TIATables::MxMaskRun[8][5][320];
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 TIATables::BLMaskRun[4][320];
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 TIATables::DisabledMaskRun[640];
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int8 TIATables::PxPosResetWhen[8][160][160];
@@ -165,6 +165,21 @@ class TIATables
     // A mask table which can be used when an object is disabled
     static uInt8 DisabledMask[640];
 
+    // Run length tables for the player, missle, ball and disabled masks
+    // Each entry is the number of pixels, starting from the corresponding
+    // entry in the mask table, that have the same mask value (max. 255);
+    // runs never extend past the end of a row of the mask table
+    static uInt8 PxMaskRun[2][8][320];
+    static uInt8 MxMaskRun[8][5][320];
+    static uInt8 BLMaskRun[4][320];
+    static uInt8 DisabledMaskRun[640];
+
+    /**
+      Answer the entry in the run length tables corresponding to the given
+      entry of PxMask, MxMask, BLMask or DisabledMask.
+    */
+    static const uInt8* maskRun(const uInt8* mask);
+
     // Used to set the collision register to the correct value
     static uInt16 CollisionMask[64];
 
@@ -203,6 +218,12 @@ class TIATables
     // Compute playfield mask table
     static void buildPFMaskTable();
 
+    // Compute the run length table for a row of a mask table
+    static void buildMaskRunTable(const uInt8* mask, uInt8* run, uInt32 size);
+
+    // Compute the run length tables for all mask tables
+    static void buildMaskRunTables();
+
     // Compute the player reflect table
     static void buildGRPReflectTable();
 
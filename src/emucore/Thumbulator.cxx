@@ -50,31 +50,81 @@ using namespace Common;
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Thumbulator::Thumbulator(const uInt16* rom_ptr, uInt16* ram_ptr, bool traponfatal)
   : rom(rom_ptr),
-    ram(ram_ptr)
+    ram(ram_ptr),
+    mamcr(0),
+    profiling(false),
+    profileCount(NULL),
+    profileCycles(NULL)
 {
   trapFatalErrors(traponfatal);
+  map_regions();
+
+  if(!decodeTableBuilt)
+    buildDecodeTable();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Thumbulator::~Thumbulator()
 {
+  delete[] profileCount;
+  delete[] profileCycles;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string Thumbulator::run( void )
+bool Thumbulator::run( void )
 {
   reset();
-  for(;;)
+  bool ok = true;
+  try
+  {
+    // The profiled loop is kept apart, so it doesn't slow down the other
+    if(profiling)
+    {
+      while(!execute_profiled())
+        if (instructions > 500000)
+          throw string("instructions > 500000");
+    }
+    else
+    {
+      for(;;)
+      {
+        if (execute()) break;
+        if (instructions > 500000) // way more than would otherwise be possible
+          throw string("instructions > 500000");
+      }
+    }
+  }
+  catch(const string& error)
+  {
+    errorMsg = error;
+    ok = false;
+  }
+  catch(const char* error)  // a write to the halt address
   {
-    if (execute()) break;
-    if (instructions > 500000) // way more than would otherwise be possible
-      throw "instructions > 500000";
+    errorMsg = error;
+    ok = false;
   }
+
+  if(profiling)
+  {
+    // Add this call to the totals of the frame
+    ProfileTotals& t = profileFrameTotals;
+    if(t.calls == 0 || profileCallCycles < t.minCallCycles)
+      t.minCallCycles = profileCallCycles;
+    if(profileCallCycles > t.maxCallCycles)
+      t.maxCallCycles = profileCallCycles;
+    t.calls++;
+    t.instructions += instructions;
+    t.cycles += profileCallCycles;
+  }
+  if(!ok)
+    return false;
+
 #if defined(THUMB_DISS) || defined(THUMB_DBUG)
   dump_counters();
   cout << statusMsg.str() << endl;
 #endif
-  return statusMsg.str();
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -132,6 +182,19 @@ uInt32 Thumbulator::fetch16 ( uInt32 addr )
   fetches++;
 
   uInt32 data;
+  const Region& r = regions[addr>>28];
+  if((r.access&REGION_FETCH) && (addr-r.start)<r.size)
+  {
+    const uInt16* p = r.data + ((addr-r.start)>>1);
+  #ifdef __BIG_ENDIAN__
+    data=((*p>>8)|(*p<<8))&0xffff;
+  #else
+    data=*p;
+  #endif
+    DO_DBUG(statusMsg << "fetch16(" << Base::HEX8 << addr << ")=" << Base::HEX4 << data << endl);
+    return(data);
+  }
+
   switch(addr&0xF0000000)
   {
     case 0x00000000: //ROM
@@ -191,6 +254,20 @@ uInt32 Thumbulator::fetch32 ( uInt32 addr )
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Thumbulator::write16 ( uInt32 addr, uInt32 data )
 {
+  const Region& r = regions[addr>>28];
+  if((r.access&REGION_WRITE) && (addr-r.start)<r.size && !(addr&1))
+  {
+    writes++;
+    DO_DBUG(statusMsg << "write16(" << Base::HEX8 << addr << "," << Base::HEX8 << data << ")" << endl);
+    uInt16* p = r.data + ((addr-r.start)>>1);
+  #ifdef __BIG_ENDIAN__
+    *p=(((data&0xFFFF)>>8)|((data&0xffff)<<8))&0xffff;
+  #else
+    *p=data&0xFFFF;
+  #endif
+    return;
+  }
+
   if((addr>0x40001fff)&&(addr<0x50000000))
     fatalError("write16", addr, "abort - out of range");
   else if((addr>0x40000028)&&(addr<0x40000c00))
@@ -228,6 +305,22 @@ void Thumbulator::write16 ( uInt32 addr, uInt32 data )
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Thumbulator::write32 ( uInt32 addr, uInt32 data )
 {
+  const Region& r = regions[addr>>28];
+  if((r.access&REGION_WRITE) && (addr-r.start)<r.size && !(addr&3))
+  {
+    writes+=2;
+    DO_DBUG(statusMsg << "write32(" << Base::HEX8 << addr << "," << Base::HEX8 << data << ")" << endl);
+    uInt16* p = r.data + ((addr-r.start)>>1);
+  #ifdef __BIG_ENDIAN__
+    p[0]=(((data&0xFFFF)>>8)|((data&0xffff)<<8))&0xffff;
+    p[1]=((data>>24)|((data>>8)&0xff00))&0xffff;
+  #else
+    p[0]=data&0xFFFF;
+    p[1]=data>>16;
+  #endif
+    return;
+  }
+
   if(addr&3)
     fatalError("write32", addr, "abort - misaligned");
 
@@ -265,6 +358,19 @@ void Thumbulator::write32 ( uInt32 addr, uInt32 data )
 uInt32 Thumbulator::read16 ( uInt32 addr )
 {
   uInt32 data;
+  const Region& r = regions[addr>>28];
+  if((r.access&REGION_READ) && (addr-r.start)<r.size && !(addr&1))
+  {
+    reads++;
+    const uInt16* p = r.data + ((addr-r.start)>>1);
+  #ifdef __BIG_ENDIAN__
+    data=((*p>>8)|(*p<<8))&0xffff;
+  #else
+    data=*p;
+  #endif
+    DO_DBUG(statusMsg << "read16(" << Base::HEX8 << addr << ")=" << Base::HEX4 << data << endl);
+    return(data);
+  }
 
   if((addr>0x40001fff)&&(addr<0x50000000))
     fatalError("read16", addr, "abort - out of range");
@@ -312,6 +418,22 @@ uInt32 Thumbulator::read16 ( uInt32 addr )
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 Thumbulator::read32 ( uInt32 addr )
 {
+  const Region& r = regions[addr>>28];
+  if((r.access&REGION_READ) && (addr-r.start)<r.size && !(addr&3))
+  {
+    reads+=2;
+    const uInt16* p = r.data + ((addr-r.start)>>1);
+    uInt32 data;
+  #ifdef __BIG_ENDIAN__
+    data=((p[1]>>8)|((p[1]&0xff)<<8))<<16;
+    data|=((p[0]>>8)|((p[0]&0xff)<<8));
+  #else
+    data=(p[1]<<16)|p[0];
+  #endif
+    DO_DBUG(statusMsg << "read32(" << Base::HEX8 << addr << ")=" << Base::HEX8 << data << endl);
+    return(data);
+  }
+
   if(addr&3)
     fatalError("read32", addr, "abort - misaligned");
 
@@ -329,6 +451,27 @@ uInt32 Thumbulator::read32 ( uInt32 addr )
   return fatalError("read32", addr, "abort");
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::map_regions ( void )
+{
+  memset(regions, 0, sizeof(regions));
+
+  // Flash, above the exception vectors; it is never written, so the
+  // cast is safe
+  Region& flash = regions[0x0];
+  flash.data   = const_cast<uInt16*>(rom) + 0x50/2;
+  flash.start  = 0x00000050;
+  flash.size   = ROMSIZE - 0x50;
+  flash.access = REGION_FETCH|REGION_READ;
+
+  // RAM, above the DPC+ driver area (which has its own write checks)
+  Region& sram = regions[0x4];
+  sram.data   = ram + 0xc00/2;
+  sram.start  = 0x40000c00;
+  sram.size   = RAMSIZE - 0xc00;
+  sram.access = REGION_FETCH|REGION_READ|REGION_WRITE;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 Thumbulator::read_register ( uInt32 reg )
 {
@@ -436,6 +579,110 @@ void Thumbulator::do_vflag_bit ( uInt32 x )
   else  cpsr&=~CPSR_V;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::buildDecodeTable ( void )
+{
+  // The patterns in the same order execute() used to test them in; the
+  // first one that matches an instruction decides how it is executed
+  static const struct { uInt16 mask, pattern; Op op; } patterns[] = {
+    { 0xFFC0, 0x4140, Op_adc },
+    { 0xFE00, 0x1C00, Op_add1 },
+    { 0xF800, 0x3000, Op_add2 },
+    { 0xFE00, 0x1800, Op_add3 },
+    { 0xFF00, 0x4400, Op_add4 },
+    { 0xF800, 0xA000, Op_add5 },
+    { 0xF800, 0xA800, Op_add6 },
+    { 0xFF80, 0xB000, Op_add7 },
+    { 0xFFC0, 0x4000, Op_and },
+    { 0xF800, 0x1000, Op_asr1 },
+    { 0xFFC0, 0x4100, Op_asr2 },
+    { 0xF000, 0xD000, Op_b1 },
+    { 0xF800, 0xE000, Op_b2 },
+    { 0xFFC0, 0x4380, Op_bic },
+    { 0xFF00, 0xBE00, Op_bkpt },
+    { 0xE000, 0xE000, Op_bl },
+    { 0xFF87, 0x4780, Op_blx2 },
+    { 0xFF87, 0x4700, Op_bx },
+    { 0xFFC0, 0x42C0, Op_cmn },
+    { 0xF800, 0x2800, Op_cmp1 },
+    { 0xFFC0, 0x4280, Op_cmp2 },
+    { 0xFF00, 0x4500, Op_cmp3 },
+    { 0xFFE8, 0xB660, Op_cps },
+    { 0xFFC0, 0x4600, Op_cpy },
+    { 0xFFC0, 0x4040, Op_eor },
+    { 0xF800, 0xC800, Op_ldmia },
+    { 0xF800, 0x6800, Op_ldr1 },
+    { 0xFE00, 0x5800, Op_ldr2 },
+    { 0xF800, 0x4800, Op_ldr3 },
+    { 0xF800, 0x9800, Op_ldr4 },
+    { 0xF800, 0x7800, Op_ldrb1 },
+    { 0xFE00, 0x5C00, Op_ldrb2 },
+    { 0xF800, 0x8800, Op_ldrh1 },
+    { 0xFE00, 0x5A00, Op_ldrh2 },
+    { 0xFE00, 0x5600, Op_ldrsb },
+    { 0xFE00, 0x5E00, Op_ldrsh },
+    { 0xF800, 0x0000, Op_lsl1 },
+    { 0xFFC0, 0x4080, Op_lsl2 },
+    { 0xF800, 0x0800, Op_lsr1 },
+    { 0xFFC0, 0x40C0, Op_lsr2 },
+    { 0xF800, 0x2000, Op_mov1 },
+    { 0xFFC0, 0x1C00, Op_mov2 },
+    { 0xFF00, 0x4600, Op_mov3 },
+    { 0xFFC0, 0x4340, Op_mul },
+    { 0xFFC0, 0x43C0, Op_mvn },
+    { 0xFFC0, 0x4240, Op_neg },
+    { 0xFFC0, 0x4300, Op_orr },
+    { 0xFE00, 0xBC00, Op_pop },
+    { 0xFE00, 0xB400, Op_push },
+    { 0xFFC0, 0xBA00, Op_rev },
+    { 0xFFC0, 0xBA40, Op_rev16 },
+    { 0xFFC0, 0xBAC0, Op_revsh },
+    { 0xFFC0, 0x41C0, Op_ror },
+    { 0xFFC0, 0x4180, Op_sbc },
+    { 0xFFF7, 0xB650, Op_setend },
+    { 0xF800, 0xC000, Op_stmia },
+    { 0xF800, 0x6000, Op_str1 },
+    { 0xFE00, 0x5000, Op_str2 },
+    { 0xF800, 0x9000, Op_str3 },
+    { 0xF800, 0x7000, Op_strb1 },
+    { 0xFE00, 0x5400, Op_strb2 },
+    { 0xF800, 0x8000, Op_strh1 },
+    { 0xFE00, 0x5200, Op_strh2 },
+    { 0xFE00, 0x1E00, Op_sub1 },
+    { 0xF800, 0x3800, Op_sub2 },
+    { 0xFE00, 0x1A00, Op_sub3 },
+    { 0xFF80, 0xB080, Op_sub4 },
+    { 0xFF00, 0xDF00, Op_swi },
+    { 0xFFC0, 0xB240, Op_sxtb },
+    { 0xFFC0, 0xB200, Op_sxth },
+    { 0xFFC0, 0x4200, Op_tst },
+    { 0xFFC0, 0xB2C0, Op_uxtb },
+    { 0xFFC0, 0xB280, Op_uxth }
+  };
+
+  for(uInt32 inst = 0; inst < 65536; ++inst)
+  {
+    Op op = Op_invalid;
+    for(uInt32 i = 0; i < sizeof(patterns)/sizeof(patterns[0]); ++i)
+    {
+      if((inst & patterns[i].mask) != patterns[i].pattern)
+        continue;
+
+      // These encodings leave their block without executing anything,
+      // and continue testing the patterns that follow
+      if(patterns[i].op == Op_add1 && ((inst>>6)&0x7) == 0)   // MOV(2)
+        continue;
+      if(patterns[i].op == Op_b1 && ((inst>>8)&0xF) >= 0xE)   // undefined/SWI
+        continue;
+
+      op = patterns[i].op;
+      break;
+    }
+    decodeTable[inst] = op;
+  }
+  decodeTableBuilt = true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Thumbulator::execute ( void )
 {
@@ -452,1503 +699,1764 @@ int Thumbulator::execute ( void )
 
   instructions++;
 
-  //ADC
-  if((inst&0xFFC0)==0x4140)
-  {
-    rd=(inst>>0)&0x07;
-    rm=(inst>>3)&0x07;
-    DO_DISS(statusMsg << "adc r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rd);
-    rb=read_register(rm);
-    rc=ra+rb;
-    if(cpsr&CPSR_C)
-      rc++;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    if(cpsr&CPSR_C) do_cflag(ra,rb,1);
-    else            do_cflag(ra,rb,0);
-    do_add_vflag(ra,rb,rc);
-    return(0);
-  }
-
-  //ADD(1) small immediate two registers
-  if((inst&0xFE00)==0x1C00)
+  switch(decodeTable[inst])
   {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rb=(inst>>6)&0x7;
-    if(rb)
+    //ADC
+    case Op_adc:
     {
-      DO_DISS(statusMsg << "adds r" << dec << rd << ",r" << dec << rn << ","
-                        << "#0x" << Base::HEX2 << rb << endl);
-      ra=read_register(rn);
+      rd=(inst>>0)&0x07;
+      rm=(inst>>3)&0x07;
+      DO_DISS(statusMsg << "adc r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rd);
+      rb=read_register(rm);
       rc=ra+rb;
-      //fprintf(stderr,"0x%08X = 0x%08X + 0x%08X\n",rc,ra,rb);
+      if(cpsr&CPSR_C)
+        rc++;
       write_register(rd,rc);
       do_nflag(rc);
       do_zflag(rc);
-      do_cflag(ra,rb,0);
+      if(cpsr&CPSR_C) do_cflag(ra,rb,1);
+      else            do_cflag(ra,rb,0);
       do_add_vflag(ra,rb,rc);
       return(0);
     }
-    else
-    {
-      //this is a mov
-    }
-  }
-
-  //ADD(2) big immediate one register
-  if((inst&0xF800)==0x3000)
-  {
-    rb=(inst>>0)&0xFF;
-    rd=(inst>>8)&0x7;
-    DO_DISS(statusMsg << "adds r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
-    ra=read_register(rd);
-    rc=ra+rb;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra,rb,0);
-    do_add_vflag(ra,-rb,rc);
-    return(0);
-  }
-
-  //ADD(3) three registers
-  if((inst&0xFE00)==0x1800)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rm=(inst>>6)&0x7;
-    DO_DISS(statusMsg << "adds r" << dec << rd << ",r" << dec << rn << ",r" << rm << endl);
-    ra=read_register(rn);
-    rb=read_register(rm);
-    rc=ra+rb;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra,rb,0);
-    do_add_vflag(ra,rb,rc);
-    return(0);
-  }
-
-  //ADD(4) two registers one or both high no flags
-  if((inst&0xFF00)==0x4400)
-  {
-    if((inst>>6)&3)
-    {
-      //UNPREDICTABLE
-    }
-    rd=(inst>>0)&0x7;
-    rd|=(inst>>4)&0x8;
-    rm=(inst>>3)&0xF;
-    DO_DISS(statusMsg << "add r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rd);
-    rb=read_register(rm);
-    rc=ra+rb;
-    //fprintf(stderr,"0x%08X = 0x%08X + 0x%08X\n",rc,ra,rb);
-    write_register(rd,rc);
-    return(0);
-  }
-
-  //ADD(5) rd = pc plus immediate
-  if((inst&0xF800)==0xA000)
-  {
-    rb=(inst>>0)&0xFF;
-    rd=(inst>>8)&0x7;
-    rb<<=2;
-    DO_DISS(statusMsg << "add r" << dec << rd << ",PC,#0x" << Base::HEX2 << rb << endl);
-    ra=read_register(15);
-    rc=(ra&(~3))+rb;
-    write_register(rd,rc);
-    return(0);
-  }
 
-  //ADD(6) rd = sp plus immediate
-  if((inst&0xF800)==0xA800)
-  {
-    rb=(inst>>0)&0xFF;
-    rd=(inst>>8)&0x7;
-    rb<<=2;
-    DO_DISS(statusMsg << "add r" << dec << rd << ",SP,#0x" << Base::HEX2 << rb << endl);
-    ra=read_register(13);
-    rc=ra+rb;
-    write_register(rd,rc);
-    return(0);
-  }
-
-  //ADD(7) sp plus immediate
-  if((inst&0xFF80)==0xB000)
-  {
-    rb=(inst>>0)&0x7F;
-    rb<<=2;
-    DO_DISS(statusMsg << "add SP,#0x" << Base::HEX2 << rb << endl);
-    ra=read_register(13);
-    rc=ra+rb;
-    write_register(13,rc);
-    return(0);
-  }
-
-  //AND
-  if((inst&0xFFC0)==0x4000)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "ands r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rd);
-    rb=read_register(rm);
-    rc=ra&rb;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
-
-  //ASR(1) two register immediate
-  if((inst&0xF800)==0x1000)
-  {
-    rd=(inst>>0)&0x07;
-    rm=(inst>>3)&0x07;
-    rb=(inst>>6)&0x1F;
-    DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
-    rc=read_register(rm);
-    if(rb==0)
-    {
-      if(rc&0x80000000)
+    //ADD(1) small immediate two registers
+    case Op_add1:
+    {
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rb=(inst>>6)&0x7;
+      if(rb)
       {
-        do_cflag_bit(1);
-        rc=~0;
+        DO_DISS(statusMsg << "adds r" << dec << rd << ",r" << dec << rn << ","
+                          << "#0x" << Base::HEX2 << rb << endl);
+        ra=read_register(rn);
+        rc=ra+rb;
+        //fprintf(stderr,"0x%08X = 0x%08X + 0x%08X\n",rc,ra,rb);
+        write_register(rd,rc);
+        do_nflag(rc);
+        do_zflag(rc);
+        do_cflag(ra,rb,0);
+        do_add_vflag(ra,rb,rc);
+        return(0);
       }
       else
       {
-        do_cflag_bit(0);
-        rc=0;
+        //this is a mov, decoded as MOV(2) by buildDecodeTable()
       }
+      break;
     }
-    else
+
+    //ADD(2) big immediate one register
+    case Op_add2:
     {
-      do_cflag_bit(rc&(1<<(rb-1)));
-      ra=rc&0x80000000;
-      rc>>=rb;
-      if(ra) //asr, sign is shifted in
-      {
-        rc|=(~0)<<(32-rb);
-      }
+      rb=(inst>>0)&0xFF;
+      rd=(inst>>8)&0x7;
+      DO_DISS(statusMsg << "adds r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
+      ra=read_register(rd);
+      rc=ra+rb;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra,rb,0);
+      do_add_vflag(ra,-rb,rc);
+      return(0);
     }
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
 
-  //ASR(2) two register
-  if((inst&0xFFC0)==0x4100)
-  {
-    rd=(inst>>0)&0x07;
-    rs=(inst>>3)&0x07;
-    DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rs << endl);
-    rc=read_register(rd);
-    rb=read_register(rs);
-    rb&=0xFF;
-    if(rb==0)
+    //ADD(3) three registers
+    case Op_add3:
     {
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rm=(inst>>6)&0x7;
+      DO_DISS(statusMsg << "adds r" << dec << rd << ",r" << dec << rn << ",r" << rm << endl);
+      ra=read_register(rn);
+      rb=read_register(rm);
+      rc=ra+rb;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra,rb,0);
+      do_add_vflag(ra,rb,rc);
+      return(0);
     }
-    else if(rb<32)
+
+    //ADD(4) two registers one or both high no flags
+    case Op_add4:
     {
-      do_cflag_bit(rc&(1<<(rb-1)));
-      ra=rc&0x80000000;
-      rc>>=rb;
-      if(ra) //asr, sign is shifted in
+      if((inst>>6)&3)
       {
-        rc|=(~0)<<(32-rb);
+        //UNPREDICTABLE
       }
+      rd=(inst>>0)&0x7;
+      rd|=(inst>>4)&0x8;
+      rm=(inst>>3)&0xF;
+      DO_DISS(statusMsg << "add r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rd);
+      rb=read_register(rm);
+      rc=ra+rb;
+      //fprintf(stderr,"0x%08X = 0x%08X + 0x%08X\n",rc,ra,rb);
+      write_register(rd,rc);
+      return(0);
     }
-    else
+
+    //ADD(5) rd = pc plus immediate
+    case Op_add5:
     {
-      if(rc&0x80000000)
-      {
-        do_cflag_bit(1);
-        rc=(~0);
-      }
-      else
-      {
-        do_cflag_bit(0);
-        rc=0;
-      }
+      rb=(inst>>0)&0xFF;
+      rd=(inst>>8)&0x7;
+      rb<<=2;
+      DO_DISS(statusMsg << "add r" << dec << rd << ",PC,#0x" << Base::HEX2 << rb << endl);
+      ra=read_register(15);
+      rc=(ra&(~3))+rb;
+      write_register(rd,rc);
+      return(0);
     }
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
-
-  //B(1) conditional branch
-  if((inst&0xF000)==0xD000)
-  {
-    rb=(inst>>0)&0xFF;
-    if(rb&0x80)
-      rb|=(~0)<<8;
-    op=(inst>>8)&0xF;
-    rb<<=1;
-    rb+=pc;
-    rb+=2;
-    switch(op)
-    {
-      case 0x0: //b eq  z set
-        DO_DISS(statusMsg << "beq 0x" << Base::HEX8 << (rb-3) << endl);
-        if(cpsr&CPSR_Z)
-        {
-          write_register(15,rb);
-        }
-        return(0);
-
-      case 0x1: //b ne  z clear
-        DO_DISS(statusMsg << "bne 0x" << Base::HEX8 << (rb-3) << endl);
-        if(!(cpsr&CPSR_Z))
-        {
-          write_register(15,rb);
-        }
-        return(0);
-
-      case 0x2: //b cs c set
-        DO_DISS(statusMsg << "bcs 0x" << Base::HEX8 << (rb-3) << endl);
-        if(cpsr&CPSR_C)
-        {
-          write_register(15,rb);
-        }
-        return(0);
 
-      case 0x3: //b cc c clear
-        DO_DISS(statusMsg << "bcc 0x" << Base::HEX8 << (rb-3) << endl);
-        if(!(cpsr&CPSR_C))
-        {
-          write_register(15,rb);
-        }
-        return(0);
-
-      case 0x4: //b mi n set
-        DO_DISS(statusMsg << "bmi 0x" << Base::HEX8 << (rb-3) << endl);
-        if(cpsr&CPSR_N)
-        {
-          write_register(15,rb);
-        }
-        return(0);
-
-      case 0x5: //b pl n clear
-        DO_DISS(statusMsg << "bpl 0x" << Base::HEX8 << (rb-3) << endl);
-        if(!(cpsr&CPSR_N))
-        {
-          write_register(15,rb);
-        }
-        return(0);
+    //ADD(6) rd = sp plus immediate
+    case Op_add6:
+    {
+      rb=(inst>>0)&0xFF;
+      rd=(inst>>8)&0x7;
+      rb<<=2;
+      DO_DISS(statusMsg << "add r" << dec << rd << ",SP,#0x" << Base::HEX2 << rb << endl);
+      ra=read_register(13);
+      rc=ra+rb;
+      write_register(rd,rc);
+      return(0);
+    }
 
-      case 0x6: //b vs v set
-        DO_DISS(statusMsg << "bvs 0x" << Base::HEX8 << (rb-3) << endl);
-        if(cpsr&CPSR_V)
-        {
-          write_register(15,rb);
-        }
-        return(0);
+    //ADD(7) sp plus immediate
+    case Op_add7:
+    {
+      rb=(inst>>0)&0x7F;
+      rb<<=2;
+      DO_DISS(statusMsg << "add SP,#0x" << Base::HEX2 << rb << endl);
+      ra=read_register(13);
+      rc=ra+rb;
+      write_register(13,rc);
+      return(0);
+    }
 
-      case 0x7: //b vc v clear
-        DO_DISS(statusMsg << "bvc 0x" << Base::HEX8 << (rb-3) << endl);
-        if(!(cpsr&CPSR_V))
-        {
-          write_register(15,rb);
-        }
-        return(0);
+    //AND
+    case Op_and:
+    {
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "ands r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rd);
+      rb=read_register(rm);
+      rc=ra&rb;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
+    }
 
-      case 0x8: //b hi c set z clear
-        DO_DISS(statusMsg << "bhi 0x" << Base::HEX8 << (rb-3) << endl);
-        if((cpsr&CPSR_C)&&(!(cpsr&CPSR_Z)))
+    //ASR(1) two register immediate
+    case Op_asr1:
+    {
+      rd=(inst>>0)&0x07;
+      rm=(inst>>3)&0x07;
+      rb=(inst>>6)&0x1F;
+      DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
+      rc=read_register(rm);
+      if(rb==0)
+      {
+        if(rc&0x80000000)
         {
-          write_register(15,rb);
+          do_cflag_bit(1);
+          rc=~0;
         }
-        return(0);
-
-      case 0x9: //b ls c clear or z set
-        DO_DISS(statusMsg << "bls 0x" << Base::HEX8 << (rb-3) << endl);
-        if((cpsr&CPSR_Z)||(!(cpsr&CPSR_C)))
+        else
         {
-          write_register(15,rb);
+          do_cflag_bit(0);
+          rc=0;
         }
-        return(0);
-
-      case 0xA: //b ge N == V
-        DO_DISS(statusMsg << "bge 0x" << Base::HEX8 << (rb-3) << endl);
-        ra=0;
-        if(  (cpsr&CPSR_N) &&  (cpsr&CPSR_V) ) ra++;
-        if((!(cpsr&CPSR_N))&&(!(cpsr&CPSR_V))) ra++;
-        if(ra)
+      }
+      else
+      {
+        do_cflag_bit(rc&(1<<(rb-1)));
+        ra=rc&0x80000000;
+        rc>>=rb;
+        if(ra) //asr, sign is shifted in
         {
-          write_register(15,rb);
+          rc|=(~0)<<(32-rb);
         }
-        return(0);
+      }
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
+    }
 
-      case 0xB: //b lt N != V
-        DO_DISS(statusMsg << "blt 0x" << Base::HEX8 << (rb-3) << endl);
-        ra=0;
-        if((!(cpsr&CPSR_N))&&(cpsr&CPSR_V)) ra++;
-        if((!(cpsr&CPSR_V))&&(cpsr&CPSR_N)) ra++;
-        if(ra)
+    //ASR(2) two register
+    case Op_asr2:
+    {
+      rd=(inst>>0)&0x07;
+      rs=(inst>>3)&0x07;
+      DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rs << endl);
+      rc=read_register(rd);
+      rb=read_register(rs);
+      rb&=0xFF;
+      if(rb==0)
+      {
+      }
+      else if(rb<32)
+      {
+        do_cflag_bit(rc&(1<<(rb-1)));
+        ra=rc&0x80000000;
+        rc>>=rb;
+        if(ra) //asr, sign is shifted in
         {
-          write_register(15,rb);
+          rc|=(~0)<<(32-rb);
         }
-        return(0);
-
-      case 0xC: //b gt Z==0 and N == V
-        DO_DISS(statusMsg << "bgt 0x" << Base::HEX8 << (rb-3) << endl);
-        ra=0;
-        if(  (cpsr&CPSR_N) &&  (cpsr&CPSR_V) ) ra++;
-        if((!(cpsr&CPSR_N))&&(!(cpsr&CPSR_V))) ra++;
-        if(cpsr&CPSR_Z) ra=0;
-        if(ra)
+      }
+      else
+      {
+        if(rc&0x80000000)
         {
-          write_register(15,rb);
+          do_cflag_bit(1);
+          rc=(~0);
         }
-        return(0);
-
-      case 0xD: //b le Z==1 or N != V
-        DO_DISS(statusMsg << "ble 0x" << Base::HEX8 << (rb-3) << endl);
-        ra=0;
-        if((!(cpsr&CPSR_N))&&(cpsr&CPSR_V)) ra++;
-        if((!(cpsr&CPSR_V))&&(cpsr&CPSR_N)) ra++;
-        if(cpsr&CPSR_Z) ra++;
-        if(ra)
+        else
         {
-          write_register(15,rb);
+          do_cflag_bit(0);
+          rc=0;
         }
-        return(0);
-
-      case 0xE:
-        //undefined instruction
-        break;
-
-      case 0xF:
-        //swi
-        break;
+      }
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
     }
-  }
-
-  //B(2) unconditional branch
-  if((inst&0xF800)==0xE000)
-  {
-    rb=(inst>>0)&0x7FF;
-    if(rb&(1<<10))
-      rb|=(~0)<<11;
-    rb<<=1;
-    rb+=pc;
-    rb+=2;
-    DO_DISS(statusMsg << "B 0x" << Base::HEX8 << (rb-3) << endl);
-    write_register(15,rb);
-    return(0);
-  }
-
-  //BIC
-  if((inst&0xFFC0)==0x4380)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "bics r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rd);
-    rb=read_register(rm);
-    rc=ra&(~rb);
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
 
-  //BKPT
-  if((inst&0xFF00)==0xBE00)
-  {
-    rb=(inst>>0)&0xFF;
-    statusMsg << "bkpt 0x" << Base::HEX2 << rb << endl;
-    return(1);
-  }
-
-  //BL/BLX(1)
-  if((inst&0xE000)==0xE000) //BL,BLX
-  {
-    if((inst&0x1800)==0x1000) //H=b10
+    //B(1) conditional branch
+    case Op_b1:
     {
-      DO_DISS(statusMsg << endl);
-      halfadd=inst;
-      return(0);
+      rb=(inst>>0)&0xFF;
+      if(rb&0x80)
+        rb|=(~0)<<8;
+      op=(inst>>8)&0xF;
+      rb<<=1;
+      rb+=pc;
+      rb+=2;
+      switch(op)
+      {
+        case 0x0: //b eq  z set
+          DO_DISS(statusMsg << "beq 0x" << Base::HEX8 << (rb-3) << endl);
+          if(cpsr&CPSR_Z)
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0x1: //b ne  z clear
+          DO_DISS(statusMsg << "bne 0x" << Base::HEX8 << (rb-3) << endl);
+          if(!(cpsr&CPSR_Z))
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0x2: //b cs c set
+          DO_DISS(statusMsg << "bcs 0x" << Base::HEX8 << (rb-3) << endl);
+          if(cpsr&CPSR_C)
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0x3: //b cc c clear
+          DO_DISS(statusMsg << "bcc 0x" << Base::HEX8 << (rb-3) << endl);
+          if(!(cpsr&CPSR_C))
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0x4: //b mi n set
+          DO_DISS(statusMsg << "bmi 0x" << Base::HEX8 << (rb-3) << endl);
+          if(cpsr&CPSR_N)
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0x5: //b pl n clear
+          DO_DISS(statusMsg << "bpl 0x" << Base::HEX8 << (rb-3) << endl);
+          if(!(cpsr&CPSR_N))
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0x6: //b vs v set
+          DO_DISS(statusMsg << "bvs 0x" << Base::HEX8 << (rb-3) << endl);
+          if(cpsr&CPSR_V)
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0x7: //b vc v clear
+          DO_DISS(statusMsg << "bvc 0x" << Base::HEX8 << (rb-3) << endl);
+          if(!(cpsr&CPSR_V))
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0x8: //b hi c set z clear
+          DO_DISS(statusMsg << "bhi 0x" << Base::HEX8 << (rb-3) << endl);
+          if((cpsr&CPSR_C)&&(!(cpsr&CPSR_Z)))
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0x9: //b ls c clear or z set
+          DO_DISS(statusMsg << "bls 0x" << Base::HEX8 << (rb-3) << endl);
+          if((cpsr&CPSR_Z)||(!(cpsr&CPSR_C)))
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0xA: //b ge N == V
+          DO_DISS(statusMsg << "bge 0x" << Base::HEX8 << (rb-3) << endl);
+          ra=0;
+          if(  (cpsr&CPSR_N) &&  (cpsr&CPSR_V) ) ra++;
+          if((!(cpsr&CPSR_N))&&(!(cpsr&CPSR_V))) ra++;
+          if(ra)
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0xB: //b lt N != V
+          DO_DISS(statusMsg << "blt 0x" << Base::HEX8 << (rb-3) << endl);
+          ra=0;
+          if((!(cpsr&CPSR_N))&&(cpsr&CPSR_V)) ra++;
+          if((!(cpsr&CPSR_V))&&(cpsr&CPSR_N)) ra++;
+          if(ra)
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0xC: //b gt Z==0 and N == V
+          DO_DISS(statusMsg << "bgt 0x" << Base::HEX8 << (rb-3) << endl);
+          ra=0;
+          if(  (cpsr&CPSR_N) &&  (cpsr&CPSR_V) ) ra++;
+          if((!(cpsr&CPSR_N))&&(!(cpsr&CPSR_V))) ra++;
+          if(cpsr&CPSR_Z) ra=0;
+          if(ra)
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0xD: //b le Z==1 or N != V
+          DO_DISS(statusMsg << "ble 0x" << Base::HEX8 << (rb-3) << endl);
+          ra=0;
+          if((!(cpsr&CPSR_N))&&(cpsr&CPSR_V)) ra++;
+          if((!(cpsr&CPSR_V))&&(cpsr&CPSR_N)) ra++;
+          if(cpsr&CPSR_Z) ra++;
+          if(ra)
+          {
+            write_register(15,rb);
+          }
+          return(0);
+
+        case 0xE:
+          //undefined instruction
+          break;
+
+        case 0xF:
+          //swi
+          break;
+      }
+      break;
     }
-    else if((inst&0x1800)==0x1800) //H=b11
+
+    //B(2) unconditional branch
+    case Op_b2:
     {
-      //branch to thumb
-      rb=halfadd&((1<<11)-1);
-      if(rb&1<<10)
-        rb|=(~((1<<11)-1)); //sign extend
-      rb<<=11;
-      rb|=inst&((1<<11)-1);
+      rb=(inst>>0)&0x7FF;
+      if(rb&(1<<10))
+        rb|=(~0)<<11;
       rb<<=1;
       rb+=pc;
-      DO_DISS(statusMsg << "bl 0x" << Base::HEX8 << (rb-3) << endl);
-      write_register(14,pc-2);
+      rb+=2;
+      DO_DISS(statusMsg << "B 0x" << Base::HEX8 << (rb-3) << endl);
       write_register(15,rb);
       return(0);
     }
-    else if((inst&0x1800)==0x0800) //H=b01
-    {
-      //fprintf(stderr,"cannot branch to arm 0x%08X 0x%04X\n",pc,inst);
-      // fxq: this should exit the code without having to detect it
-      return(1);
-    }
-  }
 
-  //BLX(2)
-  if((inst&0xFF87)==0x4780)
-  {
-    rm=(inst>>3)&0xF;
-    DO_DISS(statusMsg << "blx r" << dec << rm << endl);
-    rc=read_register(rm);
-    //fprintf(stderr,"blx r%u 0x%X 0x%X\n",rm,rc,pc);
-    rc+=2;
-    if(rc&1)
+    //BIC
+    case Op_bic:
     {
-      write_register(14,pc-2);
-      write_register(15,rc);
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "bics r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rd);
+      rb=read_register(rm);
+      rc=ra&(~rb);
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
       return(0);
     }
-    else
+
+    //BKPT
+    case Op_bkpt:
     {
-      //fprintf(stderr,"cannot branch to arm 0x%08X 0x%04X\n",pc,inst);
-      // fxq: this could serve as exit code
+      rb=(inst>>0)&0xFF;
+      statusMsg << "bkpt 0x" << Base::HEX2 << rb << endl;
       return(1);
     }
-  }
 
-  //BX
-  if((inst&0xFF87)==0x4700)
-  {
-    rm=(inst>>3)&0xF;
-    DO_DISS(statusMsg << "bx r" << dec << rm << endl);
-    rc=read_register(rm);
-    rc+=2;
-    //fprintf(stderr,"bx r%u 0x%X 0x%X\n",rm,rc,pc);
-    if(rc&1)
+    //BL/BLX(1)
+    case Op_bl: //BL,BLX
     {
-      write_register(15,rc);
-      return(0);
+      if((inst&0x1800)==0x1000) //H=b10
+      {
+        DO_DISS(statusMsg << endl);
+        halfadd=inst;
+        return(0);
+      }
+      else if((inst&0x1800)==0x1800) //H=b11
+      {
+        //branch to thumb
+        rb=halfadd&((1<<11)-1);
+        if(rb&1<<10)
+          rb|=(~((1<<11)-1)); //sign extend
+        rb<<=11;
+        rb|=inst&((1<<11)-1);
+        rb<<=1;
+        rb+=pc;
+        DO_DISS(statusMsg << "bl 0x" << Base::HEX8 << (rb-3) << endl);
+        write_register(14,pc-2);
+        write_register(15,rb);
+        return(0);
+      }
+      else if((inst&0x1800)==0x0800) //H=b01
+      {
+        //fprintf(stderr,"cannot branch to arm 0x%08X 0x%04X\n",pc,inst);
+        // fxq: this should exit the code without having to detect it
+        return(1);
+      }
+      break;
     }
-    else
+
+    //BLX(2)
+    case Op_blx2:
     {
-      //fprintf(stderr,"cannot branch to arm 0x%08X 0x%04X\n",pc,inst);
-      // fxq: or maybe this one??
-      return(1);
+      rm=(inst>>3)&0xF;
+      DO_DISS(statusMsg << "blx r" << dec << rm << endl);
+      rc=read_register(rm);
+      //fprintf(stderr,"blx r%u 0x%X 0x%X\n",rm,rc,pc);
+      rc+=2;
+      if(rc&1)
+      {
+        write_register(14,pc-2);
+        write_register(15,rc);
+        return(0);
+      }
+      else
+      {
+        //fprintf(stderr,"cannot branch to arm 0x%08X 0x%04X\n",pc,inst);
+        // fxq: this could serve as exit code
+        return(1);
+      }
     }
-  }
-
-  //CMN
-  if((inst&0xFFC0)==0x42C0)
-  {
-    rn=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "cmns r" << dec << rn << ",r" << dec << rm << endl);
-    ra=read_register(rn);
-    rb=read_register(rm);
-    rc=ra+rb;
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra,rb,0);
-    do_add_vflag(ra,rb,rc);
-    return(0);
-  }
 
-  //CMP(1) compare immediate
-  if((inst&0xF800)==0x2800)
-  {
-    rb=(inst>>0)&0xFF;
-    rn=(inst>>8)&0x07;
-    DO_DISS(statusMsg << "cmp r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
-    ra=read_register(rn);
-    rc=ra-rb;
-    //fprintf(stderr,"0x%08X 0x%08X\n",ra,rb);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra,~rb,1);
-    do_sub_vflag(ra,rb,rc);
-    return(0);
-  }
-
-  //CMP(2) compare register
-  if((inst&0xFFC0)==0x4280)
-  {
-    rn=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
-    ra=read_register(rn);
-    rb=read_register(rm);
-    rc=ra-rb;
-    //fprintf(stderr,"0x%08X 0x%08X\n",ra,rb);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra,~rb,1);
-    do_sub_vflag(ra,rb,rc);
-    return(0);
-  }
-
-  //CMP(3) compare high register
-  if((inst&0xFF00)==0x4500)
-  {
-    if(((inst>>6)&3)==0x0)
-    {
-      //UNPREDICTABLE
-    }
-    rn=(inst>>0)&0x7;
-    rn|=(inst>>4)&0x8;
-    if(rn==0xF)
-    {
-      //UNPREDICTABLE
-    }
-    rm=(inst>>3)&0xF;
-    DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
-    ra=read_register(rn);
-    rb=read_register(rm);
-    rc=ra-rb;
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra,~rb,1);
-    do_sub_vflag(ra,rb,rc);
-
-#if 0
-    if(cpsr&CPSR_N) statusMsg << "N"; else statusMsg << "n";
-    if(cpsr&CPSR_Z) statusMsg << "Z"; else statusMsg << "z";
-    if(cpsr&CPSR_C) statusMsg << "C"; else statusMsg << "c";
-    if(cpsr&CPSR_V) statusMsg << "V"; else statusMsg << "v";
-    statusMsg << " -- 0x" << Base::HEX8 << ra << " 0x" << Base::HEX8 << rb << endl;
-#endif
-    return(0);
-  }
-
-  //CPS
-  if((inst&0xFFE8)==0xB660)
-  {
-    DO_DISS(statusMsg << "cps TODO" << endl);
-    return(1);
-  }
-
-  //CPY copy high register
-  if((inst&0xFFC0)==0x4600)
-  {
-    //same as mov except you can use both low registers
-    //going to let mov handle high registers
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "cpy r" << dec << rd << ",r" << dec << rm << endl);
-    rc=read_register(rm);
-    write_register(rd,rc);
-    return(0);
-  }
-
-  //EOR
-  if((inst&0xFFC0)==0x4040)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "eors r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rd);
-    rb=read_register(rm);
-    rc=ra^rb;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
-
-  //LDMIA
-  if((inst&0xF800)==0xC800)
-  {
-    rn=(inst>>8)&0x7;
-  #if defined(THUMB_DISS)
-    statusMsg << "ldmia r" << dec << rn << "!,{";
-    for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+    //BX
+    case Op_bx:
     {
-      if(inst&rb)
+      rm=(inst>>3)&0xF;
+      DO_DISS(statusMsg << "bx r" << dec << rm << endl);
+      rc=read_register(rm);
+      rc+=2;
+      //fprintf(stderr,"bx r%u 0x%X 0x%X\n",rm,rc,pc);
+      if(rc&1)
       {
-        if(rc) statusMsg << ",";
-        statusMsg << "r" << dec << ra;
-        rc++;
+        write_register(15,rc);
+        return(0);
       }
-    }
-    statusMsg << "}" << endl;
-  #endif
-    sp=read_register(rn);
-    for(ra=0,rb=0x01;rb;rb=(rb<<1)&0xFF,ra++)
-    {
-      if(inst&rb)
+      else
       {
-        write_register(ra,read32(sp));
-        sp+=4;
+        //fprintf(stderr,"cannot branch to arm 0x%08X 0x%04X\n",pc,inst);
+        // fxq: or maybe this one??
+        return(1);
       }
     }
-    write_register(rn,sp);
-    return(0);
-  }
 
-  //LDR(1) two register immediate
-  if((inst&0xF800)==0x6800)
-  {
-    rd=(inst>>0)&0x07;
-    rn=(inst>>3)&0x07;
-    rb=(inst>>6)&0x1F;
-    rb<<=2;
-    DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
-    rb=read_register(rn)+rb;
-    rc=read32(rb);
-    write_register(rd,rc);
-    return(0);
-  }
-
-  //LDR(2) three register
-  if((inst&0xFE00)==0x5800)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rm=(inst>>6)&0x7;
-    DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",r" << dec << "]" << endl);
-    rb=read_register(rn)+read_register(rm);
-    rc=read32(rb);
-    write_register(rd,rc);
-    return(0);
-  }
+    //CMN
+    case Op_cmn:
+    {
+      rn=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "cmns r" << dec << rn << ",r" << dec << rm << endl);
+      ra=read_register(rn);
+      rb=read_register(rm);
+      rc=ra+rb;
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra,rb,0);
+      do_add_vflag(ra,rb,rc);
+      return(0);
+    }
 
-  //LDR(3)
-  if((inst&0xF800)==0x4800)
-  {
-    rb=(inst>>0)&0xFF;
-    rd=(inst>>8)&0x07;
-    rb<<=2;
-    DO_DISS(statusMsg << "ldr r" << dec << rd << ",[PC+#0x" << Base::HEX2 << rb << "] ");
-    ra=read_register(15);
-    ra&=~3;
-    rb+=ra;
-    DO_DISS(statusMsg << ";@ 0x" << Base::HEX2 << rb << endl);
-    rc=read32(rb);
-    write_register(rd,rc);
-    return(0);
-  }
+    //CMP(1) compare immediate
+    case Op_cmp1:
+    {
+      rb=(inst>>0)&0xFF;
+      rn=(inst>>8)&0x07;
+      DO_DISS(statusMsg << "cmp r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
+      ra=read_register(rn);
+      rc=ra-rb;
+      //fprintf(stderr,"0x%08X 0x%08X\n",ra,rb);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra,~rb,1);
+      do_sub_vflag(ra,rb,rc);
+      return(0);
+    }
 
-  //LDR(4)
-  if((inst&0xF800)==0x9800)
-  {
-    rb=(inst>>0)&0xFF;
-    rd=(inst>>8)&0x07;
-    rb<<=2;
-    DO_DISS(statusMsg << "ldr r" << dec << rd << ",[SP+#0x" << Base::HEX2 << rb << "]" << endl);
-    ra=read_register(13);
-    //ra&=~3;
-    rb+=ra;
-    rc=read32(rb);
-    write_register(rd,rc);
-    return(0);
-  }
+    //CMP(2) compare register
+    case Op_cmp2:
+    {
+      rn=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
+      ra=read_register(rn);
+      rb=read_register(rm);
+      rc=ra-rb;
+      //fprintf(stderr,"0x%08X 0x%08X\n",ra,rb);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra,~rb,1);
+      do_sub_vflag(ra,rb,rc);
+      return(0);
+    }
 
-  //LDRB(1)
-  if((inst&0xF800)==0x7800)
-  {
-    rd=(inst>>0)&0x07;
-    rn=(inst>>3)&0x07;
-    rb=(inst>>6)&0x1F;
-    DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
-    rb=read_register(rn)+rb;
-    rc=read16(rb&(~1));
-    if(rb&1)
+    //CMP(3) compare high register
+    case Op_cmp3:
     {
-      rc>>=8;
+      if(((inst>>6)&3)==0x0)
+      {
+        //UNPREDICTABLE
+      }
+      rn=(inst>>0)&0x7;
+      rn|=(inst>>4)&0x8;
+      if(rn==0xF)
+      {
+        //UNPREDICTABLE
+      }
+      rm=(inst>>3)&0xF;
+      DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
+      ra=read_register(rn);
+      rb=read_register(rm);
+      rc=ra-rb;
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra,~rb,1);
+      do_sub_vflag(ra,rb,rc);
+
+  #if 0
+      if(cpsr&CPSR_N) statusMsg << "N"; else statusMsg << "n";
+      if(cpsr&CPSR_Z) statusMsg << "Z"; else statusMsg << "z";
+      if(cpsr&CPSR_C) statusMsg << "C"; else statusMsg << "c";
+      if(cpsr&CPSR_V) statusMsg << "V"; else statusMsg << "v";
+      statusMsg << " -- 0x" << Base::HEX8 << ra << " 0x" << Base::HEX8 << rb << endl;
+  #endif
+      return(0);
     }
-    else
+
+    //CPS
+    case Op_cps:
     {
+      DO_DISS(statusMsg << "cps TODO" << endl);
+      return(1);
     }
-    write_register(rd,rc&0xFF);
-    return(0);
-  }
 
-  //LDRB(2)
-  if((inst&0xFE00)==0x5C00)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rm=(inst>>6)&0x7;
-    DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb=read_register(rn)+read_register(rm);
-    rc=read16(rb&(~1));
-    if(rb&1)
+    //CPY copy high register
+    case Op_cpy:
     {
-      rc>>=8;
+      //same as mov except you can use both low registers
+      //going to let mov handle high registers
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "cpy r" << dec << rd << ",r" << dec << rm << endl);
+      rc=read_register(rm);
+      write_register(rd,rc);
+      return(0);
     }
-    else
+
+    //EOR
+    case Op_eor:
     {
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "eors r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rd);
+      rb=read_register(rm);
+      rc=ra^rb;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
     }
-    write_register(rd,rc&0xFF);
-    return(0);
-  }
 
-  //LDRH(1)
-  if((inst&0xF800)==0x8800)
-  {
-    rd=(inst>>0)&0x07;
-    rn=(inst>>3)&0x07;
-    rb=(inst>>6)&0x1F;
-    rb<<=1;
-    DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
-    rb=read_register(rn)+rb;
-    rc=read16(rb);
-    write_register(rd,rc&0xFFFF);
-    return(0);
-  }
+    //LDMIA
+    case Op_ldmia:
+    {
+      rn=(inst>>8)&0x7;
+    #if defined(THUMB_DISS)
+      statusMsg << "ldmia r" << dec << rn << "!,{";
+      for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          if(rc) statusMsg << ",";
+          statusMsg << "r" << dec << ra;
+          rc++;
+        }
+      }
+      statusMsg << "}" << endl;
+    #endif
+      sp=read_register(rn);
+      for(ra=0,rb=0x01;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          write_register(ra,read32(sp));
+          sp+=4;
+        }
+      }
+      write_register(rn,sp);
+      return(0);
+    }
 
-  //LDRH(2)
-  if((inst&0xFE00)==0x5A00)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rm=(inst>>6)&0x7;
-    DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb=read_register(rn)+read_register(rm);
-    rc=read16(rb);
-    write_register(rd,rc&0xFFFF);
-    return(0);
-  }
+    //LDR(1) two register immediate
+    case Op_ldr1:
+    {
+      rd=(inst>>0)&0x07;
+      rn=(inst>>3)&0x07;
+      rb=(inst>>6)&0x1F;
+      rb<<=2;
+      DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
+      rb=read_register(rn)+rb;
+      rc=read32(rb);
+      write_register(rd,rc);
+      return(0);
+    }
 
-  //LDRSB
-  if((inst&0xFE00)==0x5600)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rm=(inst>>6)&0x7;
-    DO_DISS(statusMsg << "ldrsb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb=read_register(rn)+read_register(rm);
-    rc=read16(rb&(~1));
-    if(rb&1)
+    //LDR(2) three register
+    case Op_ldr2:
     {
-      rc>>=8;
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rm=(inst>>6)&0x7;
+      DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",r" << dec << "]" << endl);
+      rb=read_register(rn)+read_register(rm);
+      rc=read32(rb);
+      write_register(rd,rc);
+      return(0);
     }
-    else
+
+    //LDR(3)
+    case Op_ldr3:
     {
+      rb=(inst>>0)&0xFF;
+      rd=(inst>>8)&0x07;
+      rb<<=2;
+      DO_DISS(statusMsg << "ldr r" << dec << rd << ",[PC+#0x" << Base::HEX2 << rb << "] ");
+      ra=read_register(15);
+      ra&=~3;
+      rb+=ra;
+      DO_DISS(statusMsg << ";@ 0x" << Base::HEX2 << rb << endl);
+      rc=read32(rb);
+      write_register(rd,rc);
+      return(0);
     }
-    rc&=0xFF;
-    if(rc&0x80) rc|=((~0)<<8);
-    write_register(rd,rc);
-    return(0);
-  }
 
-  //LDRSH
-  if((inst&0xFE00)==0x5E00)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rm=(inst>>6)&0x7;
-    DO_DISS(statusMsg << "ldrsh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb=read_register(rn)+read_register(rm);
-    rc=read16(rb);
-    rc&=0xFFFF;
-    if(rc&0x8000) rc|=((~0)<<16);
-    write_register(rd,rc);
-    return(0);
-  }
+    //LDR(4)
+    case Op_ldr4:
+    {
+      rb=(inst>>0)&0xFF;
+      rd=(inst>>8)&0x07;
+      rb<<=2;
+      DO_DISS(statusMsg << "ldr r" << dec << rd << ",[SP+#0x" << Base::HEX2 << rb << "]" << endl);
+      ra=read_register(13);
+      //ra&=~3;
+      rb+=ra;
+      rc=read32(rb);
+      write_register(rd,rc);
+      return(0);
+    }
 
-  //LSL(1)
-  if((inst&0xF800)==0x0000)
-  {
-    rd=(inst>>0)&0x07;
-    rm=(inst>>3)&0x07;
-    rb=(inst>>6)&0x1F;
-    DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
-    rc=read_register(rm);
-    if(rb==0)
+    //LDRB(1)
+    case Op_ldrb1:
     {
-      //if immed_5 == 0
-      //C unnaffected
-      //result not shifted
+      rd=(inst>>0)&0x07;
+      rn=(inst>>3)&0x07;
+      rb=(inst>>6)&0x1F;
+      DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
+      rb=read_register(rn)+rb;
+      rc=read16(rb&(~1));
+      if(rb&1)
+      {
+        rc>>=8;
+      }
+      else
+      {
+      }
+      write_register(rd,rc&0xFF);
+      return(0);
     }
-    else
+
+    //LDRB(2)
+    case Op_ldrb2:
     {
-      //else immed_5 > 0
-      do_cflag_bit(rc&(1<<(32-rb)));
-      rc<<=rb;
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rm=(inst>>6)&0x7;
+      DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb=read_register(rn)+read_register(rm);
+      rc=read16(rb&(~1));
+      if(rb&1)
+      {
+        rc>>=8;
+      }
+      else
+      {
+      }
+      write_register(rd,rc&0xFF);
+      return(0);
     }
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
 
-  //LSL(2) two register
-  if((inst&0xFFC0)==0x4080)
-  {
-    rd=(inst>>0)&0x07;
-    rs=(inst>>3)&0x07;
-    DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rs << endl);
-    rc=read_register(rd);
-    rb=read_register(rs);
-    rb&=0xFF;
-    if(rb==0)
+    //LDRH(1)
+    case Op_ldrh1:
     {
+      rd=(inst>>0)&0x07;
+      rn=(inst>>3)&0x07;
+      rb=(inst>>6)&0x1F;
+      rb<<=1;
+      DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
+      rb=read_register(rn)+rb;
+      rc=read16(rb);
+      write_register(rd,rc&0xFFFF);
+      return(0);
     }
-    else if(rb<32)
+
+    //LDRH(2)
+    case Op_ldrh2:
     {
-      do_cflag_bit(rc&(1<<(32-rb)));
-      rc<<=rb;
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rm=(inst>>6)&0x7;
+      DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb=read_register(rn)+read_register(rm);
+      rc=read16(rb);
+      write_register(rd,rc&0xFFFF);
+      return(0);
     }
-    else if(rb==32)
+
+    //LDRSB
+    case Op_ldrsb:
     {
-      do_cflag_bit(rc&1);
-      rc=0;
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rm=(inst>>6)&0x7;
+      DO_DISS(statusMsg << "ldrsb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb=read_register(rn)+read_register(rm);
+      rc=read16(rb&(~1));
+      if(rb&1)
+      {
+        rc>>=8;
+      }
+      else
+      {
+      }
+      rc&=0xFF;
+      if(rc&0x80) rc|=((~0)<<8);
+      write_register(rd,rc);
+      return(0);
     }
-    else
+
+    //LDRSH
+    case Op_ldrsh:
     {
-      do_cflag_bit(0);
-      rc=0;
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rm=(inst>>6)&0x7;
+      DO_DISS(statusMsg << "ldrsh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb=read_register(rn)+read_register(rm);
+      rc=read16(rb);
+      rc&=0xFFFF;
+      if(rc&0x8000) rc|=((~0)<<16);
+      write_register(rd,rc);
+      return(0);
     }
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
 
-  //LSR(1) two register immediate
-  if((inst&0xF800)==0x0800)
-  {
-    rd=(inst>>0)&0x07;
-    rm=(inst>>3)&0x07;
-    rb=(inst>>6)&0x1F;
-    DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
-    rc=read_register(rm);
-    if(rb==0)
+    //LSL(1)
+    case Op_lsl1:
     {
-      do_cflag_bit(rc&0x80000000);
-      rc=0;
+      rd=(inst>>0)&0x07;
+      rm=(inst>>3)&0x07;
+      rb=(inst>>6)&0x1F;
+      DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
+      rc=read_register(rm);
+      if(rb==0)
+      {
+        //if immed_5 == 0
+        //C unnaffected
+        //result not shifted
+      }
+      else
+      {
+        //else immed_5 > 0
+        do_cflag_bit(rc&(1<<(32-rb)));
+        rc<<=rb;
+      }
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
     }
-    else
+
+    //LSL(2) two register
+    case Op_lsl2:
     {
-      do_cflag_bit(rc&(1<<(rb-1)));
-      rc>>=rb;
+      rd=(inst>>0)&0x07;
+      rs=(inst>>3)&0x07;
+      DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rs << endl);
+      rc=read_register(rd);
+      rb=read_register(rs);
+      rb&=0xFF;
+      if(rb==0)
+      {
+      }
+      else if(rb<32)
+      {
+        do_cflag_bit(rc&(1<<(32-rb)));
+        rc<<=rb;
+      }
+      else if(rb==32)
+      {
+        do_cflag_bit(rc&1);
+        rc=0;
+      }
+      else
+      {
+        do_cflag_bit(0);
+        rc=0;
+      }
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
     }
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
 
-  //LSR(2) two register
-  if((inst&0xFFC0)==0x40C0)
-  {
-    rd=(inst>>0)&0x07;
-    rs=(inst>>3)&0x07;
-    DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rs << endl);
-    rc=read_register(rd);
-    rb=read_register(rs);
-    rb&=0xFF;
-    if(rb==0)
+    //LSR(1) two register immediate
+    case Op_lsr1:
     {
+      rd=(inst>>0)&0x07;
+      rm=(inst>>3)&0x07;
+      rb=(inst>>6)&0x1F;
+      DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
+      rc=read_register(rm);
+      if(rb==0)
+      {
+        do_cflag_bit(rc&0x80000000);
+        rc=0;
+      }
+      else
+      {
+        do_cflag_bit(rc&(1<<(rb-1)));
+        rc>>=rb;
+      }
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
     }
-    else if(rb<32)
+
+    //LSR(2) two register
+    case Op_lsr2:
     {
-      do_cflag_bit(rc&(1<<(32-rb)));
-      rc>>=rb;
+      rd=(inst>>0)&0x07;
+      rs=(inst>>3)&0x07;
+      DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rs << endl);
+      rc=read_register(rd);
+      rb=read_register(rs);
+      rb&=0xFF;
+      if(rb==0)
+      {
+      }
+      else if(rb<32)
+      {
+        do_cflag_bit(rc&(1<<(32-rb)));
+        rc>>=rb;
+      }
+      else if(rb==32)
+      {
+        do_cflag_bit(rc&0x80000000);
+        rc=0;
+      }
+      else
+      {
+        do_cflag_bit(0);
+        rc=0;
+      }
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
     }
-    else if(rb==32)
+
+    //MOV(1) immediate
+    case Op_mov1:
     {
-      do_cflag_bit(rc&0x80000000);
-      rc=0;
+      rb=(inst>>0)&0xFF;
+      rd=(inst>>8)&0x07;
+      DO_DISS(statusMsg << "movs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
+      write_register(rd,rb);
+      do_nflag(rb);
+      do_zflag(rb);
+      return(0);
     }
-    else
+
+    //MOV(2) two low registers
+    case Op_mov2:
     {
+      rd=(inst>>0)&7;
+      rn=(inst>>3)&7;
+      DO_DISS(statusMsg << "movs r" << dec << rd << ",r" << dec << rn << endl);
+      rc=read_register(rn);
+      //fprintf(stderr,"0x%08X\n",rc);
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
       do_cflag_bit(0);
-      rc=0;
+      do_vflag_bit(0);
+      return(0);
     }
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
 
-  //MOV(1) immediate
-  if((inst&0xF800)==0x2000)
-  {
-    rb=(inst>>0)&0xFF;
-    rd=(inst>>8)&0x07;
-    DO_DISS(statusMsg << "movs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
-    write_register(rd,rb);
-    do_nflag(rb);
-    do_zflag(rb);
-    return(0);
-  }
+    //MOV(3)
+    case Op_mov3:
+    {
+      rd=(inst>>0)&0x7;
+      rd|=(inst>>4)&0x8;
+      rm=(inst>>3)&0xF;
+      DO_DISS(statusMsg << "mov r" << dec << rd << ",r" << dec << rm << endl);
+      rc=read_register(rm);
+      if (rd==15) rc+=2; // fxq fix for MOV R15
+      write_register(rd,rc);
+      return(0);
+    }
 
-  //MOV(2) two low registers
-  if((inst&0xFFC0)==0x1C00)
-  {
-    rd=(inst>>0)&7;
-    rn=(inst>>3)&7;
-    DO_DISS(statusMsg << "movs r" << dec << rd << ",r" << dec << rn << endl);
-    rc=read_register(rn);
-    //fprintf(stderr,"0x%08X\n",rc);
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag_bit(0);
-    do_vflag_bit(0);
-    return(0);
-  }
+    //MUL
+    case Op_mul:
+    {
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "muls r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rd);
+      rb=read_register(rm);
+      rc=ra*rb;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
+    }
 
-  //MOV(3)
-  if((inst&0xFF00)==0x4600)
-  {
-    rd=(inst>>0)&0x7;
-    rd|=(inst>>4)&0x8;
-    rm=(inst>>3)&0xF;
-    DO_DISS(statusMsg << "mov r" << dec << rd << ",r" << dec << rm << endl);
-    rc=read_register(rm);
-    if (rd==15) rc+=2; // fxq fix for MOV R15
-    write_register(rd,rc);
-    return(0);
-  }
+    //MVN
+    case Op_mvn:
+    {
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "mvns r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rm);
+      rc=(~ra);
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
+    }
 
-  //MUL
-  if((inst&0xFFC0)==0x4340)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "muls r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rd);
-    rb=read_register(rm);
-    rc=ra*rb;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
+    //NEG
+    case Op_neg:
+    {
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "negs r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rm);
+      rc=0-ra;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(0,~ra,1);
+      do_sub_vflag(0,ra,rc);
+      return(0);
+    }
 
-  //MVN
-  if((inst&0xFFC0)==0x43C0)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "mvns r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rm);
-    rc=(~ra);
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
+    //ORR
+    case Op_orr:
+    {
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "orrs r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rd);
+      rb=read_register(rm);
+      rc=ra|rb;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
+    }
 
-  //NEG
-  if((inst&0xFFC0)==0x4240)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "negs r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rm);
-    rc=0-ra;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(0,~ra,1);
-    do_sub_vflag(0,ra,rc);
-    return(0);
-  }
+    //POP
+    case Op_pop:
+    {
+    #if defined(THUMB_DISS)
+      statusMsg << "pop {";
+      for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          if(rc) statusMsg << ",";
+          statusMsg << "r" << dec << ra;
+          rc++;
+        }
+      }
+      if(inst&0x100)
+      {
+        if(rc) statusMsg << ",";
+        statusMsg << "pc";
+      }
+      statusMsg << "}" << endl;
+    #endif
 
-  //ORR
-  if((inst&0xFFC0)==0x4300)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "orrs r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rd);
-    rb=read_register(rm);
-    rc=ra|rb;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
+      sp=read_register(13);
+      for(ra=0,rb=0x01;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          write_register(ra,read32(sp));
+          sp+=4;
+        }
+      }
+      if(inst&0x100)
+      {
+        rc=read32(sp);
+        rc+=2;
+        write_register(15,rc);
+        sp+=4;
+      }
+      write_register(13,sp);
+      return(0);
+    }
 
-  //POP
-  if((inst&0xFE00)==0xBC00)
-  {
-  #if defined(THUMB_DISS)
-    statusMsg << "pop {";
-    for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+    //PUSH
+    case Op_push:
     {
-      if(inst&rb)
+    #if defined(THUMB_DISS)
+      statusMsg << "push {";
+      for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          if(rc) statusMsg << ",";
+          statusMsg << "r" << dec << ra;
+          rc++;
+        }
+      }
+      if(inst&0x100)
       {
         if(rc) statusMsg << ",";
-        statusMsg << "r" << dec << ra;
-        rc++;
+        statusMsg << "lr";
+      }
+      statusMsg << "}" << endl;
+    #endif
+
+      sp=read_register(13);
+      //fprintf(stderr,"sp 0x%08X\n",sp);
+      for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          rc++;
+        }
+      }
+      if(inst&0x100) rc++;
+      rc<<=2;
+      sp-=rc;
+      rd=sp;
+      for(ra=0,rb=0x01;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          write32(rd,read_register(ra));
+          rd+=4;
+        }
       }
+      if(inst&0x100)
+      {
+        write32(rd,read_register(14));
+      }
+      write_register(13,sp);
+      return(0);
     }
-    if(inst&0x100)
+
+    //REV
+    case Op_rev:
     {
-      if(rc) statusMsg << ",";
-      statusMsg << "pc";
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "rev r" << dec << rd << ",r" << dec << rn << endl);
+      ra=read_register(rn);
+      rc =((ra>> 0)&0xFF)<<24;
+      rc|=((ra>> 8)&0xFF)<<16;
+      rc|=((ra>>16)&0xFF)<< 8;
+      rc|=((ra>>24)&0xFF)<< 0;
+      write_register(rd,rc);
+      return(0);
     }
-    statusMsg << "}" << endl;
-  #endif
 
-    sp=read_register(13);
-    for(ra=0,rb=0x01;rb;rb=(rb<<1)&0xFF,ra++)
+    //REV16
+    case Op_rev16:
     {
-      if(inst&rb)
-      {
-        write_register(ra,read32(sp));
-        sp+=4;
-      }
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "rev16 r" << dec << rd << ",r" << dec << rn << endl);
+      ra=read_register(rn);
+      rc =((ra>> 0)&0xFF)<< 8;
+      rc|=((ra>> 8)&0xFF)<< 0;
+      rc|=((ra>>16)&0xFF)<<24;
+      rc|=((ra>>24)&0xFF)<<16;
+      write_register(rd,rc);
+      return(0);
     }
-    if(inst&0x100)
+
+    //REVSH
+    case Op_revsh:
     {
-      rc=read32(sp);
-      rc+=2;
-      write_register(15,rc);
-      sp+=4;
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "revsh r" << dec << rd << ",r" << dec << rn << endl);
+      ra=read_register(rn);
+      rc =((ra>> 0)&0xFF)<< 8;
+      rc|=((ra>> 8)&0xFF)<< 0;
+      if(rc&0x8000) rc|=0xFFFF0000;
+      else          rc&=0x0000FFFF;
+      write_register(rd,rc);
+      return(0);
     }
-    write_register(13,sp);
-    return(0);
-  }
 
-  //PUSH
-  if((inst&0xFE00)==0xB400)
-  {
-  #if defined(THUMB_DISS)
-    statusMsg << "push {";
-    for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+    //ROR
+    case Op_ror:
     {
-      if(inst&rb)
+      rd=(inst>>0)&0x7;
+      rs=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "rors r" << dec << rd << ",r" << dec << rs << endl);
+      rc=read_register(rd);
+      ra=read_register(rs);
+      ra&=0xFF;
+      if(ra==0)
       {
-        if(rc) statusMsg << ",";
-        statusMsg << "r" << dec << ra;
-        rc++;
       }
+      else
+      {
+        ra&=0x1F;
+        if(ra==0)
+        {
+          do_cflag_bit(rc&0x80000000);
+        }
+        else
+        {
+          do_cflag_bit(rc&(1<<(ra-1)));
+          rb=rc<<(32-ra);
+          rc>>=ra;
+          rc|=rb;
+        }
+      }
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
     }
-    if(inst&0x100)
+
+    //SBC
+    case Op_sbc:
     {
-      if(rc) statusMsg << ",";
-      statusMsg << "lr";
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "sbc r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rd);
+      rb=read_register(rm);
+      rc=ra-rb;
+      if(!(cpsr&CPSR_C)) rc--;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra,rb,0);
+      do_sub_vflag(ra,rb,rc);
+      return(0);
     }
-    statusMsg << "}" << endl;
-  #endif
 
-    sp=read_register(13);
-    //fprintf(stderr,"sp 0x%08X\n",sp);
-    for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+    //SETEND
+    case Op_setend:
     {
-      if(inst&rb)
-      {
-        rc++;
-      }
+      statusMsg << "setend not implemented" << endl;
+      return(1);
     }
-    if(inst&0x100) rc++;
-    rc<<=2;
-    sp-=rc;
-    rd=sp;
-    for(ra=0,rb=0x01;rb;rb=(rb<<1)&0xFF,ra++)
+
+    //STMIA
+    case Op_stmia:
     {
-      if(inst&rb)
+      rn=(inst>>8)&0x7;
+    #if defined(THUMB_DISS)
+      statusMsg << "stmia r" << dec << rn << "!,{";
+      for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
       {
-        write32(rd,read_register(ra));
-        rd+=4;
+        if(inst&rb)
+        {
+          if(rc) statusMsg << ",";
+          statusMsg << "r" << dec << ra;
+          rc++;
+        }
       }
+      statusMsg << "}" << endl;
+    #endif
+
+      sp=read_register(rn);
+      for(ra=0,rb=0x01;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          write32(sp,read_register(ra));
+          sp+=4;
+        }
+      }
+      write_register(rn,sp);
+      return(0);
     }
-    if(inst&0x100)
+
+    //STR(1)
+    case Op_str1:
     {
-      write32(rd,read_register(14));
+      rd=(inst>>0)&0x07;
+      rn=(inst>>3)&0x07;
+      rb=(inst>>6)&0x1F;
+      rb<<=2;
+      DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
+      rb=read_register(rn)+rb;
+      rc=read_register(rd);
+      write32(rb,rc);
+      return(0);
     }
-    write_register(13,sp);
-    return(0);
-  }
-
-  //REV
-  if((inst&0xFFC0)==0xBA00)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "rev r" << dec << rd << ",r" << dec << rn << endl);
-    ra=read_register(rn);
-    rc =((ra>> 0)&0xFF)<<24;
-    rc|=((ra>> 8)&0xFF)<<16;
-    rc|=((ra>>16)&0xFF)<< 8;
-    rc|=((ra>>24)&0xFF)<< 0;
-    write_register(rd,rc);
-    return(0);
-  }
 
-  //REV16
-  if((inst&0xFFC0)==0xBA40)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "rev16 r" << dec << rd << ",r" << dec << rn << endl);
-    ra=read_register(rn);
-    rc =((ra>> 0)&0xFF)<< 8;
-    rc|=((ra>> 8)&0xFF)<< 0;
-    rc|=((ra>>16)&0xFF)<<24;
-    rc|=((ra>>24)&0xFF)<<16;
-    write_register(rd,rc);
-    return(0);
-  }
+    //STR(2)
+    case Op_str2:
+    {
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rm=(inst>>6)&0x7;
+      DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb=read_register(rn)+read_register(rm);
+      rc=read_register(rd);
+      write32(rb,rc);
+      return(0);
+    }
 
-  //REVSH
-  if((inst&0xFFC0)==0xBAC0)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "revsh r" << dec << rd << ",r" << dec << rn << endl);
-    ra=read_register(rn);
-    rc =((ra>> 0)&0xFF)<< 8;
-    rc|=((ra>> 8)&0xFF)<< 0;
-    if(rc&0x8000) rc|=0xFFFF0000;
-    else          rc&=0x0000FFFF;
-    write_register(rd,rc);
-    return(0);
-  }
+    //STR(3)
+    case Op_str3:
+    {
+      rb=(inst>>0)&0xFF;
+      rd=(inst>>8)&0x07;
+      rb<<=2;
+      DO_DISS(statusMsg << "str r" << dec << rd << ",[SP,#0x" << Base::HEX2 << rb << "]" << endl);
+      rb=read_register(13)+rb;
+      //fprintf(stderr,"0x%08X\n",rb);
+      rc=read_register(rd);
+      write32(rb,rc);
+      return(0);
+    }
 
-  //ROR
-  if((inst&0xFFC0)==0x41C0)
-  {
-    rd=(inst>>0)&0x7;
-    rs=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "rors r" << dec << rd << ",r" << dec << rs << endl);
-    rc=read_register(rd);
-    ra=read_register(rs);
-    ra&=0xFF;
-    if(ra==0)
+    //STRB(1)
+    case Op_strb1:
     {
+      rd=(inst>>0)&0x07;
+      rn=(inst>>3)&0x07;
+      rb=(inst>>6)&0x1F;
+      DO_DISS(statusMsg << "strb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX8 << rb << "]" << endl);
+      rb=read_register(rn)+rb;
+      rc=read_register(rd);
+      ra=read16(rb&(~1));
+      if(rb&1)
+      {
+        ra&=0x00FF;
+        ra|=rc<<8;
+      }
+      else
+      {
+        ra&=0xFF00;
+        ra|=rc&0x00FF;
+      }
+      write16(rb&(~1),ra&0xFFFF);
+      return(0);
     }
-    else
+
+    //STRB(2)
+    case Op_strb2:
     {
-      ra&=0x1F;
-      if(ra==0)
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rm=(inst>>6)&0x7;
+      DO_DISS(statusMsg << "strb r" << dec << rd << ",[r" << dec << rn << ",r" << rm << "]" << endl);
+      rb=read_register(rn)+read_register(rm);
+      rc=read_register(rd);
+      ra=read16(rb&(~1));
+      if(rb&1)
       {
-        do_cflag_bit(rc&0x80000000);
+        ra&=0x00FF;
+        ra|=rc<<8;
       }
       else
       {
-        do_cflag_bit(rc&(1<<(ra-1)));
-        rb=rc<<(32-ra);
-        rc>>=ra;
-        rc|=rb;
+        ra&=0xFF00;
+        ra|=rc&0x00FF;
       }
+      write16(rb&(~1),ra&0xFFFF);
+      return(0);
     }
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
-  }
 
-  //SBC
-  if((inst&0xFFC0)==0x4180)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "sbc r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rd);
-    rb=read_register(rm);
-    rc=ra-rb;
-    if(!(cpsr&CPSR_C)) rc--;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra,rb,0);
-    do_sub_vflag(ra,rb,rc);
-    return(0);
-  }
+    //STRH(1)
+    case Op_strh1:
+    {
+      rd=(inst>>0)&0x07;
+      rn=(inst>>3)&0x07;
+      rb=(inst>>6)&0x1F;
+      rb<<=1;
+      DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
+      rb=read_register(rn)+rb;
+      rc=read_register(rd);
+      write16(rb,rc&0xFFFF);
+      return(0);
+    }
 
-  //SETEND
-  if((inst&0xFFF7)==0xB650)
-  {
-    statusMsg << "setend not implemented" << endl;
-    return(1);
-  }
+    //STRH(2)
+    case Op_strh2:
+    {
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rm=(inst>>6)&0x7;
+      DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb=read_register(rn)+read_register(rm);
+      rc=read_register(rd);
+      write16(rb,rc&0xFFFF);
+      return(0);
+    }
 
-  //STMIA
-  if((inst&0xF800)==0xC000)
-  {
-    rn=(inst>>8)&0x7;
-  #if defined(THUMB_DISS)
-    statusMsg << "stmia r" << dec << rn << "!,{";
-    for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+    //SUB(1)
+    case Op_sub1:
     {
-      if(inst&rb)
-      {
-        if(rc) statusMsg << ",";
-        statusMsg << "r" << dec << ra;
-        rc++;
-      }
+      rd=(inst>>0)&7;
+      rn=(inst>>3)&7;
+      rb=(inst>>6)&7;
+      DO_DISS(statusMsg << "subs r" << dec << rd << ",r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
+      ra=read_register(rn);
+      rc=ra-rb;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra,~rb,1);
+      do_sub_vflag(ra,rb,rc);
+      return(0);
     }
-    statusMsg << "}" << endl;
-  #endif
 
-    sp=read_register(rn);
-    for(ra=0,rb=0x01;rb;rb=(rb<<1)&0xFF,ra++)
+    //SUB(2)
+    case Op_sub2:
     {
-      if(inst&rb)
-      {
-        write32(sp,read_register(ra));
-        sp+=4;
-      }
+      rb=(inst>>0)&0xFF;
+      rd=(inst>>8)&0x07;
+      DO_DISS(statusMsg << "subs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
+      ra=read_register(rd);
+      rc=ra-rb;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra,~rb,1);
+      do_sub_vflag(ra,rb,rc);
+      return(0);
     }
-    write_register(rn,sp);
-    return(0);
-  }
 
-  //STR(1)
-  if((inst&0xF800)==0x6000)
-  {
-    rd=(inst>>0)&0x07;
-    rn=(inst>>3)&0x07;
-    rb=(inst>>6)&0x1F;
-    rb<<=2;
-    DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
-    rb=read_register(rn)+rb;
-    rc=read_register(rd);
-    write32(rb,rc);
-    return(0);
-  }
+    //SUB(3)
+    case Op_sub3:
+    {
+      rd=(inst>>0)&0x7;
+      rn=(inst>>3)&0x7;
+      rm=(inst>>6)&0x7;
+      DO_DISS(statusMsg << "subs r" << dec << rd << ",r" << dec << rn << ",r" << dec << rm << endl);
+      ra=read_register(rn);
+      rb=read_register(rm);
+      rc=ra-rb;
+      write_register(rd,rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra,~rb,1);
+      do_sub_vflag(ra,rb,rc);
+      return(0);
+    }
 
-  //STR(2)
-  if((inst&0xFE00)==0x5000)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rm=(inst>>6)&0x7;
-    DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb=read_register(rn)+read_register(rm);
-    rc=read_register(rd);
-    write32(rb,rc);
-    return(0);
-  }
+    //SUB(4)
+    case Op_sub4:
+    {
+      rb=inst&0x7F;
+      rb<<=2;
+      DO_DISS(statusMsg << "sub SP,#0x" << Base::HEX2 << rb << endl);
+      ra=read_register(13);
+      ra-=rb;
+      write_register(13,ra);
+      return(0);
+    }
 
-  //STR(3)
-  if((inst&0xF800)==0x9000)
-  {
-    rb=(inst>>0)&0xFF;
-    rd=(inst>>8)&0x07;
-    rb<<=2;
-    DO_DISS(statusMsg << "str r" << dec << rd << ",[SP,#0x" << Base::HEX2 << rb << "]" << endl);
-    rb=read_register(13)+rb;
-    //fprintf(stderr,"0x%08X\n",rb);
-    rc=read_register(rd);
-    write32(rb,rc);
-    return(0);
-  }
+    //SWI
+    case Op_swi:
+    {
+      rb=inst&0xFF;
+      DO_DISS(statusMsg << "swi 0x" << Base::HEX2 << rb << endl);
+      statusMsg << endl << endl << "swi 0x" << Base::HEX2 << rb << endl;
+      return(1);
+    }
 
-  //STRB(1)
-  if((inst&0xF800)==0x7000)
-  {
-    rd=(inst>>0)&0x07;
-    rn=(inst>>3)&0x07;
-    rb=(inst>>6)&0x1F;
-    DO_DISS(statusMsg << "strb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX8 << rb << "]" << endl);
-    rb=read_register(rn)+rb;
-    rc=read_register(rd);
-    ra=read16(rb&(~1));
-    if(rb&1)
-    {
-      ra&=0x00FF;
-      ra|=rc<<8;
+    //SXTB
+    case Op_sxtb:
+    {
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "sxtb r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rm);
+      rc=ra&0xFF;
+      if(rc&0x80) rc|=(~0)<<8;
+      write_register(rd,rc);
+      return(0);
     }
-    else
+
+    //SXTH
+    case Op_sxth:
     {
-      ra&=0xFF00;
-      ra|=rc&0x00FF;
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "sxth r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rm);
+      rc=ra&0xFFFF;
+      if(rc&0x8000) rc|=(~0)<<16;
+      write_register(rd,rc);
+      return(0);
     }
-    write16(rb&(~1),ra&0xFFFF);
-    return(0);
-  }
 
-  //STRB(2)
-  if((inst&0xFE00)==0x5400)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rm=(inst>>6)&0x7;
-    DO_DISS(statusMsg << "strb r" << dec << rd << ",[r" << dec << rn << ",r" << rm << "]" << endl);
-    rb=read_register(rn)+read_register(rm);
-    rc=read_register(rd);
-    ra=read16(rb&(~1));
-    if(rb&1)
-    {
-      ra&=0x00FF;
-      ra|=rc<<8;
+    //TST
+    case Op_tst:
+    {
+      rn=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "tst r" << dec << rn << ",r" << dec << rm << endl);
+      ra=read_register(rn);
+      rb=read_register(rm);
+      rc=ra&rb;
+      do_nflag(rc);
+      do_zflag(rc);
+      return(0);
     }
-    else
+
+    //UXTB
+    case Op_uxtb:
     {
-      ra&=0xFF00;
-      ra|=rc&0x00FF;
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "uxtb r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rm);
+      rc=ra&0xFF;
+      write_register(rd,rc);
+      return(0);
     }
-    write16(rb&(~1),ra&0xFFFF);
-    return(0);
-  }
 
-  //STRH(1)
-  if((inst&0xF800)==0x8000)
-  {
-    rd=(inst>>0)&0x07;
-    rn=(inst>>3)&0x07;
-    rb=(inst>>6)&0x1F;
-    rb<<=1;
-    DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
-    rb=read_register(rn)+rb;
-    rc=read_register(rd);
-    write16(rb,rc&0xFFFF);
-    return(0);
+    //UXTH
+    case Op_uxth:
+    {
+      rd=(inst>>0)&0x7;
+      rm=(inst>>3)&0x7;
+      DO_DISS(statusMsg << "uxth r" << dec << rd << ",r" << dec << rm << endl);
+      ra=read_register(rm);
+      rc=ra&0xFFFF;
+      write_register(rd,rc);
+      return(0);
+    }
   }
 
-  //STRH(2)
-  if((inst&0xFE00)==0x5200)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rm=(inst>>6)&0x7;
-    DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb=read_register(rn)+read_register(rm);
-    rc=read_register(rd);
-    write16(rb,rc&0xFFFF);
-    return(0);
-  }
+  statusMsg << "invalid instruction " << Base::HEX8 << pc << " " << Base::HEX4 << inst << endl;
+  return(1);
+}
 
-  //SUB(1)
-  if((inst&0xFE00)==0x1E00)
-  {
-    rd=(inst>>0)&7;
-    rn=(inst>>3)&7;
-    rb=(inst>>6)&7;
-    DO_DISS(statusMsg << "subs r" << dec << rd << ",r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
-    ra=read_register(rn);
-    rc=ra-rb;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra,~rb,1);
-    do_sub_vflag(ra,rb,rc);
-    return(0);
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Approximate timing of the LPC2103 on the Harmony cartridge: the MAM reads
+// flash a 16 byte line at a time, which takes 4 clocks at 70MHz (MAMTIM),
+// so every access it can't serve from its buffers stalls for 3 clocks
+#define MAM_LINE_SHIFT  4
+#define MAM_WAIT_STATES 3
 
-  //SUB(2)
-  if((inst&0xF800)==0x3800)
-  {
-    rb=(inst>>0)&0xFF;
-    rd=(inst>>8)&0x07;
-    DO_DISS(statusMsg << "subs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
-    ra=read_register(rd);
-    rc=ra-rb;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra,~rb,1);
-    do_sub_vflag(ra,rb,rc);
-    return(0);
+int Thumbulator::execute_profiled ( void )
+{
+  uInt32 pc = read_register(15);
+  uInt32 addr = pc-3;  // the address of the instruction about to be run
+
+  // Peek at the instruction, without counting it as a fetch; code outside
+  // of the regions isn't broken down any further
+  uInt32 inst = 0xFFFF;
+  const Region& r = regions[addr>>28];
+  if((r.access&REGION_FETCH) && (addr-r.start)<r.size)
+  {
+    const uInt16* p = r.data + ((addr-r.start)>>1);
+  #ifdef __BIG_ENDIAN__
+    inst=((*p>>8)|(*p<<8))&0xffff;
+  #else
+    inst=*p;
+  #endif
   }
 
-  //SUB(3)
-  if((inst&0xFE00)==0x1A00)
-  {
-    rd=(inst>>0)&0x7;
-    rn=(inst>>3)&0x7;
-    rm=(inst>>6)&0x7;
-    DO_DISS(statusMsg << "subs r" << dec << rd << ",r" << dec << rn << ",r" << dec << rm << endl);
-    ra=read_register(rn);
-    rb=read_register(rm);
-    rc=ra-rb;
-    write_register(rd,rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra,~rb,1);
-    do_sub_vflag(ra,rb,rc);
-    return(0);
+  // ARM7TDMI cycles of the instruction, and the address of any data it
+  // loads (which may come from flash)
+  uInt32 cycles = 1, load = 0xFFFFFFFF, n, m;
+  switch(decodeTable[inst])
+  {
+    case Op_ldr1:   // 1S + 1N + 1I
+      load = read_register((inst>>3)&0x7) + (((inst>>6)&0x1F)<<2);
+      cycles = 3;
+      break;
+    case Op_ldrb1:
+      load = read_register((inst>>3)&0x7) + ((inst>>6)&0x1F);
+      cycles = 3;
+      break;
+    case Op_ldrh1:
+      load = read_register((inst>>3)&0x7) + (((inst>>6)&0x1F)<<1);
+      cycles = 3;
+      break;
+    case Op_ldr2: case Op_ldrb2: case Op_ldrh2: case Op_ldrsb: case Op_ldrsh:
+      load = read_register((inst>>3)&0x7) + read_register((inst>>6)&0x7);
+      cycles = 3;
+      break;
+    case Op_ldr3:
+      load = ((pc+2)&~3) + ((inst&0xFF)<<2);
+      cycles = 3;
+      break;
+    case Op_ldr4:
+      cycles = 3;
+      break;
+
+    case Op_str1: case Op_str2: case Op_str3:   // 2N
+    case Op_strb1: case Op_strb2: case Op_strh1: case Op_strh2:
+      cycles = 2;
+      break;
+
+    case Op_ldmia:  // nS + 1N + 1I
+    case Op_pop:
+      for(n = 0, m = inst&0xFF; m; m &= m-1) n++;
+      load = read_register(decodeTable[inst] == Op_pop ? 13 : (inst>>8)&0x7);
+      cycles = n + ((inst&0x100) && decodeTable[inst] == Op_pop) + 2;
+      break;
+
+    case Op_stmia:  // (n-1)S + 2N
+    case Op_push:
+      for(n = 0, m = inst&0xFF; m; m &= m-1) n++;
+      cycles = n + ((inst&0x100) && decodeTable[inst] == Op_push) + 1;
+      break;
+
+    case Op_mul:    // 1S + mI, depending on the significant bytes of Rs
+      m = read_register(inst&0x7);
+      if((m&0xFFFFFF00) == 0 || (m&0xFFFFFF00) == 0xFFFFFF00)      cycles = 2;
+      else if((m&0xFFFF0000) == 0 || (m&0xFFFF0000) == 0xFFFF0000) cycles = 3;
+      else if((m&0xFF000000) == 0 || (m&0xFF000000) == 0xFF000000) cycles = 4;
+      else                                                         cycles = 5;
+      break;
+  }
+
+  int result = execute();
+
+  // Anything that changes the flow refills the pipeline (2S)
+  bool branch = read_register(15) != pc+2;
+  if(branch)
+    cycles += 2;
+
+  // Flash wait states, depending on the MAM mode; sequential fetches are
+  // always prefetched when it is on, and when fully enabled it also keeps
+  // the last branch target and the last line of data read
+  if((addr>>28) == 0)
+  {
+    uInt32 line = addr>>MAM_LINE_SHIFT;
+    bool sequential = addr == profileLastAddr+2;
+    switch(mamcr&3)
+    {
+      case 0:
+        cycles += MAM_WAIT_STATES;
+        break;
+      case 1:
+        if(!sequential)
+          cycles += MAM_WAIT_STATES;
+        break;
+      default:
+        if(!sequential && line != profileFetchLine && line != profileBranchLine)
+          cycles += MAM_WAIT_STATES;
+        if(!sequential)
+          profileBranchLine = line;
+        break;
+    }
+    profileFetchLine = line;
   }
-
-  //SUB(4)
-  if((inst&0xFF80)==0xB080)
+  profileLastAddr = addr;
+  if(load < ROMSIZE)
   {
-    rb=inst&0x7F;
-    rb<<=2;
-    DO_DISS(statusMsg << "sub SP,#0x" << Base::HEX2 << rb << endl);
-    ra=read_register(13);
-    ra-=rb;
-    write_register(13,ra);
-    return(0);
+    uInt32 line = load>>MAM_LINE_SHIFT;
+    if((mamcr&3) != 2 || line != profileDataLine)
+      cycles += MAM_WAIT_STATES;
+    profileDataLine = line;
   }
 
-  //SWI
-  if((inst&0xFF00)==0xDF00)
+  // Charge the instruction at its address in flash or RAM
+  uInt32 index = 0xFFFFFFFF;
+  if(addr < ROMSIZE)
+    index = addr>>1;
+  else if(addr-0x40000000 < RAMSIZE)
+    index = (ROMSIZE+addr-0x40000000)>>1;
+  if(index != 0xFFFFFFFF)
   {
-    rb=inst&0xFF;
-    DO_DISS(statusMsg << "swi 0x" << Base::HEX2 << rb << endl);
-    statusMsg << endl << endl << "swi 0x" << Base::HEX2 << rb << endl;
-    return(1);
+    profileCount[index]++;
+    profileCycles[index] += cycles;
   }
+  profileCallCycles += cycles;
 
-  //SXTB
-  if((inst&0xFFC0)==0xB240)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "sxtb r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rm);
-    rc=ra&0xFF;
-    if(rc&0x80) rc|=(~0)<<8;
-    write_register(rd,rc);
-    return(0);
-  }
+  return result;
+}
 
-  //SXTH
-  if((inst&0xFFC0)==0xB200)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "sxth r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rm);
-    rc=ra&0xFFFF;
-    if(rc&0x8000) rc|=(~0)<<16;
-    write_register(rd,rc);
-    return(0);
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::enableProfiling(bool enable)
+{
+  delete[] profileCount;  profileCount = NULL;
+  delete[] profileCycles; profileCycles = NULL;
+  profileFrames.clear();
+  memset(&profileFrameTotals, 0, sizeof(profileFrameTotals));
 
-  //TST
-  if((inst&0xFFC0)==0x4200)
+  profiling = enable;
+  if(profiling)
   {
-    rn=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "tst r" << dec << rn << ",r" << dec << rm << endl);
-    ra=read_register(rn);
-    rb=read_register(rm);
-    rc=ra&rb;
-    do_nflag(rc);
-    do_zflag(rc);
-    return(0);
+    const uInt32 size = (ROMSIZE+RAMSIZE)>>1;
+    profileCount = new uInt32[size];
+    profileCycles = new uInt64[size];
+    memset(profileCount, 0, size*sizeof(uInt32));
+    memset(profileCycles, 0, size*sizeof(uInt64));
   }
+}
 
-  //UXTB
-  if((inst&0xFFC0)==0xB2C0)
-  {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "uxtb r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rm);
-    rc=ra&0xFF;
-    write_register(rd,rc);
-    return(0);
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::profileFrame()
+{
+  if(!profiling)
+    return;
+
+  profileFrames.push_back(profileFrameTotals);
+  memset(&profileFrameTotals, 0, sizeof(profileFrameTotals));
+}
 
-  //UXTH
-  if((inst&0xFFC0)==0xB280)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Orders profile entries by decreasing cycles, then increasing address
+struct ProfileOrder
+{
+  const uInt64* cycles;
+  ProfileOrder(const uInt64* c) : cycles(c) { }
+  bool operator()(uInt32 a, uInt32 b) const
   {
-    rd=(inst>>0)&0x7;
-    rm=(inst>>3)&0x7;
-    DO_DISS(statusMsg << "uxth r" << dec << rd << ",r" << dec << rm << endl);
-    ra=read_register(rm);
-    rc=ra&0xFFFF;
-    write_register(rd,rc);
-    return(0);
+    return cycles[a] != cycles[b] ? cycles[a] > cycles[b] : a < b;
   }
+};
 
-  statusMsg << "invalid instruction " << Base::HEX8 << pc << " " << Base::HEX4 << inst << endl;
-  return(1);
+void Thumbulator::saveProfile(ostream& out) const
+{
+  if(!profiling)
+    return;
+
+  // Totals over all frames, including the current one
+  ProfileTotals all, frames;
+  memset(&all, 0, sizeof(all));
+  memset(&frames, 0, sizeof(frames));
+  for(uInt32 i = 0; i <= profileFrames.size(); ++i)
+  {
+    const ProfileTotals& t =
+      i < profileFrames.size() ? profileFrames[i] : profileFrameTotals;
+    if(t.calls == 0)
+      continue;
+    if(all.calls == 0 || t.minCallCycles < all.minCallCycles)
+      all.minCallCycles = t.minCallCycles;
+    all.maxCallCycles = BSPF_max(all.maxCallCycles, t.maxCallCycles);
+    all.calls += t.calls;
+    all.instructions += t.instructions;
+    all.cycles += t.cycles;
+    frames.calls++;
+    if(frames.calls == 1 || t.cycles < frames.minCallCycles)
+      frames.minCallCycles = t.cycles;
+    frames.maxCallCycles = BSPF_max(frames.maxCallCycles, t.cycles);
+  }
+
+  out << "Thumb ARM profile (cycles estimated for an LPC2103, MAMCR = "
+      << mamcr << ")" << endl << endl
+      << "calls         " << all.calls << endl
+      << "instructions  " << all.instructions << endl
+      << "cycles        " << all.cycles << endl;
+  if(all.calls > 0)
+    out << "cycles/call   min " << all.minCallCycles
+        << ", avg " << all.cycles / all.calls
+        << ", max " << all.maxCallCycles << endl
+        << "cycles/frame  min " << frames.minCallCycles
+        << ", avg " << all.cycles / frames.calls
+        << ", max " << frames.maxCallCycles
+        << " (" << frames.calls << " of " << profileFrames.size()
+        << " frames with calls)" << endl;
+
+  out << endl << "   frame  calls  instructions      cycles  max cycles/call" << endl;
+  for(uInt32 i = 0; i < profileFrames.size(); ++i)
+  {
+    const ProfileTotals& t = profileFrames[i];
+    if(t.calls > 0)
+      out << setw(8) << i << setw(7) << t.calls << setw(14) << t.instructions
+          << setw(12) << t.cycles << setw(17) << t.maxCallCycles << endl;
+  }
+
+  // Every instruction that was executed, most expensive first
+  Common::Array<uInt32> order;
+  const uInt32 size = (ROMSIZE+RAMSIZE)>>1;
+  for(uInt32 i = 0; i < size; ++i)
+    if(profileCount[i] > 0)
+      order.push_back(i);
+  if(order.size() > 0)
+    sort(&order[0], &order[0] + order.size(), ProfileOrder(profileCycles));
+
+  out << endl << " address       count      cycles       %" << endl;
+  for(uInt32 i = 0; i < order.size(); ++i)
+  {
+    uInt32 index = order[i];
+    uInt32 address = index < (ROMSIZE>>1) ? index<<1 :
+                     0x40000000 + ((index<<1) - ROMSIZE);
+    out << Base::HEX8 << address << dec << setfill(' ')
+        << setw(12) << profileCount[index]
+        << setw(12) << profileCycles[index]
+        << setw(8) << fixed << setprecision(2)
+        << (all.cycles ? 100.0 * profileCycles[index] / all.cycles : 0.0)
+        << endl;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1969,12 +2477,21 @@ int Thumbulator::reset ( void )
   reads=0;
   writes=0;
 
-  statusMsg.str("");
+  // Only clear the log when something was actually written to it
+  if(statusMsg.tellp() > 0)
+    statusMsg.str("");
+  errorMsg.clear();
+
+  profileCallCycles = 0;
+  profileLastAddr = profileFetchLine = profileBranchLine =
+    profileDataLine = 0xFFFFFFFF;
 
   return(0);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Thumbulator::trapOnFatal = true;
+uInt8 Thumbulator::decodeTable[65536];
+bool Thumbulator::decodeTableBuilt = false;
 
 #endif
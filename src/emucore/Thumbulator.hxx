@@ -27,6 +27,7 @@
 #ifdef THUMB_SUPPORT
 
 #include "bspf.hxx"
+#include "Array.hxx"
 
 #define ROMADDMASK 0x7FFF
 #define RAMADDMASK 0x1FFF
@@ -66,18 +67,32 @@ class Thumbulator
     ~Thumbulator();
 
     /**
-      Run the ARM code, and return when finished.  A string exception is
-      thrown in case of any fatal errors/aborts (if enabled), containing the
-      actual error, and the contents of the registers at that point in time.
+      Run the ARM code, and return when finished.  Nothing is allocated
+      along the way; the text of an error is only built when one occurs.
 
-      @return  The results of any debugging output (if enabled),
-               otherwise an empty string
+      @return  True if the code ran to completion, false if it was stopped
+               by a fatal error/abort (see errorMessage())
     */
-    string run();
+    bool run();
+
+    /**
+      The actual error that stopped the last call to run(), along with the
+      contents of the registers at that point in time (and any debugging
+      output, if enabled).
+    */
+    const string& errorMessage() const { return errorMsg; }
+
+    /**
+      Use a new copy of the flash image, after the cart had to move it
+      (see Cartridge::unshareImage).
+
+      @param rom_ptr  The new location of the flash image
+    */
+    void setROM(const uInt16* rom_ptr) { rom = rom_ptr; map_regions(); }
 
     /**
       Normally when a fatal error is encountered, the ARM emulation
-      immediately throws an exception and exits.  This method allows execution
+      immediately stops and run() returns false.  This method allows execution
       to continue, and simply log the error.
 
       Note that this is meant for developers only, and should normally be
@@ -89,6 +104,38 @@ class Thumbulator
     */
     static void trapFatalErrors(bool enable) { trapOnFatal = enable; }
 
+    /**
+      Enable or disable profiling of the ARM code.  While enabled, the
+      number of times each instruction is executed is recorded along with
+      an estimate of the cycles spent on it, using ARM7TDMI timings and
+      the flash wait states of the LPC2103 (as set up through MAMCR).
+      Totals are also kept for every call to run() and every frame.
+      Enabling profiling discards any earlier profile.
+
+      @param enable  Enable or disable (the default) profiling
+    */
+    void enableProfiling(bool enable);
+
+    /**
+      Answer whether the ARM code is being profiled.
+    */
+    bool profilingEnabled() const { return profiling; }
+
+    /**
+      Close the current frame of the profile; any further calls to run()
+      are counted towards the next one.
+    */
+    void profileFrame();
+
+    /**
+      Write the profile gathered so far to the given stream, as text:
+      the totals per call and per frame, followed by every instruction
+      executed, most expensive first.
+
+      @param out  The stream to write the profile to
+    */
+    void saveProfile(ostream& out) const;
+
   private:
     uInt32 read_register ( uInt32 reg );
     uInt32 write_register ( uInt32 reg, uInt32 data );
@@ -98,6 +145,7 @@ class Thumbulator
     uInt32 read32 ( uInt32 );
     void write16 ( uInt32 addr, uInt32 data );
     void write32 ( uInt32 addr, uInt32 data );
+    void map_regions ( void );
 
     void do_zflag ( uInt32 x );
     void do_nflag ( uInt32 x );
@@ -108,7 +156,7 @@ class Thumbulator
     void do_vflag_bit ( uInt32 x );
 
     // Throw a string exception containing an error referencing the given
-    // message and variables
+    // message and variables; run() catches it and answers false
     // Note that the return value is never used in these methods
     int fatalError(const char* opcode, uInt32 v1, const char* msg);
     int fatalError(const char* opcode, uInt32 v1, uInt32 v2, const char* msg);
@@ -116,9 +164,24 @@ class Thumbulator
     void dump_counters ( void );
     void dump_regs( void );
     int execute ( void );
+    int execute_profiled ( void );
     int reset ( void );
 
   private:
+    // The instructions (and variants of them) that execute() tells apart
+    enum Op {
+      Op_adc, Op_add1, Op_add2, Op_add3, Op_add4, Op_add5, Op_add6, Op_add7,
+      Op_and, Op_asr1, Op_asr2, Op_b1, Op_b2, Op_bic, Op_bkpt, Op_bl,
+      Op_blx2, Op_bx, Op_cmn, Op_cmp1, Op_cmp2, Op_cmp3, Op_cps, Op_cpy,
+      Op_eor, Op_ldmia, Op_ldr1, Op_ldr2, Op_ldr3, Op_ldr4, Op_ldrb1,
+      Op_ldrb2, Op_ldrh1, Op_ldrh2, Op_ldrsb, Op_ldrsh, Op_lsl1, Op_lsl2,
+      Op_lsr1, Op_lsr2, Op_mov1, Op_mov2, Op_mov3, Op_mul, Op_mvn, Op_neg,
+      Op_orr, Op_pop, Op_push, Op_rev, Op_rev16, Op_revsh, Op_ror, Op_sbc,
+      Op_setend, Op_stmia, Op_str1, Op_str2, Op_str3, Op_strb1, Op_strb2,
+      Op_strh1, Op_strh2, Op_sub1, Op_sub2, Op_sub3, Op_sub4, Op_swi,
+      Op_sxtb, Op_sxth, Op_tst, Op_uxtb, Op_uxth, Op_invalid
+    };
+
     const uInt16* rom;
     uInt16* ram;
     //Int32 copydata;
@@ -134,14 +197,59 @@ class Thumbulator
     //uInt32 reg_fiq[16]; //Fast Interrupt mode
     uInt32 mamcr;
 
+    // The parts of the address space backed by plain memory (the flash
+    // image and the DPC+ RAM), indexed by the top four address bits.
+    // Accesses of the given kinds within [start, start+size) go straight
+    // to 'data'; everything else (peripherals, the vectors, the driver
+    // area of RAM, bad addresses) takes the fully checked path.
+    enum { REGION_FETCH = 1<<0, REGION_READ = 1<<1, REGION_WRITE = 1<<2 };
+    struct Region {
+      uInt16* data;
+      uInt32 start;
+      uInt32 size;
+      uInt32 access;
+    };
+    Region regions[16];
+
+    // The profile of the ARM code, only gathered while profiling is
+    // enabled; the counts and cycles are kept per halfword of flash,
+    // followed by those of RAM
+    struct ProfileTotals {
+      uInt32 calls;
+      uInt64 instructions;
+      uInt64 cycles;
+      uInt64 minCallCycles;
+      uInt64 maxCallCycles;
+    };
+    bool profiling;
+    uInt32* profileCount;
+    uInt64* profileCycles;
+    Common::Array<ProfileTotals> profileFrames;
+    ProfileTotals profileFrameTotals;
+    uInt64 profileCallCycles;
+    // State of the MAM buffers: the address of the previous instruction,
+    // and the flash lines last fetched, branched to and read as data
+    uInt32 profileLastAddr;
+    uInt32 profileFetchLine, profileBranchLine, profileDataLine;
+
     uInt64 instructions;
     uInt64 fetches;
     uInt64 reads;
     uInt64 writes;
 
     ostringstream statusMsg;
+    string errorMsg;
 
     static bool trapOnFatal;
+
+    // The Op (as uInt8) of each possible instruction, so execute() can jump
+    // straight to it instead of testing every encoding in turn
+    static uInt8 decodeTable[65536];
+    static bool decodeTableBuilt;
+
+    // Fill decodeTable by matching every 16-bit instruction against the
+    // Thumb encodings, in the order execute() has always tested them
+    static void buildDecodeTable ( void );
 };
 
 #endif
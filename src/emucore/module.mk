@@ -64,10 +64,12 @@ MODULE_OBJS := \
 	src/emucore/SaveKey.o \
 	src/emucore/Serializer.o \
 	src/emucore/Settings.o \
+	src/emucore/SignatureSearch.o \
 	src/emucore/Switches.o \
 	src/emucore/StateManager.o \
 	src/emucore/System.o \
 	src/emucore/TIA.o \
+	src/emucore/TIAKernel.o \
 	src/emucore/TIASnd.o \
 	src/emucore/TIATables.o \
 	src/emucore/TrackBall.o \
@@ -52,7 +52,7 @@ AudioDialog::AudioDialog(OSystem* osystem, DialogContainer* parent,
 
   // Set real dimensions
   _w = 35 * fontWidth + 10;
-  _h = 7 * (lineHeight + 4) + 10;
+  _h = 9 * (lineHeight + 4) + 10;
 
   // Volume
   xpos = 3 * fontWidth;  ypos = 10;
@@ -96,6 +96,23 @@ AudioDialog::AudioDialog(OSystem* osystem, DialogContainer* parent,
   wid.push_back(myFreqPopup);
   ypos += lineHeight + 4;
 
+  // Resampling quality
+  items.clear();
+  items.push_back("Low", "low");
+  items.push_back("Medium", "medium");
+  items.push_back("High", "high");
+  myResamplingPopup = new PopUpWidget(this, font, xpos, ypos,
+                                      pwidth + myVolumeLabel->getWidth() - 4, lineHeight,
+                                      items, "Resampling: ", lwidth);
+  wid.push_back(myResamplingPopup);
+  ypos += lineHeight + 4;
+
+  // Rate control
+  myRateControlCheckbox = new CheckboxWidget(this, font, xpos + lwidth, ypos,
+                                             "Rate control");
+  wid.push_back(myRateControlCheckbox);
+  ypos += lineHeight + 4;
+
   // Enable sound
   xpos = (_w - (font.getStringWidth("Enable sound") + 10)) / 2;
   ypos += 4;
@@ -138,6 +155,12 @@ void AudioDialog::loadConfig()
   // Output frequency
   myFreqPopup->setSelected(instance().settings().getString("freq"), "31400");
 
+  // Resampling quality
+  myResamplingPopup->setSelected(instance().settings().getString("resampling"), "medium");
+
+  // Rate control
+  myRateControlCheckbox->setState(instance().settings().getBool("ratecontrol"));
+
   // Enable sound
   bool b = instance().settings().getBool("sound");
   mySoundEnableCheckbox->setState(b);
@@ -161,6 +184,15 @@ void AudioDialog::saveConfig()
   // Output frequency
   settings.setValue("freq", myFreqPopup->getSelectedTag().toString());
 
+  // Resampling quality
+  const string& quality = myResamplingPopup->getSelectedTag().toString();
+  settings.setValue("resampling", quality);
+  instance().sound().setResampling(quality);
+
+  // Rate control
+  settings.setValue("ratecontrol", myRateControlCheckbox->getState());
+  instance().sound().setRateControl(myRateControlCheckbox->getState());
+
   // Enable/disable sound (requires a restart to take effect)
   instance().sound().setEnabled(mySoundEnableCheckbox->getState());
 
@@ -178,6 +210,8 @@ void AudioDialog::setDefaults()
 
   myFragsizePopup->setSelected("512", "");
   myFreqPopup->setSelected("31400", "");
+  myResamplingPopup->setSelected("medium", "");
+  myRateControlCheckbox->setState(false);
 
   mySoundEnableCheckbox->setState(true);
 
@@ -194,6 +228,8 @@ void AudioDialog::handleSoundEnableChange(bool active)
   myVolumeLabel->setEnabled(active);
   myFragsizePopup->setEnabled(active);
   myFreqPopup->setEnabled(active);
+  myResamplingPopup->setEnabled(active);
+  myRateControlCheckbox->setEnabled(active);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -42,6 +42,8 @@ class AudioDialog : public Dialog
     StaticTextWidget* myVolumeLabel;
     PopUpWidget*      myFragsizePopup;
     PopUpWidget*      myFreqPopup;
+    PopUpWidget*      myResamplingPopup;
+    CheckboxWidget*   myRateControlCheckbox;
     CheckboxWidget*   mySoundEnableCheckbox;
 
   private:
@@ -28,7 +28,6 @@
 #include "EditTextWidget.hxx"
 #include "FSNode.hxx"
 #include "GameList.hxx"
-#include "MD5.hxx"
 #include "OptionsDialog.hxx"
 #include "GlobalPropsDialog.hxx"
 #include "LauncherFilterDialog.hxx"
@@ -36,6 +35,7 @@
 #include "OSystem.hxx"
 #include "Props.hxx"
 #include "PropsSet.hxx"
+#include "RomInfoCache.hxx"
 #include "RomInfoWidget.hxx"
 #include "Settings.hxx"
 #include "StringList.hxx"
@@ -55,6 +55,7 @@ LauncherDialog::LauncherDialog(OSystem* osystem, DialogContainer* parent,
     myQuitButton(NULL),
     myList(NULL),
     myGameList(NULL),
+    myRomInfoCache(NULL),
     myRomInfoWidget(NULL),
     myMenu(NULL),
     myGlobalProps(NULL),
@@ -177,6 +178,9 @@ LauncherDialog::LauncherDialog(OSystem* osystem, DialogContainer* parent,
   // the launcher needs
   myGameList = new GameList();
 
+  // Load the information remembered about ROMs from previous sessions
+  myRomInfoCache = new RomInfoCache(instance().romInfoCacheFile());
+
   addToFocusList(wid);
 
   // Create context menu for ROM list options
@@ -202,6 +206,7 @@ LauncherDialog::~LauncherDialog()
 {
   delete myOptions;
   delete myGameList;
+  delete myRomInfoCache;
   delete myMenu;
   delete myGlobalProps;
   delete myFilters;
@@ -222,7 +227,11 @@ const string& LauncherDialog::selectedRomMD5()
 
   // Make sure we have a valid md5 for this ROM
   if(myGameList->md5(item) == "")
-    myGameList->setMd5(item, MD5(node));
+  {
+    string md5, type;
+    if(myRomInfoCache->getInfo(node, md5, type))
+      myGameList->setMd5(item, md5);
+  }
 
   return myGameList->md5(item);
 }
@@ -368,13 +377,18 @@ void LauncherDialog::loadRomInfo()
   if(!node.isDirectory() && LauncherFilterDialog::isValidRomName(node, extension))
   {
     // Make sure we have a valid md5 for this ROM
-    if(myGameList->md5(item) == "")
-      myGameList->setMd5(item, MD5(node));
+    string md5, type;
+    if(myRomInfoCache->getInfo(node, md5, type))
+      myGameList->setMd5(item, md5);
 
     // Get the properties for this entry
     Properties props;
     instance().propSet().getMD5WithInsert(node, myGameList->md5(item), props);
 
+    // Show the type the ROM will actually be started with
+    if(props.get(Cartridge_Type) == "AUTO" && type != "")
+      props.set(Cartridge_Type, type);
+
     myRomInfoWidget->setProperties(props);
   }
   else
@@ -34,6 +34,7 @@ class LauncherFilterDialog;
 class OSystem;
 class Properties;
 class EditTextWidget;
+class RomInfoCache;
 class RomInfoWidget;
 class StaticTextWidget;
 class StringListWidget;
@@ -107,6 +108,7 @@ class LauncherDialog : public Dialog
     StaticTextWidget* myRomCount;
     EditTextWidget*   myPattern;
     GameList*         myGameList;
+    RomInfoCache*     myRomInfoCache;
 
     OptionsDialog* myOptions;
     RomInfoWidget* myRomInfoWidget;
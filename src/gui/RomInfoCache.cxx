@@ -0,0 +1,142 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <fstream>
+#include <sstream>
+
+#include "bspf.hxx"
+#include "Cart.hxx"
+#include "MD5.hxx"
+
+#include "RomInfoCache.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomInfoCache::RomInfoCache(const string& filename)
+  : myFilename(filename)
+{
+  load();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomInfoCache::~RomInfoCache()
+{
+  myEntries.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomInfoCache::getInfo(const FilesystemNode& rom, string& md5, string& type)
+{
+  Entry e;
+  bool haveInfo = rom.getFileInfo(e.size, e.modified);
+
+  if(haveInfo)
+  {
+    EntryList::const_iterator i = myEntries.find(rom.getPath());
+    if(i != myEntries.end() && i->second.size == e.size &&
+       i->second.modified == e.modified)
+    {
+      md5  = i->second.md5;
+      type = i->second.type;
+      return true;
+    }
+  }
+
+  // Not cached (or out of date), so we have to look at the ROM itself
+  uInt8* image = 0;
+  uInt32 size = 0;
+  try
+  {
+    size = rom.read(image);
+  }
+  catch(...)
+  {
+    return false;
+  }
+  md5  = MD5(image, size);
+  type = Cartridge::autodetectType(image, size);
+  delete[] image;
+
+  // Files whose age can't be told (if any) are never cached
+  if(haveInfo)
+  {
+    e.md5  = md5;
+    e.type = type;
+    myEntries[rom.getPath()] = e;
+
+    // Only the new entry is written, so seeing a ROM stays cheap no
+    // matter how large the cache grows
+    ofstream out(myFilename.c_str(), ios::out | ios::app);
+    if(out)
+      saveEntry(out, rom.getPath(), e);
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoCache::load()
+{
+  ifstream in(myFilename.c_str());
+  if(!in)
+    return;
+
+  // Each line holds the md5sum, type, size, modification time and path
+  // of a ROM, separated by single spaces (the path may contain more)
+  string line;
+  uInt32 lines = 0;
+  while(getline(in, line))
+  {
+    if(line.length() == 0 || line[0] == ';')
+      continue;
+
+    istringstream buf(line);
+    Entry e;
+    string path;
+    if(!(buf >> e.md5 >> e.type >> e.size >> e.modified) ||
+       buf.get() != ' ' || !getline(buf, path) || path.length() == 0)
+      continue;
+
+    myEntries[path] = e;
+    ++lines;
+  }
+  in.close();
+
+  // Entries for ROMs that have changed are appended again rather than
+  // updated in place, so compact the file once they're the majority
+  if(lines > 2 * myEntries.size() + 100)
+    save();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoCache::save() const
+{
+  ofstream out(myFilename.c_str(), ios::out);
+  if(!out)
+    return;
+
+  out << ";  Stella ROM info cache; this file is recreated as needed" << endl;
+  for(EntryList::const_iterator i = myEntries.begin(); i != myEntries.end(); ++i)
+    saveEntry(out, i->first, i->second);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoCache::saveEntry(ostream& out, const string& path, const Entry& e)
+{
+  out << e.md5 << ' ' << e.type << ' ' << e.size << ' ' << e.modified
+      << ' ' << path << endl;
+}
@@ -0,0 +1,112 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef ROM_INFO_CACHE_HXX
+#define ROM_INFO_CACHE_HXX
+
+#include <map>
+
+#include "bspf.hxx"
+#include "FSNode.hxx"
+
+/**
+  Remembers the md5sum and autodetected bankswitch type of the ROMs seen
+  in the launcher, so that each file only has to be read and hashed once
+  instead of every time it's selected in a new session.
+
+  The entries are keyed by path, and are only used while the size and
+  modification time of the file still match.  They're kept in a text
+  file, which is read when the cache is created and appended to as new
+  ROMs are seen.  Properties aren't cached, since the properties
+  database gives them cheaply (and up to date) from the md5sum.
+
+  @author  Stella Team
+  @version $Id$
+*/
+class RomInfoCache
+{
+  public:
+    /**
+      Create a cache backed by the given file, loading any entries
+      already in it.
+
+      @param filename  The file holding the cache entries
+    */
+    RomInfoCache(const string& filename);
+
+    /**
+      Destructor
+    */
+    virtual ~RomInfoCache();
+
+  public:
+    /**
+      Get the md5sum and autodetected bankswitch type of the given ROM.
+      These come from the cache if possible; otherwise the ROM is read,
+      and the results are added to the cache.
+
+      @param rom   The ROM file
+      @param md5   Receives the md5sum of the ROM
+      @param type  Receives the autodetected bankswitch type of the ROM
+      @return  false if the ROM couldn't be read, true otherwise
+    */
+    bool getInfo(const FilesystemNode& rom, string& md5, string& type);
+
+  private:
+    struct Entry {
+      uInt32 size;
+      uInt32 modified;
+      string md5;
+      string type;
+    };
+    typedef map<string, Entry> EntryList;
+
+    /**
+      Read all entries from the cache file; later lines for a path
+      replace earlier ones.  The file is rewritten if it holds many
+      more lines than entries.
+    */
+    void load();
+
+    /**
+      Write all entries to the cache file, replacing its contents.
+    */
+    void save() const;
+
+    /**
+      Write a single entry to the given stream, as one line.
+    */
+    static void saveEntry(ostream& out, const string& path, const Entry& e);
+
+  private:
+    // The file backing the cache
+    string myFilename;
+
+    // The cached entries, keyed by path
+    EntryList myEntries;
+
+  private:
+    // Copy constructor isn't supported by this class so make it private
+    RomInfoCache(const RomInfoCache&);
+
+    // Assignment operator isn't supported by this class so make it private
+    RomInfoCache& operator = (const RomInfoCache&);
+};
+
+#endif
@@ -127,6 +127,7 @@ void RomInfoWidget::parseProperties()
   myRomInfo.push_back("Name:  " + myProperties.get(Cartridge_Name));
   myRomInfo.push_back("Manufacturer:  " + myProperties.get(Cartridge_Manufacturer));
   myRomInfo.push_back("Model:  " + myProperties.get(Cartridge_ModelNo));
+  myRomInfo.push_back("Type:  " + myProperties.get(Cartridge_Type));
   myRomInfo.push_back("Rarity:  " + myProperties.get(Cartridge_Rarity));
   myRomInfo.push_back("Note:  " + myProperties.get(Cartridge_Note));
   myRomInfo.push_back("Controllers:  " + myProperties.get(Controller_Left) +
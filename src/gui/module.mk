@@ -34,6 +34,7 @@ MODULE_OBJS := \
 	src/gui/PopUpWidget.o \
 	src/gui/ProgressDialog.o \
 	src/gui/RomAuditDialog.o \
+	src/gui/RomInfoCache.o \
 	src/gui/RomInfoWidget.o \
 	src/gui/ScrollBarWidget.o \
 	src/gui/CheckListWidget.o \
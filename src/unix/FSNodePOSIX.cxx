@@ -261,6 +261,18 @@ bool FilesystemNodePOSIX::rename(const string& newfile)
     return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodePOSIX::getFileInfo(uInt32& size, uInt32& modified) const
+{
+  struct stat st;
+  if(!_isFile || stat(_path.c_str(), &st) != 0)
+    return false;
+
+  size = (uInt32) st.st_size;
+  modified = (uInt32) st.st_mtime;
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AbstractFSNode* FilesystemNodePOSIX::getParent() const
 {
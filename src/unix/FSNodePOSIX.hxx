@@ -74,6 +74,7 @@ class FilesystemNodePOSIX : public AbstractFSNode
     bool isWritable() const  { return access(_path.c_str(), W_OK) == 0; }
     bool makeDir();
     bool rename(const string& newfile);
+    bool getFileInfo(uInt32& size, uInt32& modified) const;
 
     bool getChildren(AbstractFSList& list, ListMode mode, bool hidden) const;
     AbstractFSNode* getParent() const;
@@ -32,6 +32,8 @@
 
 #include <io.h>
 #include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 #ifndef _WIN32_WCE
   #include <windows.h>
   // winnt.h defines ARRAYSIZE, but we want our own one...
@@ -304,6 +306,18 @@ bool FilesystemNodeWin32::rename(const string& newfile)
     return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodeWin32::getFileInfo(uInt32& size, uInt32& modified) const
+{
+  struct _stat st;
+  if(!_isFile || _stat(_path.c_str(), &st) != 0)
+    return false;
+
+  size = (uInt32) st.st_size;
+  modified = (uInt32) st.st_mtime;
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AbstractFSNode* FilesystemNodeWin32::getParent() const
 {
@@ -69,6 +69,7 @@ class FilesystemNodeWin32 : public AbstractFSNode
     bool isWritable() const;
     bool makeDir();
     bool rename(const string& newfile);
+    bool getFileInfo(uInt32& size, uInt32& modified) const;
 
     bool getChildren(AbstractFSList& list, ListMode mode, bool hidden) const;
     AbstractFSNode* getParent() const;